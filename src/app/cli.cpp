@@ -0,0 +1,1093 @@
+/*!
+ * @file cli.cpp
+ *
+ * @brief Interface de linha de comando do Source Lines Of Code (SLOC) para programas C/C++.
+ *
+ * @details Faz parte da `libsloc`: o executável `sloc` só chama `sloc_cli_main`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <cctype>    // `std::isdigit`
+#include <chrono>    // `std::chrono::system_clock`
+#include <iomanip>   // `std::setw`
+#include <iostream>  // `std::cout`
+#include <sstream>   // `std::ostringstream`
+
+#include <unistd.h>  // `isatty`, `STDOUT_FILENO`
+
+#include "../common/aliases.hpp"
+#include "../core/cache/result_cache.hpp"
+#include "../core/dedupe/duplicate_finder.hpp"
+#include "../core/filter/field_option.hpp"
+#include "../core/filter/filter.hpp"
+#include "../core/io/output_format.hpp"
+#include "../core/io/result_writer.hpp"
+#include "../core/options/running_options.hpp"
+#include "../core/parallel/pipeline.hpp"
+#include "../core/parallel/worker_pool.hpp"
+#include "../core/profile/run_profile.hpp"
+#include "../core/profile/trace.hpp"
+#include "../core/sloc/dir_rollup.hpp"
+#include "../core/sloc/file_info.hpp"
+#include "../core/sloc/result_store.hpp"
+#include "../core/sloc/sloc.hpp"
+#include "../core/sort/sort.hpp"
+#include "cli.hpp"
+
+// [!] Nada além de `sloc_cli_main` sai desta unidade: a biblioteca não exporta nomes como `usage` para quem a usa.
+namespace
+{
+
+const char* help_message = R"(Welcome to sloc cpp, version 1.0, (c) DIMAp/UFRN.
+
+NAME
+ sloc - single line of code counter
+
+
+SYNOPSIS
+ sloc [-h | --help] [-r] [-j N] [--worker-stats] [--stats] [--trace FILE] [--engine scalar|simd|dfa] [--stream] [--stdin-lang c|h|cpp|hpp]
+      [--split-size MiB] [--pipeline [--queue-depth N]] [--no-cache | --rebuild-cache]
+      [--dedupe [--dedupe-sum once|each]] [--git] [--stream-output [--name-width N]]
+      [--format table|csv|json|ndjson] [--by-dir [depth]] [(-s | -S) f|t|c|d|b|s|a|r[,...]] [--top N] <file | directory | ->
+
+
+EXAMPLES
+ sloc main.cpp sloc.cpp
+  Counts loc, comments, blanks of the source files 'main.cpp' and 'sloc.cpp'.
+
+ sloc source
+  Counts loc, comments, blanks of all C/C++ source files inside 'source'.
+
+ sloc -r -s c source
+  Counts loc, comments, blanks of all C/C++ source files recursively inside 'source'
+  and sort the result in ascending order by # of comment lines.
+
+ git show HEAD:src/main.cpp | sloc --stdin-lang cpp -
+  Counts loc, comments, blanks of a single C++ source read from the standard input.
+
+
+DESCRIPTION
+ Sloc counts the individual number **lines of code** (LOC), comments, and blank
+lines found in a list of files or directories passed as the last argument
+(after options).
+ After the counting process is concluded the program prints out to the standard
+output a table summarizing the information gathered, by each source file and/or
+directory provided.
+ It is possible to inform which fields sloc should use to sort the data by, as
+well as if the data should be presented in ascending/descending numeric order.
+
+
+OPTIONS
+-h | --help                         Display this information.
+
+-r                                  Look for files recursively in the directory provided.
+                                    Symbolic links to directories are followed; symlink cycles
+                                    are detected. A file reached through several paths (overlapping
+                                    inputs, symlinks, hardlinks) is counted once.
+
+-j N                                Analyze files using N worker threads.
+                                    Default is the number of cores detected.
+                                    Larger files are scheduled first and idle workers
+                                    steal queued files from busy ones.
+
+--worker-stats                      Print to the standard error the time each worker
+                                    spent busy and idle.
+
+--stats                             Print to the standard error a profile of the run: wall and
+                                    CPU time (all threads) and heap allocations of each phase
+                                    (discovery, scan, sort, output...), files and bytes scanned,
+                                    scan throughput and peak resident memory. Measured only at
+                                    phase boundaries, so it costs nothing per file.
+
+--trace FILE                        Record what every thread does (discovery, open and scan of
+                                    each file, waits on the pipeline queues, phases of the run)
+                                    and write it to FILE in Chrome trace-event format (open it in
+                                    Perfetto or chrome://tracing). Files smaller than 64 KiB that
+                                    a thread scans back to back are merged into one "small files"
+                                    event, so the trace stays small on big trees.
+
+--engine scalar|simd|dfa            Line scanner used to count lines. (scalar) checks every
+                                    character; (simd) uses SSE2/AVX2/AVX-512, chosen at runtime,
+                                    to skip the bytes that cannot change the scanner state;
+                                    (dfa) runs a table-driven automaton, one table load per byte.
+                                    All produce the same counts. Default is dfa.
+
+--stream                            Read files in fixed-size chunks (256 KiB) through a single
+                                    reusable buffer instead of mapping them in memory. Useful
+                                    on pipes and FUSE mounts. Memory per worker stays bounded
+                                    regardless of file or line length. Always uses the dfa engine.
+
+--stdin-lang c|h|cpp|hpp            Language of the source read from the standard input ('-').
+                                    Default is cpp.
+
+--split-size MiB                    Files of at least MiB mebibytes are split at line boundaries
+                                    into 8 MiB chunks scanned in parallel by all workers, each
+                                    chunk speculatively for every state a line can start in, and
+                                    stitched back in order. Counts are identical to a sequential
+                                    scan. Split chunks always use the dfa engine. 0 disables it.
+                                    Ignored with --stream. Default is 64.
+
+--pipeline                          Overlap discovery, reading/scanning and reporting: files are
+                                    scanned while directories are still being traversed, which
+                                    lowers the time to the first result and the wall time on cold
+                                    caches. Files are scanned in discovery order (no largest-first
+                                    scheduling and no --split-size).
+
+--queue-depth N                     Capacity, in files, of each queue between pipeline stages.
+                                    Discovery waits when the scanners fall N files behind.
+                                    Default is 1024.
+
+--no-cache                          Do not read nor write the result cache. By default the counts of
+                                    every file are stored under $XDG_CACHE_HOME/sloc (or ~/.cache/sloc),
+                                    one cache per set of inputs, keyed by path and validated by size,
+                                    modification time (ns) and inode; unchanged files are not scanned
+                                    again on the next run. When a previous cache was found, the cache
+                                    hit ratio follows the table.
+
+--rebuild-cache                     Ignore the existing cache, scan every file and write a new cache.
+
+--dedupe                            Detect byte-identical files: files whose size repeats are hashed
+                                    (128-bit MurmurHash3), each distinct content is scanned once and
+                                    its counts are reused for every copy. A report listing the
+                                    duplicate groups and the lines they account for is printed after
+                                    the table. Not available with --pipeline.
+
+--dedupe-sum once|each              Whether the copies of a duplicate group count (once) or (each)
+                                    in the SUM row. Implies --dedupe. Default is each.
+
+--stream-output                     Print each row as soon as its file is scanned (in completion
+                                    order) and keep only the running totals: memory stays flat
+                                    whatever the number of files. Columns have a fixed width and
+                                    longer paths are elided from the left ("...dir/file.cpp"). The
+                                    file count and cache hits follow the table. Implies --pipeline;
+                                    cannot be combined with sorting or --dedupe, and the result
+                                    cache is read but not updated.
+
+--name-width N                      Width of the filename column with --stream-output (at least
+                                    10). Default is 60.
+
+--format table|csv|json|ndjson      Output format of the results. (table) is the aligned table;
+                                    (csv) has a header line and one line per file with absolute
+                                    counts (no SUM line); (json) is a single document
+                                    {"files": [...], "sum": {...}, "files_processed": N}; (ndjson)
+                                    has one JSON object per file and a last {"sum": ...} line.
+                                    With csv/json/ndjson the standard output carries only the
+                                    results: notes and reports go to the standard error.
+                                    Default is table.
+
+--by-dir [depth]                    Print, instead of the table of files, one row per directory
+                                    with the files and lines of its whole subtree, as an indented
+                                    tree (subdirectories in name order). Only directories up to
+                                    depth levels below the top are shown (0: just the top); the
+                                    default is every level. Cannot be combined with sorting, --top
+                                    or --stream-output.
+
+--git                               List the files of directories inside a git work tree from the
+                                    git index (.git/index, read directly) instead of traversing
+                                    them: only tracked files are counted, build outputs and
+                                    untracked files are never visited. A note per directory tells
+                                    how many files changed since they were last indexed.
+                                    Directories outside a git work tree are traversed as usual.
+
+-s f|t|c|d|b|s|a|r[,...]            Sort table in ASCENDING order by (f)ilename, (t) filetype,
+                                    (c)omments, (d)oc comments, (b)lank lines, (s)loc, (a)ll, or
+                                    comment (r)atio ((comments + doc comments) / lines). Several
+                                    keys may be given, e.g. 's,c': later keys break ties of earlier
+                                    ones; files still tied keep their order of appearance.
+                                    Default is to show files in ordem of appearance.
+
+-S f|t|c|d|b|s|a|r[,...]            Same as -s, in DESCENDING order.
+
+--top N                             Show only the first N rows of the sorted table, selected
+                                    without sorting the rest. SUM still covers every file.
+                                    Without -s/-S, shows the N biggest files (-S a).
+)";
+
+void reset_stream(std::ostringstream& ss)
+{
+  ss.str("");
+  ss.clear();
+}
+
+void usage(str_view msg = "")
+{
+  if (not msg.empty())
+    std::cout << "\033[31mError: " << msg << ".\033[0m\n\n";
+  std::cout << help_message;
+  exit(EXIT_SUCCESS);
+}
+
+str get_option_name(FieldOption field)
+{
+  static const umap<FieldOption, str> fields_names{ { FieldOption::NONE, "NONE" },
+                                                    { FieldOption::FILENAME, "FILENAME" },
+                                                    { FieldOption::FILETYPE, "FILETYPE" },
+                                                    { FieldOption::COMMENTS, "COMMENTS" },
+                                                    { FieldOption::DOC_COMENTS, "DOC_COMENTS" },
+                                                    { FieldOption::BLANK_LINES, "BLANK_LINES" },
+                                                    { FieldOption::SLOC, "SLOC" },
+                                                    { FieldOption::ALL, "ALL" },
+                                                    { FieldOption::COMMENT_DENSITY, "COMMENT_DENSITY" } };
+
+  return fields_names.at(field);
+}
+
+str elide_filename(const str& filename, const std::size_t& width)
+{
+  if (filename.size() <= width)
+  {
+    return filename;
+  }
+
+  // [!] Mantém o fim do caminho (o nome do arquivo), sem começar no meio de um caractere UTF-8.
+  size_t start{ filename.size() - (width - 3) };
+  while (start < filename.size() and (static_cast<byte>(filename[start]) & 0xC0) == 0x80)
+  {
+    ++start;
+  }
+  return "..." + filename.substr(start);
+}
+
+void print_cache_hits(const ResultCache* cache, oss& table)
+{
+  if (cache != nullptr and cache->loaded())  // [!] Sem cache anterior, não houve acertos a reportar.
+  {
+    const size_t lookups{ cache->n_lookups() };
+    const double ratio{ lookups == 0 ? 0.0 : static_cast<double>(cache->n_hits()) * 100.0 / static_cast<double>(lookups) };
+    table << " Cache hits: " << cache->n_hits() << " of " << lookups << " (" << std::fixed << std::setprecision(1) << ratio << "%)\n";
+  }
+}
+
+void print_results(const RunningOptions& run_options, const ResultStore& results, const vec<std::uint32_t>& order,
+                   const ResultStore::Counts& sum_file, const ResultCache* cache)
+{
+  // [!] Calcula o comprimento máximo de nome de arquivo (começa com tamanho do cabeçalho).
+  std::size_t max_filename_len{ str("Filename").size() + 2 };  // [!] +2 para margem.
+
+  // [!] 1. Pré-processamento: Calcula tamanhos (os totais já foram reduzidos pelos workers).
+  for (const std::uint32_t row : order)
+  {
+    max_filename_len = std::max(max_filename_len, results.path_length(row));  // [!] Atualiza tamanho máximo.
+  }
+
+  // [!] 2. Cabeçalho geral (só na tabela: os outros formatos são lidos por programas).
+  if (run_options.format == OutputFormat::TABLE)
+  {
+    std::ostringstream table{};
+    table << " Files processed: " << results.size() << "\n";
+
+    // [!] Se o cache foi usado, mostra quantos arquivos não precisaram ser analisados.
+    print_cache_hits(cache, table);
+
+    // [!] Se houver ordenação aplicada, mostra critério.
+    if (not run_options.sort_fields.empty())
+    {
+      table << " Sorting: " << (run_options.ascending ? "ASC" : "DESC") << " by ";
+      for (size_t k{ 0 }; k < run_options.sort_fields.size(); ++k)
+      {
+        table << (k > 0 ? ", " : "") << get_option_name(run_options.sort_fields[k]);
+      }
+      table << '\n';
+    }
+
+    // [!] Com `--top`, a tabela mostra só parte dos arquivos (o `SUM` continua somando todos).
+    if (order.size() < results.size())
+    {
+      table << " Showing: top " << order.size() << " of " << results.size() << " files\n";
+    }
+    std::cout << table.str();
+  }
+
+  // [!] 3. Cabeçalho, uma linha por arquivo e totais, montados direto no buffer de saída.
+  ResultWriter writer{ run_options.format, max_filename_len };
+  writer.begin();
+  for (const std::uint32_t row : order)
+  {
+    writer.row(results.path(row), results.type(row), results.counts(row));
+  }
+  writer.end(sum_file, results.size());
+}
+
+void print_directories(const RunningOptions& run_options, const ResultStore& results, const vec<bool>* excluded,
+                       const ResultStore::Counts& sum_file, const ResultCache* cache)
+{
+  // [!] Árvore de diretórios com os totais de cada subárvore, somados de baixo para cima.
+  const DirRollup rollup{ results, excluded, run_options.n_workers };
+
+  // [!] Os diretórios do topo mostram o caminho completo; os demais, só o próprio nome, recuado 2 espaços por nível.
+  auto label_of{ [](const DirRollup::Node& node, size_t depth) {
+    return depth == 0 ? node.path : node.path.substr(node.path.rfind('/') + 1);
+  } };
+
+  std::size_t max_label_len{ str("Directory").size() + 2 };
+  rollup.walk(run_options.by_dir_depth, [&](const DirRollup::Node& node, size_t depth) {
+    max_label_len = std::max(max_label_len, 2 * depth + label_of(node, depth).size());
+  });
+
+  if (run_options.format == OutputFormat::TABLE)
+  {
+    std::ostringstream table{};
+    table << " Files processed: " << results.size() << "\n";
+    print_cache_hits(cache, table);
+    std::cout << table.str();
+  }
+
+  ResultWriter writer{ run_options.format, max_label_len };
+  writer.begin_directories();
+  rollup.walk(run_options.by_dir_depth, [&](const DirRollup::Node& node, size_t depth) {
+    writer.directory(label_of(node, depth), node.path, depth, node.n_files, node.counts);
+  });
+  writer.end(sum_file, results.size());
+}
+
+void stream_results(const RunningOptions& run_options, const ResultCache* cache, vec<WorkerStats>& worker_stats)
+{
+  // [!] Largura fixa: o cabeçalho sai antes de qualquer arquivo ser conhecido, e nomes longos são abreviados.
+  const std::size_t max_filename_len{ std::max(run_options.name_width, str("Filename").size() + 2) };
+  const bool table{ run_options.format == OutputFormat::TABLE };
+  const bool interactive{ isatty(STDOUT_FILENO) == 1 };  //!< Num terminal, cada linha sai assim que fica pronta.
+  size_t n_files{ 0 };                                    //!< Arquivos impressos até agora (só os totais são mantidos).
+
+  ResultWriter writer{ run_options.format, max_filename_len };
+  writer.begin();
+
+  // [!] Cada linha é escrita assim que o arquivo termina de ser analisado, na ordem de término.
+  ResultStore no_results{};
+  FileInfo sum_file{ Pipeline::run(run_options, no_results, cache, &worker_stats, nullptr, [&](const FileInfo& file) {
+    writer.row(table ? elide_filename(file.m_filename, max_filename_len) : file.m_filename, file.m_type,
+               ResultStore::counts_of(file));
+    if (interactive)
+    {
+      writer.flush();
+    }
+    ++n_files;
+  }) };
+
+  writer.end(ResultStore::counts_of(sum_file), n_files);
+
+  // [!] O número de arquivos só é conhecido no fim, então vai depois da tabela.
+  if (table)
+  {
+    std::ostringstream footer{};
+    footer << " Files processed: " << n_files << "\n";
+    print_cache_hits(cache, footer);
+    std::cout << footer.str();
+  }
+}
+
+void print_duplicates(const ResultStore& results, vec<DuplicateFinder::Group> groups, bool counted_once)
+{
+  auto lines_of{ [&results](size_t row) { return results.count(row, ResultStore::Counter::LINES); } };
+
+  // [!] Grupos que mais pesam primeiro: linhas de uma cópia vezes o número de cópias.
+  auto group_lines{ [&](const DuplicateFinder::Group& group) { return lines_of(group.files.front()) * group.files.size(); } };
+  std::stable_sort(groups.begin(), groups.end(), [&](const auto& a, const auto& b) { return group_lines(a) > group_lines(b); });
+
+  size_t n_copies{ 0 };  //!< Cópias redundantes (todas menos o representante de cada grupo).
+  size_t n_lines{ 0 };   //!< Linhas dessas cópias.
+  for (const auto& group : groups)
+  {
+    n_copies += group.files.size() - 1;
+    n_lines += lines_of(group.files.front()) * (group.files.size() - 1);
+  }
+
+  oss report{};
+  report << "\n Duplicate groups: " << groups.size() << " (" << n_copies << " redundant copies, " << n_lines
+         << " redundant lines, counted " << (counted_once ? "once" : "per copy") << " in SUM)\n";
+  for (size_t g{ 0 }; g < groups.size(); ++g)
+  {
+    const auto& group{ groups[g] };
+    const std::uint64_t lines{ lines_of(group.files.front()) };
+    report << "  #" << (g + 1) << "  " << group.files.size() << " copies x " << lines << " lines = " << group_lines(group)
+           << " lines  [" << group.hash.to_hex() << "]\n";
+    for (const size_t f : group.files)
+    {
+      report << "      " << results.path(f) << '\n';
+    }
+  }
+  std::cout << report.str();
+}
+
+void print_worker_stats(const vec<WorkerStats>& stats)
+{
+  double total_busy{ 0.0 };  //!< Soma do tempo ocupado de todos os workers.
+  double wall{ 0.0 };        //!< Tempo de parede da análise (ocupado + ocioso de qualquer worker).
+
+  std::cerr << " Worker      Files    Stolen    MiB        Busy (s)    Idle (s)\n";
+  for (size_t w{ 0 }; w < stats.size(); ++w)
+  {
+    const auto& worker{ stats[w] };
+    total_busy += worker.busy_seconds;
+    wall = std::max(wall, worker.busy_seconds + worker.idle_seconds);
+
+    std::cerr << ' ' << std::left << std::setw(12) << w;
+    std::cerr << std::setw(9) << worker.n_files;
+    std::cerr << std::setw(10) << worker.n_stolen;
+    std::cerr << std::setw(11) << std::fixed << std::setprecision(1) << (static_cast<double>(worker.n_bytes) / (1024.0 * 1024.0));
+    std::cerr << std::setw(12) << std::setprecision(3) << worker.busy_seconds;
+    std::cerr << worker.idle_seconds << '\n';
+  }
+
+  // [!] Com escalonamento ideal, o tempo de parede se aproxima do trabalho total dividido pelo número de workers.
+  const double ideal{ stats.empty() ? 0.0 : total_busy / static_cast<double>(stats.size()) };
+  std::cerr << " Wall: " << wall << " s, ideal (busy / workers): " << ideal << " s\n\n";
+}
+
+void print_pipeline_stats(const PipelineStats& stats)
+{
+  std::cerr << std::fixed << std::setprecision(3);
+  std::cerr << " Pipeline: first result " << stats.first_result_seconds << " s, discovery done " << stats.discovery_seconds
+            << " s, last result " << stats.wall_seconds << " s\n";
+  std::cerr << " Discovery waited on a full queue " << stats.n_discovery_waits << " times\n\n";
+}
+
+void handle_sort_option(int argc, char* argv[], int& index, RunningOptions& run_options, const umap<char, FieldOption>& sort_map, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag de ordenação (-s ou -S).
+  if (index + 1 >= argc)
+  {
+    // [!] Constrói mensagem de erro caso falte o argumento.
+    error_msg << "Missing value for " << argv[index] << " option";
+    // [!] Chama a função de ajuda com a mensagem de erro.
+    usage(error_msg.str());
+  }
+
+  // [!] Determina se a ordenação é ascendente (-s) ou descendente (-S).
+  run_options.ascending = (str(argv[index]) == "-s");
+  // [!] Avança para o próximo argumento e obtém a string de campos de ordenação.
+  const str sort_fields{ argv[++index] };
+
+  // [!] Cada caractere é uma chave, da principal para a última (as vírgulas são opcionais: `s,c` ou `sc`).
+  run_options.sort_fields.clear();
+  for (const char field : sort_fields)
+  {
+    if (field == ',')
+    {
+      continue;
+    }
+
+    // [!] Verifica se o caractere está no mapa de campos válidos.
+    auto it{ sort_map.find(field) };
+    if (it == sort_map.end())
+    {
+      error_msg << "Invalid sort field: " << field;
+      usage(error_msg.str());
+    }
+
+    // [!] Uma chave repetida não desempata nada.
+    if (std::find(run_options.sort_fields.begin(), run_options.sort_fields.end(), it->second) == run_options.sort_fields.end())
+    {
+      run_options.sort_fields.push_back(it->second);
+    }
+  }
+
+  if (run_options.sort_fields.empty())
+  {
+    // [!] Constrói mensagem de erro para campo inválido.
+    error_msg << "No valid sort field has been entered";
+    // [!] Chama a função de ajuda com a mensagem de erro.
+    usage(error_msg.str());
+  }
+}
+
+void handle_top_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--top`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  const str value{ argv[++index] };  //!< Quantidade de linhas exibidas.
+
+  // [!] Aceita apenas inteiros positivos (com no máximo 9 dígitos, evitando estouro em `std::stoul`).
+  if (value.empty() or value.size() > 9 or value.find_first_not_of("0123456789") != str::npos or std::stoul(value) == 0)
+  {
+    error_msg << "Invalid number of rows: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.top = std::stoul(value);
+}
+
+void handle_workers_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `-j`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  const str value{ argv[++index] };  //!< Número de workers informado pelo usuário.
+
+  // [!] Aceita apenas inteiros positivos (com no máximo 6 dígitos, evitando estouro em `std::stoul`).
+  if (value.empty() or value.size() > 6 or value.find_first_not_of("0123456789") != str::npos or std::stoul(value) == 0)
+  {
+    error_msg << "Invalid number of workers: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.n_workers = std::stoul(value);
+}
+
+void handle_stdin_lang_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--stdin-lang`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  static const umap<str, LangType> languages{ { "c", LangType::C },
+                                              { "h", LangType::H },
+                                              { "cpp", LangType::CPP },
+                                              { "hpp", LangType::HPP } };
+
+  const str value{ argv[++index] };
+  auto it{ languages.find(value) };
+  if (it == languages.end())
+  {
+    error_msg << "Unknown language: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.stdin_lang = it->second;
+}
+
+void handle_split_size_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--split-size`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  const str value{ argv[++index] };  //!< Tamanho mínimo, em MiB, informado pelo usuário.
+
+  // [!] Aceita apenas inteiros não negativos (com no máximo 6 dígitos, evitando estouro em `std::stoul`).
+  if (value.empty() or value.size() > 6 or value.find_first_not_of("0123456789") != str::npos)
+  {
+    error_msg << "Invalid split size: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.split_size = std::stoul(value) * 1024 * 1024;
+}
+
+void handle_queue_depth_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--queue-depth`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  const str value{ argv[++index] };  //!< Capacidade das filas informada pelo usuário.
+
+  // [!] Aceita apenas inteiros positivos (com no máximo 6 dígitos, evitando estouro em `std::stoul`).
+  if (value.empty() or value.size() > 6 or value.find_first_not_of("0123456789") != str::npos or std::stoul(value) == 0)
+  {
+    error_msg << "Invalid queue depth: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.queue_depth = std::stoul(value);
+}
+
+void handle_trace_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--trace`.
+  if (index + 1 >= argc or str_view{ argv[index + 1] }.empty())
+  {
+    error_msg << "Missing file name for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  run_options.trace_file = argv[++index];
+}
+
+void handle_name_width_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--name-width`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  const str value{ argv[++index] };  //!< Largura da coluna de nomes informada pelo usuário.
+
+  // [!] Aceita inteiros de 10 a 999999 (abaixo disso não sobra nada do nome depois do "...").
+  if (value.empty() or value.size() > 6 or value.find_first_not_of("0123456789") != str::npos or std::stoul(value) < 10)
+  {
+    error_msg << "Invalid name width: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.name_width = std::stoul(value);
+}
+
+void handle_dedupe_sum_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--dedupe-sum`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  const str value{ argv[++index] };
+  if (value != "once" and value != "each")
+  {
+    error_msg << "Invalid duplicate counting mode: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.dedupe = true;
+  run_options.duplicates_once = (value == "once");
+}
+
+void handle_engine_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--engine`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  static const umap<str, ScanEngine> engines{ { "scalar", ScanEngine::SCALAR },
+                                                { "simd", ScanEngine::SIMD },
+                                                { "dfa", ScanEngine::DFA } };
+
+  const str value{ argv[++index] };
+  auto it{ engines.find(value) };
+  if (it == engines.end())
+  {
+    error_msg << "Unknown engine: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.engine = it->second;
+}
+
+void handle_format_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  // [!] Checa se existe um argumento após a flag `--format`.
+  if (index + 1 >= argc)
+  {
+    error_msg << "Missing value for " << argv[index] << " option";
+    usage(error_msg.str());
+  }
+
+  static const umap<str, OutputFormat> formats{ { "table", OutputFormat::TABLE },
+                                                { "csv", OutputFormat::CSV },
+                                                { "json", OutputFormat::JSON },
+                                                { "ndjson", OutputFormat::NDJSON } };
+
+  const str value{ argv[++index] };
+  auto it{ formats.find(value) };
+  if (it == formats.end())
+  {
+    error_msg << "Unknown output format: " << value;
+    usage(error_msg.str());
+  }
+
+  run_options.format = it->second;
+}
+
+void handle_by_dir_option(int argc, char* argv[], int& index, RunningOptions& run_options, oss& error_msg)
+{
+  run_options.by_dir = true;
+
+  // [!] A profundidade é opcional: só é lida se o próximo argumento for um número.
+  if (index + 1 < argc and std::isdigit(static_cast<unsigned char>(argv[index + 1][0])))
+  {
+    const str value{ argv[++index] };  //!< Profundidade máxima informada pelo usuário.
+
+    // [!] Aceita apenas inteiros não negativos (com no máximo 6 dígitos, evitando estouro em `std::stoul`).
+    if (value.size() > 6 or value.find_first_not_of("0123456789") != str::npos)
+    {
+      error_msg << "Invalid directory depth: " << value;
+      usage(error_msg.str());
+    }
+
+    run_options.by_dir_depth = std::stoul(value);
+  }
+}
+
+void analyze_sources(RunningOptions& run_options, const vec<DuplicateFinder::Group>& duplicates, const ResultCache* cache,
+                     vec<WorkerStats>& worker_stats)
+{
+  if (duplicates.empty())
+  {
+    WorkerPool::analyze(run_options.sources, run_options.n_workers, run_options.engine, run_options.input_mode,
+                        run_options.split_size, cache, &worker_stats);
+    return;
+  }
+
+  // [!] Só os representantes de cada conteúdo vão para os workers; as cópias recebem as contagens depois.
+  const vec<bool> is_copy{ DuplicateFinder::copies(duplicates, run_options.sources.size()) };
+  vec<FileInfo> unique{};
+  vec<size_t> unique_index{};
+  for (size_t f{ 0 }; f < run_options.sources.size(); ++f)
+  {
+    if (not is_copy[f])
+    {
+      unique_index.push_back(f);
+      unique.push_back(std::move(run_options.sources[f]));
+    }
+  }
+
+  WorkerPool::analyze(unique, run_options.n_workers, run_options.engine, run_options.input_mode, run_options.split_size,
+                      cache, &worker_stats);
+
+  for (size_t u{ 0 }; u < unique.size(); ++u)
+  {
+    run_options.sources[unique_index[u]] = std::move(unique[u]);
+  }
+  DuplicateFinder::propagate(duplicates, run_options.sources);
+}
+
+RunningOptions parse_arguments(int argc, char* argv[])
+{
+  if (argc <= 1)  // [!] Chamada de programa sem argumentos.
+    usage();
+
+  RunningOptions run_options{};  //!< Encapsula as opções passadas por linha de comando.
+  run_options.n_workers = WorkerPool::default_workers();
+  vec<str>& input_sources{ run_options.inputs };  //!< Armazena arquivos e diretórios que o usuário quer processar.
+  oss error_msg{};                                //!< Monta mensagens de erro.
+
+  //!< Mapa para ajudar a converter rapidamente a entrada do usuário para os enums que controlam como os resultados serão ordenados.
+  umap<char, FieldOption> sort_map{ { 'f', FieldOption::FILENAME },    { 't', FieldOption::FILETYPE },    { 'c', FieldOption::COMMENTS },
+                                    { 'd', FieldOption::DOC_COMENTS }, { 'b', FieldOption::BLANK_LINES }, { 's', FieldOption::SLOC },
+                                    { 'a', FieldOption::ALL },         { 'r', FieldOption::COMMENT_DENSITY } };
+
+  for (int i{ 1 }; i < argc; ++i)  // [!] O argumento 'argv[0]' é o nome do programa.
+  {
+    str arg{ argv[i] };  // [!] Recupera o argumento atual.
+
+    if (arg == "-h" or arg == "--help")  // [!] Checa se opção de ajuda foi passada.
+    {
+      usage();  // [!] Mostra somente mensagem de ajuda.
+    }
+    else if (arg == "-r")  // [!] Checa se a opção de análise recursiva foi passada.
+    {
+      run_options.recursive = true;  // [!] Habilita a análise recursiva.
+    }
+    else if (arg == "-j")  // [!] Checa se a opção de número de workers foi passada.
+    {
+      handle_workers_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--engine")  // [!] Checa se o motor de análise foi escolhido.
+    {
+      handle_engine_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--worker-stats")  // [!] Checa se o relatório dos workers foi pedido.
+    {
+      run_options.worker_stats = true;
+    }
+    else if (arg == "--stats")  // [!] Checa se o perfil da execução foi pedido.
+    {
+      run_options.stats = true;
+    }
+    else if (arg == "--trace")  // [!] Checa se o trace de eventos foi pedido.
+    {
+      handle_trace_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--split-size")  // [!] Checa se o limite de divisão de arquivos foi informado.
+    {
+      handle_split_size_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--pipeline")  // [!] Checa se a descoberta e a análise devem ser sobrepostas.
+    {
+      run_options.pipeline = true;
+    }
+    else if (arg == "--queue-depth")  // [!] Checa se a capacidade das filas do pipeline foi informada.
+    {
+      handle_queue_depth_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--stream-output")  // [!] Checa se cada linha deve ser impressa assim que o arquivo termina.
+    {
+      run_options.stream_output = true;
+      run_options.pipeline = true;
+    }
+    else if (arg == "--name-width")  // [!] Checa se a largura da coluna de nomes foi informada.
+    {
+      handle_name_width_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--by-dir")  // [!] Checa se os totais por diretório foram pedidos.
+    {
+      handle_by_dir_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--format")  // [!] Checa se o formato da saída foi escolhido.
+    {
+      handle_format_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--git")  // [!] Checa se os arquivos devem vir do índice do git.
+    {
+      run_options.git = true;
+    }
+    else if (arg == "--no-cache")  // [!] Checa se o cache de resultados foi desligado.
+    {
+      run_options.cache_mode = CacheMode::OFF;
+    }
+    else if (arg == "--rebuild-cache")  // [!] Checa se o cache de resultados deve ser refeito.
+    {
+      run_options.cache_mode = CacheMode::REBUILD;
+    }
+    else if (arg == "--dedupe")  // [!] Checa se a detecção de arquivos idênticos foi pedida.
+    {
+      run_options.dedupe = true;
+    }
+    else if (arg == "--dedupe-sum")  // [!] Checa como as cópias idênticas entram no `SUM`.
+    {
+      handle_dedupe_sum_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "--stream")  // [!] Checa se a leitura em blocos foi pedida.
+    {
+      run_options.input_mode = InputMode::STREAM;
+    }
+    else if (arg == "--stdin-lang")  // [!] Checa se a linguagem da entrada padrão foi informada.
+    {
+      handle_stdin_lang_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == "-s" or arg == "-S")  // [!] Checa se opção de ordenação foi passada.
+    {
+      // [!] Lida com opções de ordenação.
+      handle_sort_option(argc, argv, i, run_options, sort_map, error_msg);
+    }
+    else if (arg == "--top")  // [!] Checa se só as primeiras linhas devem ser exibidas.
+    {
+      handle_top_option(argc, argv, i, run_options, error_msg);
+    }
+    else if (arg == STDIN_SOURCE)  // [!] `-` não é opção: representa a entrada padrão.
+    {
+      input_sources.push_back(arg);
+    }
+    else if (not arg.empty() and arg.at(0) == '-')  // [!] Checa se argumento é uma opção inválida.
+    {
+      error_msg << "Unknown option: " << arg;  // [!] Contrói mensagem de opção desconhecida.
+      usage(error_msg.str());
+    }
+    else
+    {
+      // [!] Se o argumento não for alguma opção válida, campos de ordenação ou opção inválida, ele será um arquivo ou diretório.
+      input_sources.push_back(arg);
+    }
+
+    reset_stream(error_msg);  // [!] Reinicializa stream.
+  }
+
+  // [!] Checa se não foram passados algum arquivo ou diretório.
+  if (input_sources.empty())
+  {
+    usage("No input files or directories provided");
+  }
+
+  // [!] A detecção de cópias precisa de todos os tamanhos antes da análise, o que o pipeline não tem.
+  if (run_options.dedupe and run_options.pipeline)
+  {
+    usage("--dedupe cannot be combined with --pipeline");
+  }
+
+  // [!] Na saída contínua nenhuma lista de arquivos é guardada: não há o que ordenar nem onde procurar cópias.
+  if (run_options.stream_output and (not run_options.sort_fields.empty() or run_options.top > 0))
+  {
+    usage("--stream-output cannot be combined with sorting or --top");
+  }
+
+  // [!] Os totais por diretório precisam de todos os resultados, e a árvore tem a sua própria ordem (por nome).
+  if (run_options.by_dir and (run_options.stream_output or not run_options.sort_fields.empty() or run_options.top > 0))
+  {
+    usage("--by-dir cannot be combined with --stream-output, sorting or --top");
+  }
+
+  // [!] Sem chave explícita, `--top N` mostra os N maiores arquivos (em número de linhas).
+  if (run_options.top > 0 and run_options.sort_fields.empty())
+  {
+    run_options.sort_fields.push_back(FieldOption::ALL);
+  }
+
+  return run_options;
+}
+
+}  // namespace
+
+int sloc_cli_main(int argc, char* argv[])
+{
+  // #1 Analisar argumentos da linha de comando
+  RunningOptions run_options{ parse_arguments(argc, argv) };
+
+  // [!] Nos formatos para programas, a saída padrão só recebe os resultados: o resto (avisos, relatórios) vai para a
+  // saída de erro.
+  if (run_options.format != OutputFormat::TABLE)
+  {
+    std::cout.rdbuf(std::cerr.rdbuf());
+  }
+  std::cout << " Welcome to sloc cpp, version 1.0, (c) DIMAp/UFRN.\n\n";
+
+  if (not run_options.trace_file.empty())
+  {
+    Trace::start();
+  }
+  RunProfile profile{ run_options.stats or Trace::enabled() };  //!< Tempo, CPU e alocações de cada fase.
+
+  vec<WorkerStats> worker_stats{};           //!< Tempo ocupado/ocioso de cada worker.
+  ResultStore results{};                     //!< Resultados, um arquivo por linha, na ordem de descoberta.
+  vec<DuplicateFinder::Group> duplicates{};  //!< Grupos de arquivos idênticos (com `--dedupe`).
+
+  // [!] Arquivos modificados a partir deste instante não entram no cache (podem mudar sem mudar o mtime).
+  const std::int64_t started_ns{ std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count() };
+  ResultCache result_cache{};
+  const str cache_path{ run_options.cache_mode == CacheMode::OFF ? str{} : ResultCache::default_path(run_options.inputs) };
+  const ResultCache* cache{ cache_path.empty() ? nullptr : &result_cache };
+  if (cache != nullptr and run_options.cache_mode == CacheMode::USE)
+  {
+    profile.phase("cache load");
+    result_cache.load(cache_path);
+  }
+
+  if (run_options.stream_output)
+  {
+    // #2 Descobrir, analisar e imprimir os arquivos ao mesmo tempo, guardando só os totais.
+    profile.phase("stream output", true);
+    stream_results(run_options, cache, worker_stats);
+
+    if (run_options.worker_stats)
+    {
+      print_worker_stats(worker_stats);
+    }
+  }
+  else if (run_options.pipeline)
+  {
+    // #2 Descobrir e analisar os arquivos ao mesmo tempo.
+    PipelineStats pipeline_stats{};
+    profile.phase("pipeline", true);
+    Pipeline::run(run_options, results, cache, &worker_stats, &pipeline_stats);
+
+    if (run_options.worker_stats)
+    {
+      print_worker_stats(worker_stats);
+      print_pipeline_stats(pipeline_stats);
+    }
+  }
+  else
+  {
+    // #2 Coletar todos os arquivos válidos a partir dos caminhos fornecidos.
+    profile.phase("discovery");
+    run_options.sources = Filter::filter(run_options.inputs, run_options.recursive, run_options.stdin_lang, run_options.n_workers,
+                                         run_options.git);
+
+    // #3 Agrupar arquivos idênticos, se pedido.
+    if (run_options.dedupe)
+    {
+      profile.phase("dedupe");
+      duplicates = DuplicateFinder::find(run_options.sources, run_options.n_workers);
+    }
+
+    // #4 Analisar cada arquivo (em paralelo).
+    if (not run_options.sources.empty())
+    {
+      profile.phase("scan", true);
+      analyze_sources(run_options, duplicates, cache, worker_stats);
+
+      if (run_options.worker_stats)
+      {
+        print_worker_stats(worker_stats);
+      }
+    }
+
+    // [!] Passa os resultados para as colunas compactas, liberando a lista de `FileInfo`.
+    profile.phase("collect");
+    results.append(run_options.sources);
+  }
+
+  // [!] Grava o cache atualizado (de forma atômica); uma falha não impede a impressão dos resultados.
+  if (cache != nullptr and not results.empty())
+  {
+    profile.phase("cache store");
+  }
+  if (cache != nullptr and not results.empty() and not cache->store(cache_path, results, started_ns))
+  {
+    std::cerr << " Warning: could not write the result cache '" << cache_path << "'.\n";
+  }
+
+  /* [!]
+   * Verifica se pelo menos um input do usuário foi considerado como arquivo válido.
+   * Evita chamadas desnecessárias aos métodos principais do programa.
+   * Nos formatos para programas, mesmo sem arquivos válidos a saída é um documento (vazio) bem formado.
+   */
+  if (not results.empty() or run_options.format != OutputFormat::TABLE)  // [!] Verifica se algum arquivo foi validado. Evita chamadas des
+  {
+    // #5 Somar os totais gerais, coluna por coluna (com `--dedupe-sum once`, as cópias ficam de fora).
+    profile.phase("sum");
+    const vec<bool> is_copy{ run_options.duplicates_once ? DuplicateFinder::copies(duplicates, results.size()) : vec<bool>{} };
+    const ResultStore::Counts sum_file{ results.total(run_options.duplicates_once ? &is_copy : nullptr) };
+
+    if (run_options.by_dir)
+    {
+      // #6 Somar e imprimir os totais de cada diretório, no lugar da tabela de arquivos.
+      profile.phase("by-dir output");
+      print_directories(run_options, results, run_options.duplicates_once ? &is_copy : nullptr, sum_file, cache);
+    }
+    else
+    {
+      // #6 Ordenar os arquivos se necessário (só os índices das linhas são ordenados).
+      profile.phase("sort");
+      const vec<std::uint32_t> order{ Sort::order(results, run_options.sort_fields, run_options.ascending, run_options.top,
+                                                  run_options.n_workers) };
+
+      // #7 Imprimir os resultados.
+      profile.phase("output");
+      print_results(run_options, results, order, sum_file, cache);
+    }
+
+    if (run_options.dedupe)
+    {
+      print_duplicates(results, duplicates, run_options.duplicates_once);
+    }
+  }
+
+  if (profile.enabled())
+  {
+    // [!] Sem a lista de resultados (saída contínua), os arquivos são os analisados mais os que vieram do cache.
+    size_t n_scanned{ 0 };
+    std::uint64_t n_bytes{ 0 };
+    for (const auto& worker : worker_stats)
+    {
+      n_scanned += worker.n_files;
+      n_bytes += worker.n_bytes;
+    }
+    const size_t n_cached{ cache != nullptr ? cache->n_hits() : 0 };
+    profile.finish();
+    profile.set_totals(run_options.stream_output ? n_scanned + n_cached : results.size(), n_cached, n_bytes);
+    if (run_options.stats)
+    {
+      std::cout.flush();
+      profile.report(std::cerr);
+    }
+  }
+
+  if (Trace::enabled() and not Trace::write(run_options.trace_file))
+  {
+    std::cerr << " Warning: could not write the trace file '" << run_options.trace_file << "'.\n";
+  }
+
+  return EXIT_SUCCESS;
+}
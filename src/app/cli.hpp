@@ -0,0 +1,28 @@
+/**
+ * @file cli.hpp
+ *
+ * @brief Declara o ponto de entrada da interface de linha de comando, compilado na `libsloc`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef CLI_HPP
+#define CLI_HPP
+
+/**
+ * @brief Executa o `sloc` com os argumentos @a argv, imprimindo na saída padrão como o executável.
+ *
+ * @details Não faz parte da ABI estável (`sloc.h`): pode encerrar o processo (`--help`, opções inválidas) e só é
+ * visível na biblioteca estática, para o executável `sloc`.
+ *
+ * @return int  Código de saída do programa.
+ */
+int sloc_cli_main(int argc, char* argv[]);
+
+#endif  //!< CLI_HPP
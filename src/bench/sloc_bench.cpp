@@ -0,0 +1,815 @@
+/*!
+ * @file sloc_bench.cpp
+ *
+ * @brief Benchmarks dos caminhos críticos do sloc.
+ *
+ * @details Uso: `sloc_bench [arquivos...] [--discovery [N]] [--sort [N...]] [--output [N...]] [--all]
+ *  [--json arquivo] [--compare referência.json [--threshold %]] [--allocations]`
+ *   - scanner (sempre): MB/s de cada motor sobre entradas sintéticas de cada formato e sobre os arquivos informados;
+ *   - `--discovery`: entradas/s da descoberta numa árvore sintética;
+ *   - `--sort`: registros/s da ordenação;
+ *   - `--output`: linhas/s da escrita dos resultados, em cada formato;
+ *   - `--all`: todos os grupos, com tamanhos moderados;
+ *   - `--allocations`: só verifica que cada motor não aloca nada no heap ao analisar as entradas (código de saída 1 se
+ *     alocar).
+ *
+ *  `--json` grava os resultados para comparar builds: `--compare` lê os de outra execução, imprime a variação de cada
+ *  resultado e termina com código 1 se algum cair mais que `--threshold` por cento (padrão: 5). Uma referência que não
+ *  pode ser lida, sem resultados ou sem nenhum resultado em comum com a execução atual também termina com código 1: a
+ *  verificação nunca passa sem ter comparado nada.
+ *
+ *  Os operandos que não começam com `-` são arquivos a medir (e precisam existir); opções desconhecidas, valores
+ *  inválidos ou ausentes mostram o uso (`-h`, `--help`) e terminam com código 1.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <fcntl.h>   // `open`
+#include <unistd.h>  // `close`
+
+#include <algorithm>   // `std::min`
+#include <cctype>      // `std::isdigit`
+#include <charconv>    // `std::from_chars`
+#include <chrono>      // `std::chrono::steady_clock`
+#include <cstdint>     // `std::uint64_t`
+#include <filesystem>  // `std::filesystem::recursive_directory_iterator`
+#include <functional>  // `std::function`
+#include <fstream>     // `std::ifstream`, `std::ofstream`
+#include <iomanip>     // `std::setw`
+#include <iostream>    // `std::cout`
+#include <iterator>    // `std::istreambuf_iterator`
+#include <random>      // `std::mt19937_64`
+#include <thread>      // `std::thread::hardware_concurrency`
+
+#define SLOC_ALLOC_HOOK_IMPLEMENTATION  // [!] Conta as alocações deste executável, para `--allocations`.
+
+#include "../common/aliases.hpp"
+#include "../common/alloc_hook.hpp"
+#include "../core/filter/dir_walker.hpp"
+#include "../core/filter/file_identity.hpp"
+#include "../core/filter/filter.hpp"
+#include "../core/io/result_writer.hpp"
+#include "../core/sloc/file_info.hpp"
+#include "../core/sloc/result_store.hpp"
+#include "../core/sloc/scan_engine.hpp"
+#include "../core/sloc/sloc.hpp"
+#include "../core/sort/sort.hpp"
+
+using bench_clock = std::chrono::steady_clock;
+
+/// @brief Tamanho aproximado de cada entrada sintética.
+constexpr size_t INPUT_SIZE{ 8 * 1024 * 1024 };
+
+/// @brief Tempo mínimo de medição de cada caso, em segundos.
+constexpr double MIN_SECONDS{ 0.5 };
+
+/**
+ * @brief Uma entrada do benchmark do scanner.
+ */
+struct Input
+{
+  str name;      //!< Nome do formato da entrada.
+  str contents;  //!< Conteúdo a ser analisado.
+};
+
+/**
+ * @brief Um resultado de benchmark. Todos são vazões: quanto maior, melhor.
+ */
+struct Measurement
+{
+  str name;            //!< Identificador estável (`grupo/caso/variante`), usado na comparação entre execuções.
+  str unit;            //!< Unidade da vazão (`MB/s`, `entries/s`, `records/s`, `rows/s`).
+  double value{ 0.0 };  //!< Vazão medida.
+};
+
+/**
+ * @brief Gera entradas sintéticas e determinísticas de ~`INPUT_SIZE` bytes, uma por formato.
+ *
+ * @details Os formatos exercitam partes diferentes do scanner: código comum, comentários (de linha, de bloco e de
+ * documentação), literais com escapes e linhas muito longas (código minificado).
+ */
+vec<Input> make_inputs()
+{
+  std::mt19937_64 rng{ 2025 };  //!< Semente fixa: as entradas são sempre as mesmas.
+  auto pick{ [&rng](const vec<str>& options) -> const str& { return options[rng() % options.size()]; } };
+
+  const vec<str> code_lines{ "    int value = compute(first, second) + 42;",
+                             "    for (size_t i{ 0 }; i < items.size(); ++i)",
+                             "    {",
+                             "      total += items[i].weight * factor;",
+                             "    }",
+                             "    return std::max(total, threshold);",
+                             "",
+                             "  if (not ready) { wait(); } // [!] espera",
+                             "template <typename T> static T clamp(T v, T lo, T hi) { return v < lo ? lo : v > hi ? hi : v; }" };
+  const vec<str> comment_lines{ "/**",
+                                " * @brief Calcula o total ponderado dos itens.",
+                                " *",
+                                " * @param items  Itens a serem somados.",
+                                " */",
+                                "/* bloco regular */ int x; /* outro */",
+                                "// comentário de linha regular",
+                                "/// comentário de documentação",
+                                "   " };
+  const vec<str> literal_lines{ R"(  const char* path{ "C:\\Users\\sloc\\\"quoted\"\\file.cpp" };)",
+                                R"(  std::cout << "// isto não é comentário" << '\'' << "/* nem isto */\n";)",
+                                R"(  char c{ '\\' }, d{ '"' }, e{ '\x41' };)",
+                                R"(  str message{ "linha com \"aspas\" e \\barras\\ e \t tabs" };)" };
+
+  vec<Input> inputs{ { "code", "" }, { "comments", "" }, { "literals", "" }, { "long_lines", "" } };
+
+  while (inputs[0].contents.size() < INPUT_SIZE)
+  {
+    inputs[0].contents += pick(code_lines) + '\n';
+  }
+  while (inputs[1].contents.size() < INPUT_SIZE)
+  {
+    inputs[1].contents += pick(comment_lines) + '\n';
+  }
+  while (inputs[2].contents.size() < INPUT_SIZE)
+  {
+    inputs[2].contents += pick(literal_lines) + '\n';
+  }
+  while (inputs[3].contents.size() < INPUT_SIZE)
+  {
+    // [!] Código minificado: ~64 KiB por linha.
+    for (size_t n{ 0 }; n < 64 * 1024; n += 40)
+    {
+      inputs[3].contents += "a=b+c;f(x,\"s\",'c');/*k*/if(y){z();}";
+    }
+    inputs[3].contents += '\n';
+  }
+
+  return inputs;
+}
+
+/**
+ * @brief Mede a vazão (MB/s) do scanner @a engine sobre @a contents.
+ *
+ * @details Repete a análise até somar pelo menos `MIN_SECONDS` e usa a repetição mais rápida, o que reduz o ruído de
+ * outros processos na máquina.
+ */
+double scanner_throughput(ScanEngine engine, const str& contents)
+{
+  Sloc sloc_counter{ engine };
+  double best{ 1e30 };
+  double elapsed{ 0.0 };
+
+  while (elapsed < MIN_SECONDS)
+  {
+    FileInfo file{};
+    const auto start{ bench_clock::now() };
+    sloc_counter.analyze_contents(contents, file);
+    const double seconds{ std::chrono::duration<double>(bench_clock::now() - start).count() };
+
+    best = std::min(best, seconds);
+    elapsed += seconds;
+  }
+
+  return static_cast<double>(contents.size()) / (1024.0 * 1024.0) / best;
+}
+
+/**
+ * @brief Conta as alocações no heap de uma análise de @a contents pelo motor @a engine.
+ *
+ * @details Uma primeira análise aquece o `Sloc` (buffers e tabelas criados no primeiro uso); só a segunda, com o mesmo
+ * `Sloc`, é contada. O custo por linha tem de ser zero, então qualquer alocação aqui é uma regressão.
+ */
+std::uint64_t scanner_allocations(ScanEngine engine, const str& contents)
+{
+  Sloc sloc_counter{ engine };
+  FileInfo warm_up{};
+  sloc_counter.analyze_contents(contents, warm_up);
+
+  FileInfo file{};
+  const std::uint64_t before{ AllocHook::count() };
+  sloc_counter.analyze_contents(contents, file);
+  return AllocHook::count() - before;
+}
+
+/**
+ * @brief Lê um arquivo inteiro para a memória.
+ */
+str read_file(const str& path)
+{
+  std::ifstream ifs{ path, std::ios::binary };
+  return str{ std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+}
+
+/**
+ * @brief Cria (se ainda não existir) uma árvore com ~@a n_entries entradas: 100 diretórios com 100 subdiretórios cada,
+ * e os arquivos divididos igualmente entre eles. Metade dos arquivos tem extensão suportada (`.c`) e metade não (`.txt`).
+ */
+void make_tree(const std::filesystem::path& root, size_t n_entries)
+{
+  const std::filesystem::path done_marker{ root / ".complete" };
+  if (std::filesystem::exists(done_marker))
+  {
+    return;  // [!] A árvore é reaproveitada entre execuções: criá-la custa mais que medi-la.
+  }
+
+  constexpr size_t FAN_OUT{ 100 };
+  const size_t n_leaves{ FAN_OUT * FAN_OUT };
+  const size_t files_per_leaf{ std::max(size_t{ 1 }, n_entries / n_leaves) };
+
+  for (size_t a{ 0 }; a < FAN_OUT; ++a)
+  {
+    for (size_t b{ 0 }; b < FAN_OUT; ++b)
+    {
+      const std::filesystem::path leaf{ root / ("d" + std::to_string(a)) / ("d" + std::to_string(b)) };
+      std::filesystem::create_directories(leaf);
+      for (size_t f{ 0 }; f < files_per_leaf; ++f)
+      {
+        std::ofstream{ leaf / ("f" + std::to_string(f) + (f % 2 == 0 ? ".c" : ".txt")) };
+      }
+    }
+  }
+  std::ofstream{ done_marker };
+}
+
+/**
+ * @brief Descoberta de referência: o caminho antigo do `Filter` (`recursive_directory_iterator`, `is_regular_file` e
+ * `file_size` por entrada), sem a deduplicação.
+ */
+size_t discover_with_iterator(const std::filesystem::path& root)
+{
+  size_t n_found{ 0 };
+  std::error_code error{};
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(root))
+  {
+    if (std::filesystem::is_regular_file(entry) and entry.path().extension() == ".c")
+    {
+      n_found += std::filesystem::file_size(entry, error) != static_cast<std::uintmax_t>(-1) ? 1 : 0;
+    }
+  }
+  return n_found;
+}
+
+/**
+ * @brief Descoberta com o `DirWalker` usando @a n_threads threads.
+ */
+size_t discover_with_walker(const std::filesystem::path& root, size_t n_threads)
+{
+  SeenFiles seen{};
+  DirWalker walker{ true, [](str_view name) { return name.size() > 2 and name.substr(name.size() - 2) == ".c"; }, n_threads };
+  return walker.walk(root.string(), seen).size();
+}
+
+/**
+ * @brief Descoberta completa do sloc (`Filter::filter`, com o filtro de extensões e a montagem dos `FileInfo`) usando
+ * @a n_threads threads.
+ */
+size_t discover_with_filter(const std::filesystem::path& root, size_t n_threads)
+{
+  return Filter::filter({ root.string() }, true, LangType::CPP, n_threads).size();
+}
+
+/**
+ * @brief Mede a vazão da descoberta (entradas do diretório por segundo) de cada estratégia sobre uma árvore de
+ * @a n_entries entradas.
+ */
+void discovery_benchmark(size_t n_entries, vec<Measurement>& measurements)
+{
+  const std::filesystem::path root{ std::filesystem::temp_directory_path() / ("sloc_bench_tree_" + std::to_string(n_entries)) };
+  std::cout << "\n(creating/reusing " << root.string() << ")\n";
+  make_tree(root, n_entries);
+
+  size_t n_total{ 0 };  //!< Entradas da árvore (arquivos e diretórios), usadas no cálculo da vazão.
+  for (auto it{ std::filesystem::recursive_directory_iterator(root) }; it != std::filesystem::recursive_directory_iterator(); ++it)
+  {
+    ++n_total;  // [!] Esta passada também aquece o cache de diretórios do kernel para todas as estratégias.
+  }
+
+  const size_t n_cores{ std::max(1U, std::thread::hardware_concurrency()) };
+  vec<std::pair<str, std::function<size_t()>>> strategies{
+    { "iterator", [&root] { return discover_with_iterator(root); } },
+    { "walker -j 1", [&root] { return discover_with_walker(root, 1); } },
+    { "filter -j 1", [&root] { return discover_with_filter(root, 1); } },
+  };
+  if (n_cores > 1)
+  {
+    strategies.push_back({ "walker -j " + std::to_string(n_cores), [&root, n_cores] { return discover_with_walker(root, n_cores); } });
+    strategies.push_back({ "filter -j " + std::to_string(n_cores), [&root, n_cores] { return discover_with_filter(root, n_cores); } });
+  }
+
+  std::cout << std::left << std::setw(24) << "discovery" << std::setw(14) << "entries/s" << std::setw(12) << "seconds"
+            << "files found\n";
+  for (const auto& strategy : strategies)
+  {
+    double best{ 1e30 };
+    size_t n_found{ 0 };
+    for (int repetition{ 0 }; repetition < 3; ++repetition)
+    {
+      const auto start{ bench_clock::now() };
+      n_found = strategy.second();
+      best = std::min(best, std::chrono::duration<double>(bench_clock::now() - start).count());
+    }
+    std::cout << std::setw(24) << strategy.first << std::setw(14) << std::fixed << std::setprecision(0)
+              << static_cast<double>(n_total) / best << std::setw(12) << std::setprecision(3) << best << n_found << '\n';
+    measurements.push_back({ "discovery/" + std::to_string(n_entries) + "/" + strategy.first, "entries/s",
+                             static_cast<double>(n_total) / best });
+  }
+}
+
+/**
+ * @brief Gera @a n_records resultados sintéticos e determinísticos: caminhos com uma raiz comum longa e contadores
+ * aleatórios.
+ */
+vec<FileInfo> make_records(size_t n_records)
+{
+  std::mt19937_64 rng{ 2025 };
+  vec<FileInfo> files(n_records);
+  for (auto& file : files)
+  {
+    file.m_filename = "/home/user/projects/sloc/src/module" + std::to_string(rng() % 1000) + "/unit" + std::to_string(rng() % 100)
+                      + "/file" + std::to_string(rng() % 100'000) + ".cpp";
+    file.m_type = LangType::CPP;
+    file.n_loc = rng() % 5'000;
+    file.n_reg_comments = rng() % 500;
+    file.n_doc_comments = rng() % 500;
+    file.n_blank_lines = rng() % 500;
+    file.n_lines = file.n_loc + file.n_reg_comments + file.n_doc_comments + file.n_blank_lines;
+  }
+  return files;
+}
+
+/**
+ * @brief Mede a ordenação de @a n_records resultados (registros por segundo): a ordenação antiga (`Sort::sortSloc`,
+ * `std::stable_sort` sobre `vec<FileInfo>`) contra `Sort::order` sobre o `ResultStore`, com uma thread e, se houver
+ * mais de um núcleo, com todos.
+ */
+void sort_benchmark(size_t n_records, vec<Measurement>& measurements)
+{
+  const int n_repetitions{ n_records <= 1'000'000 ? 3 : 1 };
+  const size_t n_cores{ std::max(1U, std::thread::hardware_concurrency()) };
+  auto report{ [&measurements, n_records](const str& name, double seconds) {
+    std::cout << std::setw(32) << name << std::setw(14) << std::fixed << std::setprecision(0)
+              << static_cast<double>(n_records) / seconds << std::setprecision(3) << seconds << '\n';
+    measurements.push_back({ "sort/" + std::to_string(n_records) + "/" + name, "records/s", static_cast<double>(n_records) / seconds });
+  } };
+
+  std::cout << '\n' << std::left << std::setw(32) << ("sort (" + std::to_string(n_records) + " records)") << std::setw(14)
+            << "records/s" << "seconds\n";
+
+  // [!] Referência: cada repetição ordena uma lista recém-gerada (ordenar a lista já ordenada seria mais barato).
+  RunningOptions ro{};
+  for (const auto& [name, field] : vec<std::pair<str, FieldOption>>{ { "filename", FieldOption::FILENAME }, { "sloc", FieldOption::SLOC } })
+  {
+    double best{ 1e30 };
+    for (int repetition{ 0 }; repetition < n_repetitions; ++repetition)
+    {
+      vec<FileInfo> files{ make_records(n_records) };
+      const auto start{ bench_clock::now() };
+      Sort::sortSloc(files, field, ro);
+      best = std::min(best, std::chrono::duration<double>(bench_clock::now() - start).count());
+    }
+    report("std::stable_sort by " + name, best);
+  }
+
+  ResultStore results{};
+  {
+    vec<FileInfo> files{ make_records(n_records) };
+    results.append(files);  // [!] Libera a lista: com 10^7 registros, as duas cópias não caberiam juntas.
+  }
+
+  vec<size_t> thread_counts{ 1 };
+  if (n_cores > 1)
+  {
+    thread_counts.push_back(n_cores);
+  }
+  for (const auto& [name, field] : vec<std::pair<str, FieldOption>>{ { "filename", FieldOption::FILENAME }, { "sloc", FieldOption::SLOC } })
+  {
+    for (const size_t n_threads : thread_counts)
+    {
+      if (field != FieldOption::FILENAME and n_threads > 1)
+      {
+        continue;  // [!] Só a ordenação por nome tem caminho paralelo.
+      }
+      double best{ 1e30 };
+      for (int repetition{ 0 }; repetition < n_repetitions; ++repetition)
+      {
+        const auto start{ bench_clock::now() };
+        const vec<std::uint32_t> rows{ Sort::order(results, { field }, true, 0, n_threads) };
+        best = std::min(best, std::chrono::duration<double>(bench_clock::now() - start).count());
+      }
+      report("order by " + name + " -j " + std::to_string(n_threads), best);
+    }
+  }
+}
+
+/**
+ * @brief Mede a escrita de @a n_records linhas de resultados (linhas por segundo) em cada formato de saída, com o
+ * `ResultWriter` escrevendo em `/dev/null`.
+ */
+void output_benchmark(size_t n_records, vec<Measurement>& measurements)
+{
+  ResultStore results{};
+  {
+    vec<FileInfo> files{ make_records(n_records) };
+    results.append(files);
+  }
+  size_t name_width{ 0 };
+  for (size_t row{ 0 }; row < results.size(); ++row)
+  {
+    name_width = std::max(name_width, results.path_length(row));
+  }
+
+  const int null_fd{ ::open("/dev/null", O_WRONLY | O_CLOEXEC) };
+  const int n_repetitions{ n_records <= 1'000'000 ? 3 : 1 };
+  std::cout << '\n' << std::left << std::setw(32) << ("output (" + std::to_string(n_records) + " rows)") << std::setw(14)
+            << "rows/s" << "seconds\n";
+
+  const vec<std::pair<str, OutputFormat>> formats{ { "table", OutputFormat::TABLE },
+                                                   { "csv", OutputFormat::CSV },
+                                                   { "json", OutputFormat::JSON },
+                                                   { "ndjson", OutputFormat::NDJSON } };
+  for (const auto& [name, format] : formats)
+  {
+    double best{ 1e30 };
+    for (int repetition{ 0 }; repetition < n_repetitions; ++repetition)
+    {
+      const auto start{ bench_clock::now() };
+      ResultWriter writer{ format, name_width, null_fd };
+      writer.begin();
+      for (size_t row{ 0 }; row < results.size(); ++row)
+      {
+        writer.row(results.path(row), results.type(row), results.counts(row));
+      }
+      writer.end(results.total(), results.size());
+      best = std::min(best, std::chrono::duration<double>(bench_clock::now() - start).count());
+    }
+    std::cout << std::setw(32) << name << std::setw(14) << std::fixed << std::setprecision(0)
+              << static_cast<double>(n_records) / best << std::setprecision(3) << best << '\n';
+    measurements.push_back({ "output/" + std::to_string(n_records) + "/" + name, "rows/s", static_cast<double>(n_records) / best });
+  }
+  ::close(null_fd);
+}
+
+/**
+ * @brief Grava @a measurements em @a path, como JSON: `{"benchmarks": [{"name": ..., "unit": ..., "value": ...}]}`,
+ * um resultado por linha.
+ */
+bool write_json(const str& path, const vec<Measurement>& measurements)
+{
+  std::ofstream ofs{ path };
+  ofs << "{\"benchmarks\": [\n";
+  for (size_t m{ 0 }; m < measurements.size(); ++m)
+  {
+    const auto& measurement{ measurements[m] };
+    ofs << "  {\"name\": \"" << measurement.name << "\", \"unit\": \"" << measurement.unit << "\", \"value\": " << std::fixed
+        << std::setprecision(1) << measurement.value << (m + 1 < measurements.size() ? "},\n" : "}\n");
+  }
+  ofs << "]}\n";
+  return static_cast<bool>(ofs);
+}
+
+/**
+ * @brief Converte @a text (inteiro ou decimal, conforme @a T, sem sinal de `+`) em @a value.
+ *
+ * @return bool  `false` se @a text for vazio, tiver outros caracteres ou não couber em @a value.
+ */
+template <typename T>
+bool parse_number(str_view text, T& value)
+{
+  const char* end{ text.data() + text.size() };
+  const auto [last, error]{ std::from_chars(text.data(), end, value) };
+  return not text.empty() and error == std::errc{} and last == end;
+}
+
+/**
+ * @brief Lê os resultados gravados por `write_json` (uma linha por resultado; outros JSONs não são aceitos) em
+ * @a measurements.
+ *
+ * @return bool  `false` se o arquivo não pôde ser aberto ou tem um valor malformado.
+ */
+bool read_json(const str& path, vec<Measurement>& measurements)
+{
+  std::ifstream ifs{ path };
+  if (not ifs)
+  {
+    return false;
+  }
+  str line{};
+  auto string_field{ [&line](str_view key) -> str {
+    const size_t start{ line.find(str{ "\"" } + str{ key } + "\": \"") };
+    if (start == str::npos)
+    {
+      return "";
+    }
+    const size_t first{ start + key.size() + 5 };
+    return line.substr(first, line.find('"', first) - first);
+  } };
+  while (std::getline(ifs, line))
+  {
+    const size_t value{ line.find("\"value\": ") };
+    if (value != str::npos)
+    {
+      // [!] O valor é o último campo do objeto: termina no `}`.
+      const size_t first{ value + 9 };
+      double number{ 0.0 };
+      if (not parse_number(str_view{ line }.substr(first, line.find('}', first) - first), number))
+      {
+        return false;
+      }
+      measurements.push_back({ string_field("name"), string_field("unit"), number });
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Compara @a current com a execução de referência @a baseline e imprime as variações.
+ *
+ * @details Só entram os resultados presentes nas duas execuções (pelo nome). Uma queda maior que @a threshold por cento
+ * é uma regressão.
+ *
+ * @param n_compared  Recebe quantos resultados foram de fato comparados.
+ *
+ * @return size_t  Número de regressões.
+ */
+size_t compare(const vec<Measurement>& baseline, const vec<Measurement>& current, double threshold, size_t& n_compared)
+{
+  n_compared = 0;
+  umap<str, double> base_values{};
+  for (const auto& measurement : baseline)
+  {
+    base_values[measurement.name] = measurement.value;
+  }
+
+  std::cout << '\n' << std::left << std::setw(48) << "comparison" << std::setw(16) << "baseline" << std::setw(16) << "current"
+            << std::setw(10) << "change" << "status\n";
+  size_t n_regressions{ 0 };
+  for (const auto& measurement : current)
+  {
+    const auto it{ base_values.find(measurement.name) };
+    if (it == base_values.end() or it->second <= 0.0)
+    {
+      continue;
+    }
+    ++n_compared;
+    const double change{ (measurement.value - it->second) * 100.0 / it->second };
+    const bool regression{ change < -threshold };
+    n_regressions += regression ? 1 : 0;
+    std::cout << std::setw(48) << measurement.name << std::setw(16) << std::fixed << std::setprecision(1) << it->second
+              << std::setw(16) << measurement.value << std::setw(10)
+              << ((change >= 0 ? "+" : "") + std::to_string(static_cast<int>(change)) + "%")
+              << (regression ? "REGRESSION" : change > threshold ? "faster" : "ok") << " " << measurement.unit << '\n';
+  }
+  std::cout << "\n" << n_regressions << " regression(s) beyond " << threshold << "%\n";
+  return n_regressions;
+}
+
+/**
+ * @brief Escreve em @a os as opções do `sloc_bench`.
+ */
+void usage(std::ostream& os)
+{
+  os << "Usage: sloc_bench [FILE...] [--discovery [N]] [--sort [N...]] [--output [N...]] [--all]\n"
+        "                  [--json FILE] [--compare BASELINE.json [--threshold PERCENT]] [--allocations]\n"
+        "       sloc_bench -h | --help\n";
+}
+
+/**
+ * @brief Informa em `std::cerr` que @a arg é inválido (@a reason) e mostra as opções.
+ *
+ * @return int  `EXIT_FAILURE`, para ser retornado por `main`.
+ */
+int invalid(const str& arg, str_view reason)
+{
+  std::cerr << arg << ": " << reason << "\n\n";
+  usage(std::cerr);
+  return EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+  vec<str> files{};               //!< Arquivos medidos junto com as entradas sintéticas.
+  size_t discovery_entries{ 0 };  //!< Tamanho da árvore do benchmark de descoberta (0: não roda).
+  vec<size_t> sort_sizes{};       //!< Tamanhos do benchmark de ordenação (vazio: não roda).
+  vec<size_t> output_sizes{};     //!< Tamanhos do benchmark de saída (vazio: não roda).
+  str json_path{};                //!< Arquivo onde os resultados são gravados em JSON (vazio: não grava).
+  str baseline_path{};            //!< Resultados de referência para a comparação (vazio: não compara).
+  double threshold{ 5.0 };        //!< Queda, em porcentagem, a partir da qual há regressão.
+  bool allocations{ false };      //!< Só verifica as alocações do scanner.
+
+  // [!] Um argumento que começa com dígito depois de `--discovery`, `--sort` ou `--output` é um tamanho.
+  auto is_size{ [&](int i) { return i < argc and std::isdigit(static_cast<unsigned char>(argv[i][0])); } };
+
+  // [!] Lê uma lista de tamanhos depois da opção, ou usa @a defaults; `false` se algum tamanho for inválido.
+  auto read_sizes{ [&](int& i, vec<size_t>& sizes, const vec<size_t>& defaults) {
+    while (is_size(i + 1))
+    {
+      size_t size{ 0 };
+      if (not parse_number(argv[i + 1], size))
+      {
+        return false;
+      }
+      sizes.push_back(size);
+      ++i;
+    }
+    if (sizes.empty())
+    {
+      sizes = defaults;
+    }
+    return true;
+  } };
+
+  for (int i{ 1 }; i < argc; ++i)
+  {
+    const str arg{ argv[i] };
+    const bool has_value{ i + 1 < argc };
+    if (arg == "-h" or arg == "--help")
+    {
+      usage(std::cout);
+      return EXIT_SUCCESS;
+    }
+    else if (arg == "--discovery")
+    {
+      // [!] `--discovery [N]`: mede a descoberta numa árvore de N entradas (padrão: um milhão).
+      discovery_entries = 1'000'000;
+      if (is_size(i + 1) and not parse_number(argv[++i], discovery_entries))
+      {
+        return invalid(arg, "expected a number of entries");
+      }
+    }
+    else if (arg == "--sort")
+    {
+      // [!] `--sort [N...]`: mede a ordenação de N registros sintéticos (padrão: 10^5, 10^6 e 10^7).
+      if (not read_sizes(i, sort_sizes, { 100'000, 1'000'000, 10'000'000 }))
+      {
+        return invalid(arg, "expected numbers of records");
+      }
+    }
+    else if (arg == "--output")
+    {
+      // [!] `--output [N...]`: mede a escrita de N linhas de resultados em cada formato (padrão: um milhão).
+      if (not read_sizes(i, output_sizes, { 1'000'000 }))
+      {
+        return invalid(arg, "expected numbers of rows");
+      }
+    }
+    else if (arg == "--all")
+    {
+      // [!] Todos os grupos, com tamanhos que cabem em poucos minutos.
+      discovery_entries = 100'000;
+      sort_sizes = { 100'000, 1'000'000 };
+      output_sizes = { 1'000'000 };
+    }
+    else if (arg == "--allocations")
+    {
+      allocations = true;
+    }
+    else if (arg == "--json" and has_value)
+    {
+      json_path = argv[++i];
+    }
+    else if (arg == "--compare" and has_value)
+    {
+      baseline_path = argv[++i];
+    }
+    else if (arg == "--threshold" and has_value)
+    {
+      if (not parse_number(argv[++i], threshold) or threshold < 0.0)
+      {
+        return invalid(arg, "expected a non-negative percentage");
+      }
+    }
+    else if (not arg.empty() and arg[0] != '-')
+    {
+      // [!] Arquivos passados como argumento são medidos junto com as entradas sintéticas.
+      std::error_code error{};
+      if (not std::filesystem::is_regular_file(arg, error))
+      {
+        return invalid(arg, "no such file");
+      }
+      files.push_back(arg);
+    }
+    else
+    {
+      return invalid(arg, "unknown option or missing value");
+    }
+  }
+
+  // [!] A referência é lida antes das medições: um caminho errado não deve custar a execução inteira.
+  vec<Measurement> baseline{};
+  if (not baseline_path.empty())
+  {
+    if (not read_json(baseline_path, baseline))
+    {
+      std::cerr << "Could not read the baseline " << baseline_path << '\n';
+      return EXIT_FAILURE;
+    }
+    if (baseline.empty())
+    {
+      std::cerr << "The baseline " << baseline_path << " has no measurements\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  vec<Input> inputs{ make_inputs() };
+  for (const auto& file : files)
+  {
+    inputs.push_back({ file, read_file(file) });
+  }
+
+  const vec<std::pair<str, ScanEngine>> engines{ { "scalar", ScanEngine::SCALAR },
+                                                 { "simd", ScanEngine::SIMD },
+                                                 { "dfa", ScanEngine::DFA } };
+
+  if (allocations)
+  {
+    std::cout << std::left << std::setw(24) << "scanner (allocations)";
+    for (const auto& engine : engines)
+    {
+      std::cout << std::setw(12) << engine.first;
+    }
+    std::cout << '\n';
+
+    size_t n_failures{ 0 };
+    for (const auto& input : inputs)
+    {
+      std::cout << std::setw(24) << input.name;
+      for (const auto& engine : engines)
+      {
+        const std::uint64_t n_allocations{ scanner_allocations(engine.second, input.contents) };
+        n_failures += n_allocations > 0 ? 1 : 0;
+        std::cout << std::setw(12) << n_allocations;
+      }
+      std::cout << '\n';
+    }
+
+    // [!] Sem o gancho (operadores `new` não substituídos), a contagem seria sempre zero e a verificação, inútil.
+    if (not AllocHook::enabled())
+    {
+      std::cerr << "The allocation hook is not active in this build.\n";
+      return EXIT_FAILURE;
+    }
+    std::cout << '\n' << n_failures << " case(s) allocating while scanning\n";
+    return n_failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  std::cout << std::left << std::setw(24) << "scanner (MB/s)";
+  for (const auto& engine : engines)
+  {
+    std::cout << std::setw(12) << engine.first;
+  }
+  std::cout << '\n';
+
+  vec<Measurement> measurements{};
+  for (const auto& input : inputs)
+  {
+    std::cout << std::setw(24) << input.name;
+    for (const auto& engine : engines)
+    {
+      const double throughput{ scanner_throughput(engine.second, input.contents) };
+      std::cout << std::setw(12) << std::fixed << std::setprecision(1) << throughput;
+      measurements.push_back({ "scanner/" + input.name + "/" + engine.first, "MB/s", throughput });
+    }
+    std::cout << '\n';
+  }
+
+  if (discovery_entries > 0)
+  {
+    discovery_benchmark(discovery_entries, measurements);
+  }
+
+  for (const size_t n_records : sort_sizes)
+  {
+    sort_benchmark(n_records, measurements);
+  }
+
+  for (const size_t n_records : output_sizes)
+  {
+    output_benchmark(n_records, measurements);
+  }
+
+  if (not json_path.empty() and not write_json(json_path, measurements))
+  {
+    std::cerr << "Could not write " << json_path << '\n';
+    return EXIT_FAILURE;
+  }
+
+  // [!] Com regressões além do limite, ou sem nada para comparar, o código de saída é 1 (para uso em scripts de CI).
+  if (not baseline_path.empty())
+  {
+    size_t n_compared{ 0 };
+    const size_t n_regressions{ compare(baseline, measurements, threshold, n_compared) };
+    if (n_compared == 0)
+    {
+      std::cerr << "The baseline " << baseline_path << " has no measurement in common with this run\n";
+      return EXIT_FAILURE;
+    }
+    if (n_regressions > 0)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,878 @@
+/*!
+ * @file sloc_corpus.cpp
+ *
+ * @brief Gerador determinístico de árvores C/C++ sintéticas, com as contagens esperadas de cada arquivo.
+ *
+ * @details Uso:
+ *   - `sloc_corpus <dir> [--seed N] [--size BYTES] [--depth D] [--fan-out F] [--median-size BYTES]
+ *      [--mix code=W,comments=W,literals=W] [--no-pathological]`
+ *     Gera em @a dir uma árvore de arquivos `.c`, `.h`, `.cpp` e `.hpp` até somar ~`--size` bytes (sufixos k, M e G),
+ *     e grava `expected.csv` com as contagens de cada arquivo (as mesmas colunas de `sloc --format csv`, com caminhos
+ *     relativos a @a dir). A mesma semente e os mesmos parâmetros geram sempre os mesmos bytes, em qualquer máquina.
+ *     Os casos patológicos (~17 MiB no total) entram no orçamento: os que não cabem nele são pulados e listados, e o
+ *     total gerado é impresso no fim.
+ *   - `sloc_corpus --verify <dir>`
+ *     Analisa cada arquivo de `expected.csv` com todos os caminhos do scanner (motores escalar, SIMD e DFA, leitura
+ *     em blocos e análise especulativa em pedaços), confere os subtotais por diretório (`--by-dir`) com caminhos
+ *     escritos com `.` e `..`, e lista as divergências. Termina com código 1 se houver alguma.
+ *   - `sloc_corpus -h | --help`
+ *     Mostra as opções. Valores inválidos (números, tamanhos, chaves de `--mix`) também as mostram, com código 1.
+ *
+ * As contagens esperadas não vêm do scanner: cada linha é gerada junto com a sua classificação (código, comentário
+ * regular, comentário de documentação, linha em branco). Todo trecho gerado começa e termina fora de literais e
+ * comentários, então a classificação de uma linha não depende do que veio antes. Construções em que o C++ e a máquina
+ * de estados do sloc discordam (uma raw string com `"` ou `\` no conteúdo, por exemplo) não são geradas.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <algorithm>   // `std::min`, `std::max`
+#include <array>       // `std::array`
+#include <cctype>      // `std::isdigit`
+#include <charconv>    // `std::from_chars`
+#include <cstdint>     // `std::uint64_t`
+#include <filesystem>  // `std::filesystem::create_directories`
+#include <fstream>     // `std::ifstream`, `std::ofstream`
+#include <iostream>    // `std::cout`, `std::cerr`
+#include <iterator>    // `std::istreambuf_iterator`
+#include <random>      // `std::mt19937_64`
+#include <sstream>     // `std::istringstream`
+
+#include "../common/aliases.hpp"
+#include "../core/sloc/dir_rollup.hpp"
+#include "../core/sloc/file_info.hpp"
+#include "../core/sloc/result_store.hpp"
+#include "../core/sloc/scan_engine.hpp"
+#include "../core/sloc/sloc.hpp"
+#include "../core/sloc/speculative_scan.hpp"
+
+/// @brief Nome do arquivo com as contagens esperadas, na raiz do corpus.
+constexpr str_view EXPECTED_FILE{ "expected.csv" };
+
+/// @brief Tamanho de cada pedaço na verificação da análise especulativa (pequeno, para cortar até arquivos médios).
+constexpr size_t VERIFY_CHUNK_SIZE{ 16 * 1024 };
+
+/**
+ * @brief Parâmetros do corpus.
+ */
+struct CorpusOptions
+{
+  std::uint64_t seed{ 2025 };                        //!< Semente do gerador.
+  size_t size{ 64 * 1024 * 1024 };                   //!< Orçamento de bytes dos arquivos comuns.
+  size_t depth{ 3 };                                 //!< Níveis de diretórios abaixo da raiz.
+  size_t fan_out{ 8 };                               //!< Subdiretórios de cada diretório.
+  size_t median_size{ 8 * 1024 };                    //!< Tamanho mediano de um arquivo comum.
+  std::array<size_t, 3> mix{ 60, 25, 15 };           //!< Pesos de código, comentários e literais.
+  bool pathological{ true };                         //!< Indica se os casos patológicos são gerados.
+};
+
+/**
+ * @brief Gerador de números aleatórios portátil: só usa a saída crua do `std::mt19937_64` (cuja sequência é fixada
+ * pelo padrão), sem as distribuições da biblioteca, que variam entre implementações.
+ */
+class Random
+{
+private:
+  std::mt19937_64 m_engine;  //!< Motor com sequência definida pelo padrão.
+
+public:
+  explicit Random(std::uint64_t seed) : m_engine{ seed } {}
+
+  /// @brief Retorna um inteiro em [0, @a n).
+  size_t below(size_t n) { return static_cast<size_t>(m_engine() % n); }
+
+  /// @brief Retorna um inteiro em [@a lo, @a hi].
+  size_t between(size_t lo, size_t hi) { return lo + below(hi - lo + 1); }
+
+  /// @brief Retorna `true` com probabilidade @a percent / 100.
+  bool chance(size_t percent) { return below(100) < percent; }
+
+  /// @brief Escolhe um elemento de @a options.
+  template <typename Type>
+  const Type& pick(const vec<Type>& options)
+  {
+    return options[below(options.size())];
+  }
+
+  /// @brief Retorna 64 bits aleatórios.
+  std::uint64_t bits() { return m_engine(); }
+};
+
+/**
+ * @brief Conteúdo de um arquivo em construção, com as contagens esperadas de cada linha emitida.
+ */
+class Emitter
+{
+private:
+  str m_text{};          //!< Conteúdo do arquivo.
+  FileInfo m_expected{};  //!< Contagens esperadas.
+
+public:
+  /**
+   * @brief Emite uma linha (sem o `\n`) classificada pelas flags.
+   */
+  void line(str_view content, bool code, bool reg, bool doc, bool blank, str_view ending = "\n")
+  {
+    m_text += content;
+    m_text += ending;
+    m_expected.n_loc += code ? 1 : 0;
+    m_expected.n_reg_comments += reg ? 1 : 0;
+    m_expected.n_doc_comments += doc ? 1 : 0;
+    m_expected.n_blank_lines += blank ? 1 : 0;
+    m_expected.n_lines++;
+  }
+
+  /// @brief Emite uma linha de código.
+  void code(str_view content) { line(content, true, false, false, false); }
+
+  /// @brief Emite uma linha de comentário regular.
+  void reg(str_view content) { line(content, false, true, false, false); }
+
+  /// @brief Emite uma linha de comentário de documentação.
+  void doc(str_view content) { line(content, false, false, true, false); }
+
+  /// @brief Emite uma linha em branco (vazia ou só com espaços).
+  void blank(str_view content = "") { line(content, false, false, false, true); }
+
+  /// @brief Retorna o conteúdo emitido até agora.
+  const str& text() const { return m_text; }
+
+  /// @brief Retorna as contagens esperadas.
+  const FileInfo& expected() const { return m_expected; }
+};
+
+// Trechos {{{
+
+/// @brief Recuo aleatório (espaços ou tabulações).
+str indent(Random& rng)
+{
+  static const vec<str> indents{ "", "  ", "    ", "      ", "\t", "\t\t" };
+  return rng.pick(indents);
+}
+
+/// @brief Um identificador curto.
+str identifier(Random& rng)
+{
+  static const vec<str> names{ "value", "count", "buffer", "index", "total", "node", "state", "result", "width", "offset" };
+  return rng.pick(names) + std::to_string(rng.below(100));
+}
+
+/**
+ * @brief Trecho de código: instruções, chaves, linhas em branco e comentários no fim da linha.
+ */
+void code_block(Random& rng, Emitter& out)
+{
+  const size_t n_lines{ rng.between(3, 30) };
+  for (size_t l{ 0 }; l < n_lines; ++l)
+  {
+    const str pad{ indent(rng) };
+    const str name{ identifier(rng) };
+    switch (rng.below(12))
+    {
+    case 0: out.blank(); break;
+    case 1: out.blank(pad + " "); break;  // [!] Só espaços: em branco.
+    case 2: out.code(pad + "{"); break;
+    case 3: out.code(pad + "}"); break;
+    case 4: out.line(pad + name + " += 1; // " + identifier(rng), true, true, false, false); break;
+    case 5: out.line(pad + name + " = f(" + name + "); /* " + identifier(rng) + " */", true, true, false, false); break;
+    case 6: out.line(pad + "/* " + identifier(rng) + " */ return " + name + ";", true, true, false, false); break;
+    case 7: out.line(pad + "int " + name + "; /// " + identifier(rng), true, false, true, false); break;
+    case 8: out.line(pad + "int " + name + "; /** " + identifier(rng) + " */", true, false, true, false); break;
+    case 9: out.code(pad + "for (int i = 0; i < " + name + "; ++i) { sum += i * 2 / 3; }"); break;
+    case 10: out.code(pad + "#include <" + name + ".h>"); break;
+    default: out.code(pad + "auto " + name + " = compute(" + identifier(rng) + ", " + std::to_string(rng.below(1000)) + ");");
+    }
+  }
+}
+
+/**
+ * @brief Trecho de comentários: de linha e de bloco, regulares e de documentação, com linhas em branco dentro dos
+ * blocos (que contam como comentário).
+ */
+void comment_block(Random& rng, Emitter& out)
+{
+  const str pad{ indent(rng) };
+  switch (rng.below(6))
+  {
+  case 0:
+    for (size_t l{ rng.between(1, 6) }; l > 0; --l)
+    {
+      out.reg(pad + "// " + identifier(rng) + " " + identifier(rng));
+    }
+    break;
+  case 1:
+    for (size_t l{ rng.between(1, 6) }; l > 0; --l)
+    {
+      out.doc(pad + (rng.chance(50) ? "/// " : "//! ") + identifier(rng));
+    }
+    break;
+  case 2:
+  case 3:
+  {
+    // [!] Bloco de várias linhas: todas as linhas (inclusive as vazias) são do tipo do bloco.
+    const bool is_doc{ rng.chance(50) };
+    const bool bare{ rng.chance(30) };  //!< Sem o " * " no começo das linhas internas.
+    out.line(pad + (is_doc ? (rng.chance(50) ? "/**" : "/*!") : "/*"), false, not is_doc, is_doc, false);
+    for (size_t l{ rng.between(1, 12) }; l > 0; --l)
+    {
+      const str content{ rng.chance(15) ? str{} : pad + (bare ? "  " : " * ") + identifier(rng) + " // " + identifier(rng) };
+      out.line(content, false, not is_doc, is_doc, false);
+    }
+    out.line(pad + " */", false, not is_doc, is_doc, false);
+    break;
+  }
+  case 4:
+    // [!] Dois blocos na mesma linha, separados por espaço: só comentário.
+    out.reg(pad + "/* " + identifier(rng) + " */ /* " + identifier(rng) + " */");
+    break;
+  default:
+    // [!] Marcadores de bloco dentro de um comentário de linha não abrem um bloco.
+    out.reg(pad + "// " + identifier(rng) + " /* not a block");
+    out.code(pad + identifier(rng) + "();");
+  }
+}
+
+/**
+ * @brief Trecho de literais: escapes, aspas de outro tipo, marcadores de comentário e raw strings de várias linhas.
+ */
+void literal_block(Random& rng, Emitter& out)
+{
+  const str pad{ indent(rng) };
+  const str name{ identifier(rng) };
+  switch (rng.below(7))
+  {
+  case 0: out.code(pad + "const char* " + name + "{ \"a \\\"quoted\\\" \\\\ path\\\\\" };"); break;
+  case 1: out.code(pad + "str " + name + "{ \"http://example.com/*not*/\" };"); break;
+  case 2: out.code(pad + "char c{ '\"' }, d{ '\\'' }, e{ '\\\\' }, f{ '/' };"); break;
+  case 3: out.line(pad + "puts(\"// not a comment\"); // a comment", true, true, false, false); break;
+  case 4: out.code(pad + "auto " + name + "{ \"'single' in double\" }; auto q{ '\"' };"); break;
+  case 5:
+  {
+    // [!] Raw string de várias linhas: tudo é código, inclusive as linhas vazias e os marcadores de comentário. O
+    //     conteúdo nunca tem `"` nem `\` (nesses casos o C++ e a máquina de estados discordam).
+    out.code(pad + "const char* " + name + "{ R\"(first // line");
+    for (size_t l{ rng.between(1, 8) }; l > 0; --l)
+    {
+      switch (rng.below(4))
+      {
+      case 0: out.code(""); break;  // [!] Vazia dentro de um literal: código.
+      case 1: out.code("  /* inside */ " + identifier(rng)); break;
+      case 2: out.code("  // also inside"); break;
+      default: out.code("  " + identifier(rng) + " 'x'");
+      }
+    }
+    out.code(")\" };");
+    break;
+  }
+  default: out.code(pad + "printf(\"%d /* %s */\\n\", " + name + ", \"*/\");");
+  }
+}
+
+/**
+ * @brief Gera um arquivo comum de ~@a target_size bytes, escolhendo os trechos pelos pesos de @a options.mix.
+ */
+Emitter regular_file(Random& rng, size_t target_size, const CorpusOptions& options)
+{
+  Emitter out{};
+  const size_t total_weight{ options.mix[0] + options.mix[1] + options.mix[2] };
+  while (out.text().size() < target_size)
+  {
+    const size_t roll{ rng.below(total_weight) };
+    if (roll < options.mix[0])
+    {
+      code_block(rng, out);
+    }
+    else if (roll < options.mix[0] + options.mix[1])
+    {
+      comment_block(rng, out);
+    }
+    else
+    {
+      literal_block(rng, out);
+    }
+  }
+  return out;
+}
+
+// }}}
+
+// Casos patológicos {{{
+
+/**
+ * @brief Gera os casos patológicos, cada um com o seu nome.
+ */
+vec<std::pair<str, Emitter>> pathological_files(Random& rng)
+{
+  vec<std::pair<str, Emitter>> files{};
+
+  // [!] Uma única linha de código com 4 MiB, e outra de 2 MiB que termina num comentário.
+  {
+    Emitter out{};
+    str line{};
+    while (line.size() < 4 * 1024 * 1024)
+    {
+      line += "a=b+c;f(x,y);";
+    }
+    out.code(line);
+    line.resize(2 * 1024 * 1024);
+    out.line(line + " // tail", true, true, false, false);
+    files.emplace_back("long_lines.cpp", std::move(out));
+  }
+
+  // [!] Bloco de comentário enorme (regular e de documentação), com linhas vazias dentro.
+  for (const bool is_doc : { false, true })
+  {
+    Emitter out{};
+    out.code("int before;");
+    out.line(is_doc ? "/**" : "/*", false, not is_doc, is_doc, false);
+    for (size_t l{ 0 }; l < 150'000; ++l)
+    {
+      out.line(l % 10 == 9 ? str{} : " * " + identifier(rng) + " \"quote' // slash", false, not is_doc, is_doc, false);
+    }
+    out.line(" */", false, not is_doc, is_doc, false);
+    out.code("int after;");
+    files.emplace_back(is_doc ? "huge_doc_comment.hpp" : "huge_block_comment.c", std::move(out));
+  }
+
+  // [!] Tempestade de aspas escapadas: muitas linhas curtas e uma linha de 1 MiB.
+  {
+    Emitter out{};
+    for (size_t l{ 0 }; l < 20'000; ++l)
+    {
+      str storm{ "s = \"" };
+      for (size_t n{ rng.between(1, 40) }; n > 0; --n)
+      {
+        storm += rng.chance(50) ? "\\\"" : "\\\\";
+      }
+      out.code(storm + "\"; c = '\\'';");
+    }
+    str storm{ "s = \"" };
+    while (storm.size() < 1024 * 1024)
+    {
+      storm += "\\\"\\\\\\'";
+    }
+    out.code(storm + "\";");
+    files.emplace_back("escaped_quotes.cpp", std::move(out));
+  }
+
+  // [!] Raw strings com marcadores de comentário e linhas vazias.
+  {
+    Emitter out{};
+    for (size_t r{ 0 }; r < 5'000; ++r)
+    {
+      out.code("auto raw" + std::to_string(r) + " = R\"(/* not a comment");
+      out.code("");
+      out.code("// still inside */ ");
+      out.line(")\"; // after the literal" + str{ r % 2 == 0 ? "" : " x" }, true, true, false, false);
+      out.blank();
+    }
+    files.emplace_back("raw_strings.cpp", std::move(out));
+  }
+
+  // [!] `//`, `/*` e `*/` dentro de literais de string e de caractere.
+  {
+    Emitter out{};
+    for (size_t l{ 0 }; l < 20'000; ++l)
+    {
+      switch (l % 4)
+      {
+      case 0: out.code("url = \"https://host//path\";"); break;
+      case 1: out.code("open = \"/*\"; close = \"*/\";"); break;
+      case 2: out.code("slash = '/'; star = '*'; quote = '\"';"); break;
+      default: out.line("text = \"// fake\"; /* real */", true, true, false, false);
+      }
+    }
+    files.emplace_back("literal_markers.cpp", std::move(out));
+  }
+
+  // [!] Finais de linha CRLF (o `\r` é espaço em branco) e última linha sem `\n`.
+  {
+    Emitter out{};
+    for (size_t l{ 0 }; l < 1'000; ++l)
+    {
+      out.line("int x" + std::to_string(l) + ";", true, false, false, false, "\r\n");
+      out.line("", false, false, false, true, "\r\n");
+      out.line("// note", false, true, false, false, "\r\n");
+    }
+    out.line("int last;", true, false, false, false, "");
+    files.emplace_back("crlf_no_final_newline.c", std::move(out));
+  }
+
+  return files;
+}
+
+// }}}
+
+/**
+ * @brief Sorteia o tamanho de um arquivo comum: aproximadamente log-normal em torno de @a median, só com aritmética
+ * inteira (a oitava vem de uma binomial, o resto é uniforme dentro da oitava).
+ */
+size_t file_size(Random& rng, size_t median)
+{
+  const int octave{ __builtin_popcountll(rng.bits() & 0xFF) - 4 };  // [!] Binomial(8, 1/2), centrada em 0.
+  size_t size{ octave >= 0 ? median << octave : median >> -octave };
+  size += rng.below(size);  // [!] Espalha dentro da oitava.
+  return std::clamp(size, size_t{ 128 }, size_t{ 2 * 1024 * 1024 });
+}
+
+/**
+ * @brief Extensões geradas e o peso de cada uma.
+ */
+const vec<std::pair<str, LangType>>& extensions()
+{
+  static const vec<std::pair<str, LangType>> all{ { ".c", LangType::C },     { ".h", LangType::H },     { ".cpp", LangType::CPP },
+                                                  { ".cpp", LangType::CPP }, { ".hpp", LangType::HPP }, { ".cpp", LangType::CPP } };
+  return all;
+}
+
+/**
+ * @brief Grava @a contents em @a path.
+ */
+bool write_file(const std::filesystem::path& path, const str& contents)
+{
+  std::ofstream ofs{ path, std::ios::binary };
+  ofs.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  return static_cast<bool>(ofs);
+}
+
+/**
+ * @brief Acrescenta a linha de @a name (caminho relativo) com as contagens de @a counts ao CSV.
+ */
+void csv_row(std::ostream& csv, const str& name, LangType type, const FileInfo& counts)
+{
+  static const std::array<str_view, 4> LANGUAGES{ "C", "C/C++ header", "C++", "C++ header" };
+  csv << name << ',' << LANGUAGES[static_cast<size_t>(type)] << ',' << counts.n_reg_comments << ',' << counts.n_doc_comments
+      << ',' << counts.n_blank_lines << ',' << counts.n_loc << ',' << counts.n_lines << '\n';
+}
+
+/**
+ * @brief Gera o corpus em @a root.
+ */
+int generate(const std::filesystem::path& root, const CorpusOptions& options)
+{
+  Random rng{ options.seed };
+  std::filesystem::create_directories(root);
+
+  // [!] Diretórios: a raiz e `fan_out` filhos por diretório, até `depth` níveis (no máximo 100 mil).
+  vec<std::filesystem::path> dirs{ "." };
+  for (size_t level{ 0 }, first{ 0 }; level < options.depth and dirs.size() < 100'000; ++level)
+  {
+    const size_t last{ dirs.size() };
+    for (size_t d{ first }; d < last and dirs.size() < 100'000; ++d)
+    {
+      for (size_t c{ 0 }; c < options.fan_out; ++c)
+      {
+        dirs.push_back(dirs[d] / ("dir" + std::to_string(c)));
+      }
+    }
+    first = last;
+  }
+
+  std::ofstream csv{ root / EXPECTED_FILE };
+  csv << "filename,language,comments,doc_comments,blank,code,lines\n";
+  FileInfo sum{};
+  size_t n_files{ 0 };
+  size_t n_bytes{ 0 };
+
+  auto emit{ [&](const std::filesystem::path& relative, LangType type, const Emitter& out) {
+    std::filesystem::create_directories((root / relative).parent_path());
+    if (not write_file(root / relative, out.text()))
+    {
+      std::cerr << "Could not write " << (root / relative).string() << '\n';
+      return false;
+    }
+    csv_row(csv, relative.lexically_normal().string(), type, out.expected());
+    sum += out.expected();
+    n_bytes += out.text().size();
+    ++n_files;
+    return true;
+  } };
+
+  // [!] Os casos patológicos contam no orçamento: os que não cabem no que resta dele são pulados.
+  size_t budget{ 0 };
+  vec<str> skipped{};
+  if (options.pathological)
+  {
+    Random pathological_rng{ options.seed ^ 0x9E3779B97F4A7C15ULL };  // [!] Independente do orçamento e da árvore.
+    for (auto& [name, out] : pathological_files(pathological_rng))
+    {
+      if (budget + out.text().size() > options.size)
+      {
+        skipped.push_back(name);
+        continue;
+      }
+      const str extension{ std::filesystem::path{ name }.extension().string() };
+      const LangType type{ extension == ".c" ? LangType::C : extension == ".hpp" ? LangType::HPP : LangType::CPP };
+      if (not emit(std::filesystem::path{ "pathological" } / name, type, out))
+      {
+        return EXIT_FAILURE;
+      }
+      budget += out.text().size();
+    }
+  }
+
+  for (size_t f{ 0 }; budget < options.size; ++f)
+  {
+    const auto& [extension, type] = rng.pick(extensions());
+    const Emitter out{ regular_file(rng, file_size(rng, options.median_size), options) };
+    budget += out.text().size();
+    if (not emit(rng.pick(dirs) / ("file" + std::to_string(f) + extension), type, out))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << root.string() << ": " << n_files << " files, " << n_bytes << " bytes (seed " << options.seed << ")\n";
+  if (not skipped.empty())
+  {
+    std::cout << "skipped " << skipped.size() << " pathological file(s) larger than what was left of --size:";
+    for (const auto& name : skipped)
+    {
+      std::cout << ' ' << name;
+    }
+    std::cout << '\n';
+  }
+  std::cout << "expected SUM: comments " << sum.n_reg_comments << ", doc comments " << sum.n_doc_comments << ", blank "
+            << sum.n_blank_lines << ", code " << sum.n_loc << ", lines " << sum.n_lines << '\n';
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Converte @a text (só dígitos decimais, sem sinal) em @a value.
+ *
+ * @return bool  `false` se @a text for vazio, tiver outros caracteres ou não couber em @a value.
+ */
+template <typename T>
+bool parse_number(str_view text, T& value)
+{
+  const char* end{ text.data() + text.size() };
+  const auto [last, error]{ std::from_chars(text.data(), end, value) };
+  return not text.empty() and error == std::errc{} and last == end;
+}
+
+/**
+ * @brief Indica se as contagens de @a a e @a b são iguais.
+ */
+bool same_counts(const FileInfo& a, const FileInfo& b)
+{
+  return a.n_reg_comments == b.n_reg_comments and a.n_doc_comments == b.n_doc_comments and a.n_blank_lines == b.n_blank_lines
+         and a.n_loc == b.n_loc and a.n_lines == b.n_lines;
+}
+
+/**
+ * @brief Confere os subtotais de `DirRollup` (`--by-dir`) com os mesmos arquivos escritos de formas diferentes.
+ *
+ * @details Cada arquivo de @a files entra quatro vezes: como `corpus/<nome>`, `./corpus/<nome>` e
+ * `corpus/x/../<nome>` (que têm de cair todos no mesmo diretório, abaixo de "."), e como `../corpus/<nome>` (que tem de
+ * ficar no topo, fora de "."). Os caminhos não são abertos: só a árvore de diretórios é conferida.
+ *
+ * @return size_t  Número de divergências (já impressas).
+ */
+size_t verify_rollup(const vec<FileInfo>& files)
+{
+  vec<FileInfo> spelled{};
+  FileInfo sum{};
+  for (const str prefix : { "corpus/", "./corpus/", "corpus/x/../", "../corpus/" })
+  {
+    for (const auto& file : files)
+    {
+      FileInfo copy{ file };
+      copy.m_filename = prefix + file.m_filename;
+      spelled.push_back(std::move(copy));
+    }
+  }
+  for (const auto& file : files)
+  {
+    sum.n_reg_comments += file.n_reg_comments;
+    sum.n_doc_comments += file.n_doc_comments;
+    sum.n_blank_lines += file.n_blank_lines;
+    sum.n_loc += file.n_loc;
+    sum.n_lines += file.n_lines;
+  }
+
+  ResultStore store{};
+  store.append(spelled);
+  const DirRollup rollup{ store };
+  size_t n_mismatches{ 0 };
+  auto check{ [&](str_view path, std::uint64_t copies, bool top) {
+    for (const auto& node : rollup.nodes())
+    {
+      if (node.path != path)
+      {
+        continue;
+      }
+      const ResultStore::Counts& counts{ node.counts };
+      const bool same{ node.n_files == copies * files.size() and counts.n_loc == copies * sum.n_loc
+                       and counts.n_reg_comments == copies * sum.n_reg_comments and counts.n_doc_comments == copies * sum.n_doc_comments
+                       and counts.n_blank_lines == copies * sum.n_blank_lines and counts.n_lines == copies * sum.n_lines
+                       and (not top or node.parent == 0) };
+      if (not same)
+      {
+        ++n_mismatches;
+        std::cout << "rollup " << path << ": expected " << copies * files.size() << " files" << (top ? " at the top" : "")
+                  << ", got " << node.n_files << '\n';
+      }
+      return;
+    }
+    ++n_mismatches;
+    std::cout << "rollup " << path << ": missing directory\n";
+  } };
+  check(".", 3, true);  // [!] Só as três grafias abaixo de "."; `../corpus` não pode entrar aqui.
+  check("corpus", 3, false);
+  check("..", 1, true);
+  check("../corpus", 1, false);
+  return n_mismatches;
+}
+
+/**
+ * @brief Confere as contagens de cada caminho do scanner com as de `expected.csv`.
+ */
+int verify(const std::filesystem::path& root)
+{
+  std::ifstream csv{ root / EXPECTED_FILE };
+  if (not csv)
+  {
+    std::cerr << "Could not read " << (root / EXPECTED_FILE).string() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  const vec<std::pair<str, ScanEngine>> engines{ { "scalar", ScanEngine::SCALAR },
+                                                 { "simd", ScanEngine::SIMD },
+                                                 { "dfa", ScanEngine::DFA } };
+  str line{};
+  std::getline(csv, line);  // [!] Cabeçalho.
+  size_t n_files{ 0 };
+  size_t n_mismatches{ 0 };
+  vec<FileInfo> expected_files{};  //!< Contagens esperadas, para a conferência de `verify_rollup`.
+  while (std::getline(csv, line))
+  {
+    // [!] Os nomes gerados não têm vírgulas: os campos são separados sem tratar aspas.
+    std::istringstream fields{ line };
+    str name{}, language{}, value{};
+    std::getline(fields, name, ',');
+    std::getline(fields, language, ',');
+    FileInfo expected{};
+    for (count_t* counter : { &expected.n_reg_comments, &expected.n_doc_comments, &expected.n_blank_lines, &expected.n_loc,
+                              &expected.n_lines })
+    {
+      std::getline(fields, value, ',');
+      std::uint64_t number{ 0 };
+      if (not parse_number(value, number))
+      {
+        std::cerr << "Malformed line in expected.csv: " << line << '\n';
+        return EXIT_FAILURE;
+      }
+      *counter = static_cast<count_t>(number);
+    }
+
+    expected_files.push_back(expected);
+    expected_files.back().m_filename = name;
+
+    const str path{ (root / name).string() };
+    std::ifstream ifs{ path, std::ios::binary };
+    const str contents{ std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+
+    vec<std::pair<str, FileInfo>> results{};
+    for (const auto& [engine_name, engine] : engines)
+    {
+      FileInfo file{ path };
+      Sloc{ engine }.analyze_contents(contents, file);
+      results.emplace_back(engine_name, file);
+    }
+    {
+      FileInfo file{ path };
+      Sloc{ ScanEngine::DFA, InputMode::STREAM }.analyze_file(file);
+      results.emplace_back("stream", file);
+    }
+    {
+      // [!] Análise especulativa em pedaços pequenos, costurados em ordem.
+      const size_t n_chunks{ std::max(size_t{ 1 }, (contents.size() + VERIFY_CHUNK_SIZE - 1) / VERIFY_CHUNK_SIZE) };
+      vec<SpeculativeScan::Chunk> chunks(n_chunks);
+      for (size_t c{ 0 }; c < n_chunks; ++c)
+      {
+        chunks[c] = SpeculativeScan::scan(SpeculativeScan::chunk_of(contents, c, n_chunks, VERIFY_CHUNK_SIZE));
+      }
+      FileInfo file{ path };
+      SpeculativeScan::stitch(chunks, file);
+      results.emplace_back("split", file);
+    }
+
+    for (const auto& [how, file] : results)
+    {
+      if (not same_counts(file, expected))
+      {
+        ++n_mismatches;
+        std::cout << name << " (" << how << "): expected " << expected.n_reg_comments << '/' << expected.n_doc_comments << '/'
+                  << expected.n_blank_lines << '/' << expected.n_loc << '/' << expected.n_lines << ", got " << file.n_reg_comments
+                  << '/' << file.n_doc_comments << '/' << file.n_blank_lines << '/' << file.n_loc << '/' << file.n_lines << '\n';
+      }
+    }
+    ++n_files;
+  }
+
+  std::cout << n_files << " files verified with scalar, simd, dfa, stream and split: " << n_mismatches << " mismatch(es)\n";
+
+  const size_t n_rollup_mismatches{ verify_rollup(expected_files) };
+  std::cout << "Directory rollup verified with mixed \".\" and \"..\" paths: " << n_rollup_mismatches << " mismatch(es)\n";
+  return n_mismatches == 0 and n_rollup_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Converte um tamanho com sufixo opcional (`k`, `M`, `G`) em @a bytes.
+ *
+ * @return bool  `false` se @a text não for um tamanho válido (ou não couber em `size_t`).
+ */
+bool parse_size(str_view text, size_t& bytes)
+{
+  size_t multiplier{ 1 };
+  switch (text.empty() ? '\0' : text.back())
+  {
+  case 'k': case 'K': multiplier = 1024; break;
+  case 'm': case 'M': multiplier = 1024 * 1024; break;
+  case 'g': case 'G': multiplier = 1024 * 1024 * 1024; break;
+  default: break;
+  }
+  size_t number{ 0 };
+  if (not parse_number(multiplier == 1 ? text : text.substr(0, text.size() - 1), number) or number > SIZE_MAX / multiplier)
+  {
+    return false;
+  }
+  bytes = number * multiplier;
+  return true;
+}
+
+/**
+ * @brief Escreve em @a os as opções do `sloc_corpus`.
+ */
+void usage(std::ostream& os)
+{
+  os << "Usage: sloc_corpus <dir> [--seed N] [--size BYTES] [--depth D] [--fan-out F] [--median-size BYTES]\n"
+        "                   [--mix code=W,comments=W,literals=W] [--no-pathological]\n"
+        "         --size covers every file, pathological ones included (those that do not fit are skipped)\n"
+        "       sloc_corpus --verify <dir>\n"
+        "       sloc_corpus -h | --help\n";
+}
+
+/**
+ * @brief Informa em `std::cerr` que @a arg é inválido (@a reason) e mostra as opções.
+ *
+ * @return int  `EXIT_FAILURE`, para ser retornado por `main`.
+ */
+int invalid(const str& arg, str_view reason)
+{
+  std::cerr << arg << ": " << reason << "\n\n";
+  usage(std::cerr);
+  return EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+  CorpusOptions options{};
+  str root{};
+  bool verify_only{ false };
+
+  for (int i{ 1 }; i < argc; ++i)
+  {
+    const str arg{ argv[i] };
+    const bool has_value{ i + 1 < argc };
+    const str_view value{ has_value ? argv[i + 1] : "" };
+    if (arg == "-h" or arg == "--help")
+    {
+      usage(std::cout);
+      return EXIT_SUCCESS;
+    }
+    else if (arg == "--verify")
+    {
+      verify_only = true;
+    }
+    else if (arg == "--seed" and has_value)
+    {
+      if (not parse_number(value, options.seed))
+      {
+        return invalid(arg, "expected a non-negative integer");
+      }
+      ++i;
+    }
+    else if (arg == "--size" and has_value)
+    {
+      if (not parse_size(value, options.size))
+      {
+        return invalid(arg, "expected a size in bytes (optionally with a k, M or G suffix)");
+      }
+      ++i;
+    }
+    else if (arg == "--depth" and has_value)
+    {
+      if (not parse_number(value, options.depth))
+      {
+        return invalid(arg, "expected a non-negative integer");
+      }
+      ++i;
+    }
+    else if (arg == "--fan-out" and has_value)
+    {
+      if (not parse_number(value, options.fan_out))
+      {
+        return invalid(arg, "expected a non-negative integer");
+      }
+      options.fan_out = std::max(size_t{ 1 }, options.fan_out);
+      ++i;
+    }
+    else if (arg == "--median-size" and has_value)
+    {
+      if (not parse_size(value, options.median_size))
+      {
+        return invalid(arg, "expected a size in bytes (optionally with a k, M or G suffix)");
+      }
+      options.median_size = std::max(size_t{ 64 }, options.median_size);
+      ++i;
+    }
+    else if (arg == "--mix" and has_value)
+    {
+      // [!] `code=W,comments=W,literals=W` (os pesos omitidos ficam zerados).
+      options.mix = { 0, 0, 0 };
+      std::istringstream items{ argv[++i] };
+      str item{};
+      while (std::getline(items, item, ','))
+      {
+        const size_t equals{ item.find('=') };
+        const str key{ item.substr(0, equals) };
+        const size_t slot{ key == "code" ? 0U : key == "comments" ? 1U : key == "literals" ? 2U : 3U };
+        if (slot == 3 or equals == str::npos or not parse_number(str_view{ item }.substr(equals + 1), options.mix[slot]))
+        {
+          return invalid(arg, "expected code=W,comments=W,literals=W, got \"" + item + '"');
+        }
+      }
+      if (options.mix[0] + options.mix[1] + options.mix[2] == 0)
+      {
+        return invalid(arg, "needs at least one positive weight");
+      }
+    }
+    else if (arg == "--no-pathological")
+    {
+      options.pathological = false;
+    }
+    else if (not arg.empty() and arg[0] != '-' and root.empty())
+    {
+      root = arg;
+    }
+    else
+    {
+      return invalid(arg, "unknown option or missing value");
+    }
+  }
+
+  if (root.empty())
+  {
+    usage(std::cerr);
+    return EXIT_FAILURE;
+  }
+
+  return verify_only ? verify(root) : generate(root, options);
+}
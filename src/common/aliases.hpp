@@ -24,6 +24,7 @@
 #include <vector>         // `std::vector`
 #include <string_view>    // `std::string_view`
 #include <unordered_map>  // `std::unordered_map`
+#include <unordered_set>  // `std::unordered_set`
 // }}}
 
 // Aliases {{{
@@ -55,8 +56,12 @@ template <typename Type>
 using list = std::list<Type>;
 
 /// @brief Alias com template para `std::unordered_map`.
-template <typename Key, typename Type>
-using umap = std::unordered_map<Key, Type>;
+template <typename Key, typename Type, typename Hash = std::hash<Key>>
+using umap = std::unordered_map<Key, Type, Hash>;
+
+/// @brief Alias com template para `std::unordered_set`.
+template <typename Key, typename Hash = std::hash<Key>>
+using uset = std::unordered_set<Key, Hash>;
 
 /// @brief Alias com template para `std::vector`.
 template <typename Type>
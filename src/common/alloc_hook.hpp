@@ -0,0 +1,123 @@
+/**
+ * @file alloc_hook.hpp
+ *
+ * @brief Fornece um contador global de alocações no heap.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef ALLOC_HOOK_HPP
+#define ALLOC_HOOK_HPP
+
+// STL includes {{{
+#include <atomic>   // `std::atomic`
+#include <cstdint>  // `std::uint64_t`
+// }}}
+
+/**
+ * @brief Contador de alocações no heap (chamadas a `operator new`).
+ *
+ * @details O contador só é incrementado quando o executável substitui os operadores globais `new`/`delete`, o que é
+ * feito definindo `SLOC_ALLOC_HOOK_IMPLEMENTATION` antes de incluir este cabeçalho em **uma única** unidade de
+ * tradução. Sem a substituição, `count()` sempre retorna zero e `enabled()` retorna `false`.
+ *
+ * O custo é um incremento atômico relaxado por alocação, então o gancho pode ficar ligado em produção. Para medir as
+ * alocações de um trecho de código, basta comparar `count()` antes e depois dele.
+ */
+class AllocHook
+{
+private:
+  static inline std::atomic<std::uint64_t> s_count{ 0 };  //!< Total de alocações desde o início do programa.
+  static inline std::atomic<bool> s_enabled{ false };     //!< Indica se os operadores globais foram substituídos.
+
+public:
+  /**
+   * @brief Registra uma alocação. Chamado pelos operadores `new` substituídos.
+   */
+  static void record()
+  {
+    s_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Marca que os operadores globais foram substituídos e o contador é confiável.
+   */
+  static void enable() { s_enabled.store(true, std::memory_order_relaxed); }
+
+  /**
+   * @brief Retorna se o contador está ativo neste executável.
+   */
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Retorna o total de alocações feitas até o momento (em todas as threads).
+   */
+  static std::uint64_t count() { return s_count.load(std::memory_order_relaxed); }
+};
+
+#endif  //!< ALLOC_HOOK_HPP
+
+#if defined(SLOC_ALLOC_HOOK_IMPLEMENTATION) and not defined(SLOC_ALLOC_HOOK_IMPLEMENTED)
+# define SLOC_ALLOC_HOOK_IMPLEMENTED
+
+// STL includes {{{
+# include <cstddef>  // `std::max_align_t`
+# include <cstdlib>  // `std::malloc`, `std::aligned_alloc`, `std::free`
+# include <new>      // `std::bad_alloc`, `std::align_val_t`, `std::get_new_handler`
+// }}}
+
+namespace alloc_hook_detail
+{
+/**
+ * @brief Aloca @a size bytes com `malloc`, respeitando o `new_handler` como o `operator new` padrão.
+ */
+inline void* allocate(std::size_t size, std::size_t alignment)
+{
+  AllocHook::record();
+
+  if (size == 0)
+  {
+    size = 1;  // [!] `new` de tamanho zero deve retornar um ponteiro válido e único.
+  }
+
+  while (true)
+  {
+    // [!] `aligned_alloc` exige que o tamanho seja múltiplo do alinhamento.
+    void* pointer{ alignment <= alignof(std::max_align_t) ? std::malloc(size)
+                                                          : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) };
+    if (pointer != nullptr)
+    {
+      return pointer;
+    }
+
+    std::new_handler handler{ std::get_new_handler() };
+    if (handler == nullptr)
+    {
+      throw std::bad_alloc{};
+    }
+    handler();
+  }
+}
+}  // namespace alloc_hook_detail
+
+/* [!]
+ * As versões de array e `nothrow` da biblioteca padrão delegam para estas, então substituí-las é suficiente para contar
+ * todas as alocações.
+ */
+void* operator new(std::size_t size) { return alloc_hook_detail::allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return alloc_hook_detail::allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t /*alignment*/) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t /*size*/) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept { std::free(pointer); }
+
+/// @brief Liga o contador antes de `main` (a substituição dos operadores já vale desde o início do programa).
+inline const bool ALLOC_HOOK_ENABLED{ (AllocHook::enable(), true) };
+
+#endif  //!< SLOC_ALLOC_HOOK_IMPLEMENTATION
@@ -15,9 +15,67 @@
 #ifndef CONSTANTS_HPP
 #define CONSTANTS_HPP
 
-#include "aliases.hpp" // `str`
+#include <cstdint>  // `std::int64_t`
+
+#include "aliases.hpp" // `str_view`
 
 /// @brief Conjunto de caracteres considerados espaços em branco.
-inline const str WHITESPACE{ " \t\n\r\f\v" };
+inline constexpr str_view WHITESPACE{ " \t\n\r\f\v" };
+
+/// @brief Tamanho (em bytes) de uma linha de cache, usado para evitar *false sharing* entre threads.
+inline constexpr size_t CACHE_LINE_SIZE{ 64 };
+
+/// @brief Tamanho mínimo (em bytes) para que um arquivo seja mapeado em memória em vez de lido com `pread`.
+inline constexpr size_t MMAP_MIN_SIZE{ 64 * 1024 };
+
+/// @brief Tamanho (em bytes) de cada bloco lido no modo de leitura em fluxo (`--stream` e entrada padrão).
+inline constexpr size_t STREAM_CHUNK_SIZE{ 256 * 1024 };
+
+/// @brief Tamanho mínimo padrão (em bytes) para que um arquivo seja dividido em pedaços analisados em paralelo.
+inline constexpr size_t SPLIT_MIN_SIZE{ 64 * 1024 * 1024 };
+
+/// @brief Tamanho nominal (em bytes) de cada pedaço de um arquivo dividido.
+inline constexpr size_t SPLIT_CHUNK_SIZE{ 8 * 1024 * 1024 };
+
+/// @brief Capacidade padrão (em arquivos) de cada fila entre os estágios do *pipeline* (`--queue-depth`).
+inline constexpr size_t PIPELINE_QUEUE_DEPTH{ 1024 };
+
+/// @brief Número de linhas a partir do qual a ordenação por nome é feita em paralelo (com mais de uma thread).
+inline constexpr size_t PARALLEL_SORT_MIN_ROWS{ 128 * 1024 };
+
+/// @brief Número de linhas a partir do qual a soma por diretório (`--by-dir`) é dividida entre threads.
+inline constexpr size_t ROLLUP_PARALLEL_MIN_ROWS{ 128 * 1024 };
+
+/// @brief Largura padrão (em caracteres) da coluna de nomes na saída contínua (`--stream-output`).
+inline constexpr size_t STREAM_NAME_WIDTH{ 60 };
+
+/// @brief Tamanho (em bytes) do buffer de saída dos resultados, escrito com uma única chamada de `write` quando cheio.
+inline constexpr size_t OUTPUT_BUFFER_SIZE{ 1024 * 1024 };
+
+/// @brief Tamanho (em bytes) abaixo do qual um arquivo não tem eventos próprios no trace (`--trace`): entra num lote.
+inline constexpr size_t TRACE_SMALL_FILE_SIZE{ 64 * 1024 };
+
+/// @brief Número máximo de arquivos pequenos somados num único evento de lote do trace.
+inline constexpr size_t TRACE_BATCH_MAX_FILES{ 1024 };
+
+/// @brief Intervalo (em nanossegundos) sem arquivos pequenos que encerra um lote do trace, para as esperas aparecerem.
+inline constexpr std::int64_t TRACE_BATCH_GAP_NS{ 100'000 };
+
+/// @brief Duração mínima (em nanossegundos) de uma espera numa fila para que ela apareça no trace.
+inline constexpr std::int64_t TRACE_MIN_WAIT_NS{ 100'000 };
+
+/// @brief Subdiretório de `$XDG_CACHE_HOME` (ou de `~/.cache`) com os caches de resultados, um por conjunto de raízes.
+inline constexpr str_view CACHE_DIR_NAME{ "sloc" };
+
+/**
+ * @brief Margem (em nanossegundos) antes do início da execução dentro da qual um arquivo modificado não entra no cache.
+ *
+ * @details Cobre a granularidade do mtime dos sistemas de arquivos (um *jiffy* em muitos, 1 s no ext3 e no HFS+): o
+ * arquivo ainda pode mudar sem que o mtime mude.
+ */
+inline constexpr std::int64_t CACHE_RACY_MARGIN_NS{ 1'000'000'000 };
+
+/// @brief Nome de entrada que representa a entrada padrão (`sloc -`).
+inline constexpr str_view STDIN_SOURCE{ "-" };
 
 #endif  //!< CONSTANTS_HPP
@@ -15,7 +15,7 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
-#include "aliases.hpp"    // `str`
+#include "aliases.hpp"    // `str_view`
 #include "constants.hpp"  // `WHITESPACE`
 
 /**
@@ -23,9 +23,9 @@
  *
  * @param input A string a ser processada.
  *
- * @return Uma nova string com os espaços em branco removidos à esquerda.
+ * @return Uma visão de @a input sem os espaços em branco à esquerda (não aloca nem copia).
  */
-inline str ltrim(const str& input)
+inline str_view ltrim(str_view input)
 {
   // [!] Encontra o índice do primeiro caractere que não seja espaço em branco, começando do início da string.
   const auto start{ input.find_first_not_of(WHITESPACE) };
@@ -34,7 +34,7 @@ inline str ltrim(const str& input)
    * Se não encontrar nenhum caractere não-espaço (string toda é espaço), retorna uma string vazia.
    * Caso contrário, retorna a substring começando do primeiro caractere não-espaço.
    */
-  return (start == str::npos) ? "" : input.substr(start);
+  return (start == str_view::npos) ? str_view{} : input.substr(start);
 }
 
 /**
@@ -42,9 +42,9 @@ inline str ltrim(const str& input)
  *
  * @param input A string a ser processada.
  *
- * @return Uma nova string com os espaços em branco removidos à direita.
+ * @return Uma visão de @a input sem os espaços em branco à direita (não aloca nem copia).
  */
-inline str rtrim(const str& input)
+inline str_view rtrim(str_view input)
 {
   // [!] Encontra o índice do último caractere que não seja espaço em branco, começando do início da string.
   const auto end{ input.find_last_not_of(WHITESPACE) };
@@ -53,7 +53,7 @@ inline str rtrim(const str& input)
    * Se não encontrar nenhum caractere não-espaço (string toda é espaço), retorna uma string vazia.
    * Caso contrário, retorna a substring começando do primeiro caractere não-espaço.
    */
-  return (end == str::npos) ? "" : input.substr(0, end + 1);
+  return (end == str_view::npos) ? str_view{} : input.substr(0, end + 1);
 }
 
 /**
@@ -61,10 +61,10 @@ inline str rtrim(const str& input)
  *
  * @param input A string a ser processada.
  *
- * @return Uma nova string com os espaços em branco removidos de ambos os lados.
+ * @return Uma visão de @a input sem os espaços em branco de ambos os lados (não aloca nem copia).
  *
  * @note Aplica `ltrim`, depois `rtrim` sobre @a input.
  */
-inline str trim(const str& input) { return rtrim(ltrim(input)); }
+inline str_view trim(str_view input) { return rtrim(ltrim(input)); }
 
 #endif  //!< UTILS_HPP
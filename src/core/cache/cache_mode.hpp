@@ -0,0 +1,30 @@
+/**
+ * @file cache_mode.hpp
+ *
+ * @brief Define o enum CacheMode, que escolhe como o cache de resultados (`ResultCache`) é usado.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef CACHE_MODE_HPP
+#define CACHE_MODE_HPP
+
+#include "../common/aliases.hpp"  // `byte`
+
+/**
+ * @brief Uso do cache de resultados.
+ */
+enum class CacheMode : byte
+{
+  USE,      //!< Lê o cache, reaproveita os arquivos inalterados e grava o cache atualizado (padrão).
+  OFF,      //!< Não lê nem grava o cache (`--no-cache`).
+  REBUILD,  //!< Ignora o cache existente, analisa tudo e grava um cache novo (`--rebuild-cache`).
+};
+
+#endif  //!< CACHE_MODE_HPP
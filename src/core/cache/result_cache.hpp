@@ -0,0 +1,461 @@
+/**
+ * @file result_cache.hpp
+ *
+ * @brief Define a classe ResultCache, um cache persistente das contagens de cada arquivo entre execuções.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+// POSIX includes {{{
+#include <fcntl.h>     // `open`
+#include <sys/mman.h>  // `mmap`, `munmap`
+#include <sys/stat.h>  // `fstat`, `stat`
+#include <unistd.h>    // `write`, `fsync`, `close`, `unlink`, `getpid`
+// }}}
+
+// STL includes {{{
+#include <algorithm>   // `std::sort`, `std::lower_bound`
+#include <atomic>      // `std::atomic`
+#include <cerrno>      // `errno`
+#include <cstdint>     // `std::uint32_t`, `std::uint64_t`, `std::int64_t`
+#include <cstdio>      // `std::rename`
+#include <cstdlib>     // `std::getenv`
+#include <cstring>     // `std::memcmp`, `std::memcpy`
+#include <filesystem>  // `std::filesystem::weakly_canonical`, `std::filesystem::create_directories`
+#include <iomanip>     // `std::setw`, `std::setfill`
+#include <sstream>     // `std::ostringstream`
+// }}}
+
+#include "../common/aliases.hpp"             // `str`, `str_view`, `vec`, `uset`, `size_t`
+#include "../common/constants.hpp"           // `STDIN_SOURCE`, `CACHE_RACY_MARGIN_NS`, `CACHE_DIR_NAME`
+#include "../core/filter/file_identity.hpp"  // `mtime_ns_of`
+#include "../core/sloc/file_info.hpp"        // `FileInfo`
+#include "../core/sloc/result_store.hpp"     // `ResultStore`
+
+/**
+ * @brief Cache em disco das contagens de cada arquivo, indexado por caminho e validado por (tamanho, mtime, inode).
+ *
+ * @details O arquivo tem um layout binário fixo, feito para ser mapeado em memória e usado sem nenhuma conversão:
+ *   - `Header`: assinatura, versão, marca de ordem dos bytes, tamanho de cada entrada e quantidades;
+ *   - `Entry[n_entries]`: uma entrada por arquivo, ordenadas por (hash do caminho, caminho);
+ *   - os caminhos, concatenados, referenciados por (deslocamento, comprimento) em cada entrada.
+ * Carregar o cache é apenas um `mmap` e a validação do cabeçalho; cada consulta é uma busca binária sobre as entradas
+ * mapeadas, então o custo não depende do tamanho do cache e as consultas podem ser feitas por várias threads.
+ *
+ * Cada conjunto de raízes analisadas (a partir de cada diretório atual) tem o seu arquivo de cache, em
+ * `$XDG_CACHE_HOME/sloc` (ou `~/.cache/sloc`; veja `default_path`): nada é gravado nas árvores analisadas nem no diretório
+ * atual, e as entradas de árvores diferentes não se misturam.
+ *
+ * Uma entrada só vale se o tamanho, o instante de modificação (em nanossegundos) e o inode do arquivo forem os mesmos
+ * da descoberta atual; caso contrário o arquivo é analisado de novo. A gravação cria um arquivo temporário e o renomeia
+ * por cima do anterior (`rename` é atômico), então uma execução interrompida ou concorrente nunca deixa um cache
+ * corrompido. Um cache de outra versão, de outra arquitetura ou truncado é simplesmente ignorado.
+ *
+ * `VERSION` deve mudar sempre que o layout ou as regras de contagem mudarem.
+ */
+class ResultCache
+{
+public:
+  static constexpr std::uint32_t VERSION{ 1 };  //!< Versão do layout (e das regras de contagem).
+
+private:
+  static constexpr char MAGIC[8]{ 'S', 'L', 'O', 'C', 'C', 'A', 'C', 'H' };  //!< Assinatura do arquivo.
+  static constexpr std::uint32_t ENDIAN_MARK{ 0x01020304 };                  //!< Lida invertida em outra arquitetura.
+
+  /**
+   * @brief Cabeçalho do arquivo de cache.
+   */
+  struct Header
+  {
+    char magic[8];             //!< `MAGIC`.
+    std::uint32_t version;     //!< `VERSION`.
+    std::uint32_t byte_order;  //!< `ENDIAN_MARK`.
+    std::uint32_t entry_size;  //!< `sizeof(Entry)`.
+    std::uint32_t reserved;    //!< Sempre 0.
+    std::uint64_t n_entries;   //!< Quantidade de entradas.
+    std::uint64_t paths_size;  //!< Tamanho da área de caminhos, em bytes.
+  };
+
+  /**
+   * @brief Contagens de um arquivo e a versão do arquivo a que elas se referem.
+   */
+  struct Entry
+  {
+    std::uint64_t path_hash;       //!< Hash do caminho (chave primária da ordenação).
+    std::uint64_t path_offset;     //!< Início do caminho na área de caminhos.
+    std::uint64_t path_length;     //!< Comprimento do caminho.
+    std::uint64_t size;            //!< Tamanho do arquivo.
+    std::int64_t mtime_ns;         //!< Instante da última modificação.
+    std::uint64_t inode;           //!< Inode.
+    std::uint64_t n_loc;           //!< Linhas de código.
+    std::uint64_t n_reg_comments;  //!< Linhas de comentário regular.
+    std::uint64_t n_doc_comments;  //!< Linhas de comentário de documentação.
+    std::uint64_t n_blank_lines;   //!< Linhas em branco.
+    std::uint64_t n_lines;         //!< Total de linhas.
+  };
+
+  static_assert(sizeof(Header) == 40 and sizeof(Entry) == 88, "o layout do cache não pode depender do compilador");
+
+  void* m_mapping{ nullptr };                  //!< Arquivo de cache mapeado (ou `nullptr`).
+  size_t m_mapping_size{ 0 };                  //!< Tamanho do mapeamento.
+  const Entry* m_entries{ nullptr };           //!< Entradas mapeadas.
+  size_t m_n_entries{ 0 };                     //!< Quantidade de entradas.
+  const char* m_paths{ nullptr };              //!< Área de caminhos mapeada.
+  size_t m_paths_size{ 0 };                    //!< Tamanho da área de caminhos.
+  mutable std::atomic<size_t> m_hits{ 0 };     //!< Consultas atendidas pelo cache.
+  mutable std::atomic<size_t> m_lookups{ 0 };  //!< Consultas feitas.
+
+  /**
+   * @brief Hash FNV-1a de 64 bits do caminho.
+   */
+  static std::uint64_t hash_path(str_view path)
+  {
+    std::uint64_t hash{ 0xCBF29CE484222325ULL };
+    for (const char c : path)
+    {
+      hash = (hash ^ static_cast<byte>(c)) * 0x100000001B3ULL;
+    }
+    return hash;
+  }
+
+  /**
+   * @brief Retorna o caminho de @a entry (vazio se a entrada aponta para fora da área de caminhos).
+   */
+  str_view path_of(const Entry& entry) const
+  {
+    if (entry.path_offset > m_paths_size or entry.path_length > m_paths_size - entry.path_offset)
+    {
+      return {};
+    }
+    return str_view{ m_paths + entry.path_offset, static_cast<size_t>(entry.path_length) };
+  }
+
+  /**
+   * @brief Procura a entrada de @a path (ou `nullptr`).
+   */
+  const Entry* find(str_view path) const
+  {
+    const std::uint64_t hash{ hash_path(path) };
+    const Entry* end{ m_entries + m_n_entries };
+    const Entry* entry{ std::lower_bound(m_entries, end, hash, [](const Entry& e, std::uint64_t h) { return e.path_hash < h; }) };
+    for (; entry != end and entry->path_hash == hash; ++entry)
+    {
+      if (path_of(*entry) == path)
+      {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Indica se as contagens da linha @a row de @a results podem ser guardadas.
+   *
+   * @details A entrada padrão não tem identidade; um arquivo sem `stat` não tem como ser validado depois; e um arquivo
+   * não vazio sem nenhuma linha não pôde ser lido. Um arquivo modificado menos de `CACHE_RACY_MARGIN_NS` antes de
+   * @a started_ns (o início da execução), ou depois dele, também fica de fora (a regra *racy clean* do git): o mtime
+   * tem a granularidade do sistema de arquivos, então o arquivo pode mudar de novo, com o mesmo tamanho, sem que o mtime
+   * mude.
+   */
+  static bool cacheable(const ResultStore& results, size_t row, std::int64_t started_ns)
+  {
+    return results.path(row) != STDIN_SOURCE and results.mtime_ns(row) != 0 and results.mtime_ns(row) < started_ns - CACHE_RACY_MARGIN_NS
+           and (results.count(row, ResultStore::Counter::LINES) > 0 or results.file_size(row) == 0);
+  }
+
+  /**
+   * @brief Indica se o arquivo de @a entry (de caminho @a path) ainda existe e não mudou desde a gravação da entrada.
+   */
+  static bool still_valid(const Entry& entry, str_view path)
+  {
+    struct stat info{};
+    return ::stat(str{ path }.c_str(), &info) == 0 and S_ISREG(info.st_mode)
+           and static_cast<std::uint64_t>(info.st_size) == entry.size and mtime_ns_of(info) == entry.mtime_ns
+           and static_cast<std::uint64_t>(info.st_ino) == entry.inode;
+  }
+
+  /**
+   * @brief Escreve @a size bytes de @a data em @a fd, repetindo escritas parciais.
+   */
+  static bool write_all(int fd, const void* data, size_t size)
+  {
+    const char* cursor{ static_cast<const char*>(data) };
+    while (size > 0)
+    {
+      const ssize_t written{ ::write(fd, cursor, size) };
+      if (written < 0 and errno == EINTR)
+      {
+        continue;
+      }
+      if (written <= 0)
+      {
+        return false;
+      }
+      cursor += written;
+      size -= static_cast<size_t>(written);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Desfaz o mapeamento atual.
+   */
+  void unload()
+  {
+    if (m_mapping != nullptr)
+    {
+      ::munmap(m_mapping, m_mapping_size);
+    }
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+    m_entries = nullptr;
+    m_n_entries = 0;
+    m_paths = nullptr;
+    m_paths_size = 0;
+  }
+
+public:
+  ResultCache() = default;
+  ResultCache(const ResultCache&) = delete;
+  ResultCache& operator=(const ResultCache&) = delete;
+  ~ResultCache() { unload(); }
+
+  /**
+   * @brief Retorna o caminho do cache das entradas @a inputs, analisadas a partir do diretório atual (ou vazio se não
+   * houver diretório de cache: sem `$XDG_CACHE_HOME` nem `$HOME`).
+   *
+   * @details O nome do arquivo é o hash do diretório atual e das formas canônicas das entradas, em ordem: os caminhos
+   * guardados são os da descoberta (relativos ao diretório atual), então só valem para o mesmo par. O diretório é
+   * criado se ainda não existir.
+   */
+  static str default_path(const vec<str>& inputs)
+  {
+    namespace fs = std::filesystem;
+    const char* xdg_cache{ std::getenv("XDG_CACHE_HOME") };
+    const char* home{ std::getenv("HOME") };
+    fs::path directory{};
+    if (xdg_cache != nullptr and xdg_cache[0] == '/')  // [!] A especificação manda ignorar caminhos relativos.
+    {
+      directory = fs::path{ xdg_cache } / CACHE_DIR_NAME;
+    }
+    else if (home != nullptr and home[0] != '\0')
+    {
+      directory = fs::path{ home } / ".cache" / CACHE_DIR_NAME;
+    }
+    else
+    {
+      return {};
+    }
+
+    std::error_code error{};
+    vec<str> roots{};
+    for (const auto& input : inputs)
+    {
+      const fs::path canonical{ fs::weakly_canonical(input, error) };
+      roots.push_back(error ? input : canonical.string());
+    }
+    std::sort(roots.begin(), roots.end());
+    str key{ fs::current_path(error).string() };
+    for (const auto& root : roots)
+    {
+      key += '\0' + root;
+    }
+
+    fs::create_directories(directory, error);
+    std::ostringstream name{};
+    name << std::hex << std::setw(16) << std::setfill('0') << hash_path(key) << ".cache";
+    return (directory / name.str()).string();
+  }
+
+  /**
+   * @brief Mapeia o cache gravado em @a path.
+   *
+   * @return bool  `true` se o cache foi carregado; `false` se ele não existe ou é inválido (e então fica vazio).
+   */
+  bool load(const str& path)
+  {
+    unload();
+
+    const int fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (fd < 0)
+    {
+      return false;
+    }
+
+    struct stat info{};
+    const bool has_size{ ::fstat(fd, &info) == 0 and static_cast<size_t>(info.st_size) >= sizeof(Header) };
+    if (has_size)
+    {
+      m_mapping_size = static_cast<size_t>(info.st_size);
+      m_mapping = ::mmap(nullptr, m_mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      m_mapping = m_mapping == MAP_FAILED ? nullptr : m_mapping;
+    }
+    ::close(fd);  // [!] O mapeamento continua válido depois de fechar o descritor.
+    if (m_mapping == nullptr)
+    {
+      m_mapping_size = 0;
+      return false;
+    }
+
+    Header header{};
+    std::memcpy(&header, m_mapping, sizeof(Header));
+    const size_t available{ m_mapping_size - sizeof(Header) };
+    const bool valid{ std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 and header.version == VERSION
+                      and header.byte_order == ENDIAN_MARK and header.entry_size == sizeof(Entry)
+                      and header.n_entries <= available / sizeof(Entry)
+                      and header.paths_size == available - header.n_entries * sizeof(Entry) };
+    if (not valid)
+    {
+      unload();
+      return false;
+    }
+
+    const char* base{ static_cast<const char*>(m_mapping) };
+    m_entries = reinterpret_cast<const Entry*>(base + sizeof(Header));
+    m_n_entries = static_cast<size_t>(header.n_entries);
+    m_paths = base + sizeof(Header) + m_n_entries * sizeof(Entry);
+    m_paths_size = static_cast<size_t>(header.paths_size);
+    return true;
+  }
+
+  /**
+   * @brief Preenche as contagens de @a file a partir do cache, se ele tiver uma entrada válida para o arquivo.
+   *
+   * @details Pode ser chamada por várias threads ao mesmo tempo.
+   *
+   * @return bool  `true` se o arquivo não mudou desde a gravação do cache (e não precisa ser analisado).
+   */
+  bool lookup(FileInfo& file) const
+  {
+    m_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (m_n_entries == 0 or file.m_mtime_ns == 0 or file.m_filename == STDIN_SOURCE)
+    {
+      return false;
+    }
+
+    const Entry* entry{ find(file.m_filename) };
+    if (entry == nullptr or entry->size != file.m_size or entry->mtime_ns != file.m_mtime_ns or entry->inode != file.m_inode)
+    {
+      return false;
+    }
+
+    file.n_loc = static_cast<count_t>(entry->n_loc);
+    file.n_reg_comments = static_cast<count_t>(entry->n_reg_comments);
+    file.n_doc_comments = static_cast<count_t>(entry->n_doc_comments);
+    file.n_blank_lines = static_cast<count_t>(entry->n_blank_lines);
+    file.n_lines = static_cast<count_t>(entry->n_lines);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Grava em @a path o cache atualizado: as contagens de @a results mais as entradas antigas de arquivos que não
+   * fizeram parte desta execução.
+   *
+   * @details Uma entrada antiga só é mantida se o arquivo dela ainda existir com o mesmo tamanho, mtime e inode (um
+   * `stat` por entrada mantida); as de arquivos apagados, renomeados ou modificados desde então nunca mais seriam
+   * aproveitadas e são descartadas. Assim o cache nunca passa do número de arquivos que existem e já foram analisados.
+   *
+   * @param path        Caminho do cache (substituído de forma atômica).
+   * @param results     Arquivos analisados nesta execução.
+   * @param started_ns  Início da execução (relógio de parede, em nanossegundos desde a época).
+   *
+   * @return bool  `true` se o cache foi gravado.
+   */
+  bool store(const str& path, const ResultStore& results, std::int64_t started_ns) const
+  {
+    vec<Entry> entries{};
+    str paths{};
+    entries.reserve(results.size() + m_n_entries);
+
+    uset<str_view> current{};  //!< Caminhos desta execução: as entradas antigas deles são descartadas.
+    current.reserve(results.size());
+    for (size_t row{ 0 }; row < results.size(); ++row)
+    {
+      const str_view file{ results.path(row) };
+      current.insert(file);
+      if (not cacheable(results, row, started_ns))
+      {
+        continue;
+      }
+      const ResultStore::Counts counts{ results.counts(row) };
+      entries.push_back({ hash_path(file), paths.size(), file.size(), results.file_size(row), results.mtime_ns(row),
+                          results.inode(row), counts.n_loc, counts.n_reg_comments, counts.n_doc_comments, counts.n_blank_lines,
+                          counts.n_lines });
+      paths += file;
+    }
+
+    for (size_t e{ 0 }; e < m_n_entries; ++e)
+    {
+      const str_view old_path{ path_of(m_entries[e]) };
+      if (old_path.empty() or current.count(old_path) > 0 or not still_valid(m_entries[e], old_path))
+      {
+        continue;
+      }
+      Entry entry{ m_entries[e] };
+      entry.path_offset = paths.size();
+      paths += old_path;
+      entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [&paths](const Entry& a, const Entry& b) {
+      if (a.path_hash != b.path_hash)
+      {
+        return a.path_hash < b.path_hash;
+      }
+      return str_view{ paths }.substr(a.path_offset, a.path_length) < str_view{ paths }.substr(b.path_offset, b.path_length);
+    });
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = ENDIAN_MARK;
+    header.entry_size = sizeof(Entry);
+    header.n_entries = entries.size();
+    header.paths_size = paths.size();
+
+    // [!] Grava num arquivo temporário ao lado do cache e o renomeia por cima dele: leitores veem o cache antigo ou o
+    // novo, nunca um arquivo pela metade.
+    const str temporary{ path + ".tmp." + std::to_string(::getpid()) };
+    const int fd{ ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (fd < 0)
+    {
+      return false;
+    }
+    const bool written{ write_all(fd, &header, sizeof(header)) and write_all(fd, entries.data(), entries.size() * sizeof(Entry))
+                        and write_all(fd, paths.data(), paths.size()) and ::fsync(fd) == 0 };
+    const bool closed{ ::close(fd) == 0 };
+    if (not written or not closed or std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Indica se um cache de uma execução anterior foi carregado (com `load`).
+   */
+  bool loaded() const { return m_mapping != nullptr; }
+
+  /**
+   * @brief Retorna quantas consultas foram atendidas pelo cache.
+   */
+  size_t n_hits() const { return m_hits.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Retorna quantas consultas foram feitas.
+   */
+  size_t n_lookups() const { return m_lookups.load(std::memory_order_relaxed); }
+};
+
+#endif  //!< RESULT_CACHE_HPP
@@ -0,0 +1,173 @@
+/**
+ * @file content_hash.hpp
+ *
+ * @brief Define a estrutura Hash128 e a classe ContentHash, um hash não criptográfico de 128 bits do conteúdo.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-04
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef CONTENT_HASH_HPP
+#define CONTENT_HASH_HPP
+
+// STL includes {{{
+#include <cstdint>  // `std::uint64_t`
+#include <cstring>  // `std::memcpy`
+// }}}
+
+#include "../common/aliases.hpp"  // `str`, `str_view`, `size_t`
+
+/**
+ * @brief Hash de 128 bits.
+ */
+struct Hash128
+{
+  std::uint64_t low{ 0 };   //!< Metade inferior.
+  std::uint64_t high{ 0 };  //!< Metade superior.
+
+  bool operator==(const Hash128& other) const { return low == other.low and high == other.high; }
+
+  /**
+   * @brief Retorna o hash em hexadecimal (32 dígitos).
+   */
+  str to_hex() const
+  {
+    static constexpr char DIGITS[]{ "0123456789abcdef" };
+    str hex(32, '0');
+    for (size_t i{ 0 }; i < 16; ++i)
+    {
+      hex[15 - i] = DIGITS[(high >> (4 * i)) & 0xF];
+      hex[31 - i] = DIGITS[(low >> (4 * i)) & 0xF];
+    }
+    return hex;
+  }
+};
+
+/**
+ * @brief Função de hash de `Hash128` (os bits já são bem distribuídos: basta uma das metades).
+ */
+struct Hash128Hash
+{
+  size_t operator()(const Hash128& hash) const { return static_cast<size_t>(hash.low); }
+};
+
+/**
+ * @brief MurmurHash3 (variante x64, 128 bits), de Austin Appleby (domínio público).
+ *
+ * @details Processa 16 bytes por iteração com multiplicações e rotações de 64 bits, na casa de vários GB/s por
+ * núcleo, bem acima da velocidade de leitura dos arquivos. Não é criptográfico: serve para encontrar conteúdos
+ * idênticos, não para resistir a colisões fabricadas. Com 128 bits, uma colisão acidental entre arquivos diferentes
+ * (do mesmo tamanho, que é comparado à parte) é desprezível.
+ */
+class ContentHash
+{
+private:
+  static constexpr std::uint64_t C1{ 0x87C37B91114253D5ULL };
+  static constexpr std::uint64_t C2{ 0x4CF5AD432745937FULL };
+
+  static std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+  /**
+   * @brief Mistura final, que espalha cada bit de entrada por todos os bits de saída.
+   */
+  static std::uint64_t fmix(std::uint64_t k)
+  {
+    k ^= k >> 33;
+    k *= 0xFF51AFD7ED558CCDULL;
+    k ^= k >> 33;
+    k *= 0xC4CEB9FE1A85EC53ULL;
+    k ^= k >> 33;
+    return k;
+  }
+
+  /**
+   * @brief Lê 8 bytes sem exigir alinhamento.
+   */
+  static std::uint64_t load64(const char* bytes)
+  {
+    std::uint64_t value{ 0 };
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+  }
+
+public:
+  /**
+   * @brief Calcula o hash de @a contents.
+   */
+  static Hash128 of(str_view contents, std::uint64_t seed = 0)
+  {
+    const char* data{ contents.data() };
+    const size_t n_blocks{ contents.size() / 16 };
+
+    std::uint64_t h1{ seed };
+    std::uint64_t h2{ seed };
+
+    for (size_t i{ 0 }; i < n_blocks; ++i)
+    {
+      std::uint64_t k1{ load64(data + i * 16) };
+      std::uint64_t k2{ load64(data + i * 16 + 8) };
+
+      k1 *= C1;
+      k1 = rotl(k1, 31);
+      k1 *= C2;
+      h1 ^= k1;
+      h1 = rotl(h1, 27);
+      h1 += h2;
+      h1 = h1 * 5 + 0x52DCE729;
+
+      k2 *= C2;
+      k2 = rotl(k2, 33);
+      k2 *= C1;
+      h2 ^= k2;
+      h2 = rotl(h2, 31);
+      h2 += h1;
+      h2 = h2 * 5 + 0x38495AB5;
+    }
+
+    // [!] Cauda (até 15 bytes), montada byte a byte como na implementação de referência.
+    const auto* tail{ reinterpret_cast<const byte*>(data + n_blocks * 16) };
+    const size_t n_tail{ contents.size() & 15 };
+    std::uint64_t k1{ 0 };
+    std::uint64_t k2{ 0 };
+    for (size_t i{ n_tail }; i > 8; --i)
+    {
+      k2 ^= static_cast<std::uint64_t>(tail[i - 1]) << (8 * (i - 9));
+    }
+    for (size_t i{ n_tail < 8 ? n_tail : 8 }; i > 0; --i)
+    {
+      k1 ^= static_cast<std::uint64_t>(tail[i - 1]) << (8 * (i - 1));
+    }
+    if (n_tail > 8)
+    {
+      k2 *= C2;
+      k2 = rotl(k2, 33);
+      k2 *= C1;
+      h2 ^= k2;
+    }
+    if (n_tail > 0)
+    {
+      k1 *= C1;
+      k1 = rotl(k1, 31);
+      k1 *= C2;
+      h1 ^= k1;
+    }
+
+    h1 ^= contents.size();
+    h2 ^= contents.size();
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+    h1 += h2;
+    h2 += h1;
+
+    return { h1, h2 };
+  }
+};
+
+#endif  //!< CONTENT_HASH_HPP
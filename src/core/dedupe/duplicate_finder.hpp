@@ -0,0 +1,197 @@
+/**
+ * @file duplicate_finder.hpp
+ *
+ * @brief Define a classe DuplicateFinder, que agrupa arquivos de conteúdo idêntico.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-04
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef DUPLICATE_FINDER_HPP
+#define DUPLICATE_FINDER_HPP
+
+// STL includes {{{
+#include <algorithm>   // `std::max`, `std::min`, `std::remove_if`
+#include <atomic>      // `std::atomic`
+#include <functional>  // `std::ref`
+#include <optional>    // `std::optional`
+#include <thread>      // `std::thread`
+// }}}
+
+#include "../common/aliases.hpp"       // `umap`, `vec`, `size_t`
+#include "../common/constants.hpp"     // `STDIN_SOURCE`
+#include "../core/io/file_reader.hpp"  // `FileReader`
+#include "../core/sloc/file_info.hpp"  // `FileInfo`
+#include "content_hash.hpp"            // `ContentHash`, `Hash128`
+
+/**
+ * @brief Encontra grupos de arquivos com o mesmo conteúdo, para que cada conteúdo seja analisado uma única vez.
+ *
+ * @details Só arquivos do mesmo tamanho podem ser idênticos, e o tamanho já é conhecido desde a descoberta. Por isso
+ * apenas os arquivos cujo tamanho se repete são lidos e passam pelo `ContentHash`; os demais nem são abertos. O hash é
+ * calculado em paralelo, e os grupos são formados por (tamanho, hash).
+ *
+ * Em cada grupo, o primeiro arquivo na ordem de descoberta é o representante: ele é o único analisado, e suas contagens
+ * são copiadas para as demais cópias.
+ */
+class DuplicateFinder
+{
+public:
+  /**
+   * @brief Um grupo de arquivos idênticos.
+   */
+  struct Group
+  {
+    Hash128 hash{};     //!< Hash do conteúdo.
+    vec<size_t> files;  //!< Índices dos arquivos, em ordem de descoberta (o primeiro é o representante).
+  };
+
+private:
+  /**
+   * @brief Identidade de um conteúdo: tamanho e hash.
+   */
+  struct ContentKey
+  {
+    std::uintmax_t size{ 0 };  //!< Tamanho do arquivo.
+    Hash128 hash{};            //!< Hash do conteúdo.
+
+    bool operator==(const ContentKey& other) const { return size == other.size and hash == other.hash; }
+  };
+
+  /**
+   * @brief Função de hash de `ContentKey`.
+   */
+  struct ContentKeyHash
+  {
+    size_t operator()(const ContentKey& key) const { return Hash128Hash{}(key.hash) ^ static_cast<size_t>(key.size); }
+  };
+
+  /**
+   * @brief Calcula, com uma thread, o hash dos candidatos a partir de `next` até a lista acabar.
+   */
+  static void hash_files(const vec<FileInfo>& files, const vec<size_t>& candidates, vec<std::optional<Hash128>>& hashes,
+                         std::atomic<size_t>& next)
+  {
+    FileReader reader{};  //!< Leitor (e buffer) exclusivo desta thread.
+    for (size_t c{ next.fetch_add(1) }; c < candidates.size(); c = next.fetch_add(1))
+    {
+      const std::optional<str_view> contents{ reader.open(files[candidates[c]].m_filename.c_str()) };
+      if (contents)
+      {
+        hashes[c] = ContentHash::of(*contents);
+      }
+      reader.release();
+    }
+  }
+
+public:
+  /**
+   * @brief Agrupa os arquivos de @a files com conteúdo idêntico.
+   *
+   * @param files      Arquivos descobertos (com `m_size` preenchido).
+   * @param n_threads  Quantidade de threads usadas para ler e calcular os hashes.
+   *
+   * @return vec<Group>  Grupos com pelo menos duas cópias, na ordem de descoberta do representante.
+   */
+  static vec<Group> find(const vec<FileInfo>& files, size_t n_threads)
+  {
+    // [!] 1. Candidatos: arquivos não vazios cujo tamanho aparece mais de uma vez.
+    umap<std::uintmax_t, size_t> size_count{};
+    for (const auto& file : files)
+    {
+      if (file.m_size > 0 and file.m_filename != STDIN_SOURCE)
+      {
+        ++size_count[file.m_size];
+      }
+    }
+
+    vec<size_t> candidates{};
+    for (size_t f{ 0 }; f < files.size(); ++f)
+    {
+      if (files[f].m_size > 0 and files[f].m_filename != STDIN_SOURCE and size_count[files[f].m_size] > 1)
+      {
+        candidates.push_back(f);
+      }
+    }
+
+    // [!] 2. Hash do conteúdo dos candidatos, em paralelo.
+    vec<std::optional<Hash128>> hashes(candidates.size());
+    std::atomic<size_t> next{ 0 };
+    n_threads = std::max(size_t{ 1 }, std::min(n_threads, candidates.size()));
+    vec<std::thread> threads{};
+    for (size_t t{ 1 }; t < n_threads; ++t)
+    {
+      threads.emplace_back(hash_files, std::cref(files), std::cref(candidates), std::ref(hashes), std::ref(next));
+    }
+    hash_files(files, candidates, hashes, next);
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    // [!] 3. Agrupa por (tamanho, hash), na ordem de descoberta.
+    umap<ContentKey, size_t, ContentKeyHash> group_of{};  //!< Posição de cada conteúdo em `groups`.
+    vec<Group> groups{};
+    for (size_t c{ 0 }; c < candidates.size(); ++c)
+    {
+      if (not hashes[c])
+      {
+        continue;  // [!] Não pôde ser lido: será analisado (e falhará) normalmente.
+      }
+      const auto inserted{ group_of.emplace(ContentKey{ files[candidates[c]].m_size, *hashes[c] }, groups.size()) };
+      if (inserted.second)
+      {
+        groups.push_back({ *hashes[c], {} });
+      }
+      groups[inserted.first->second].files.push_back(candidates[c]);
+    }
+
+    // [!] Conteúdos que apareceram uma única vez não são duplicatas.
+    groups.erase(std::remove_if(groups.begin(), groups.end(), [](const Group& group) { return group.files.size() < 2; }),
+                 groups.end());
+    return groups;
+  }
+
+  /**
+   * @brief Marca, para cada arquivo, se ele é uma cópia (e não o representante) de algum grupo.
+   */
+  static vec<bool> copies(const vec<Group>& groups, size_t n_files)
+  {
+    vec<bool> is_copy(n_files, false);
+    for (const auto& group : groups)
+    {
+      for (size_t m{ 1 }; m < group.files.size(); ++m)
+      {
+        is_copy[group.files[m]] = true;
+      }
+    }
+    return is_copy;
+  }
+
+  /**
+   * @brief Copia as contagens do representante de cada grupo para as demais cópias.
+   */
+  static void propagate(const vec<Group>& groups, vec<FileInfo>& files)
+  {
+    for (const auto& group : groups)
+    {
+      const FileInfo& representative{ files[group.files.front()] };
+      for (size_t m{ 1 }; m < group.files.size(); ++m)
+      {
+        FileInfo& copy{ files[group.files[m]] };
+        copy.n_loc = representative.n_loc;
+        copy.n_reg_comments = representative.n_reg_comments;
+        copy.n_doc_comments = representative.n_doc_comments;
+        copy.n_blank_lines = representative.n_blank_lines;
+        copy.n_lines = representative.n_lines;
+      }
+    }
+  }
+};
+
+#endif  //!< DUPLICATE_FINDER_HPP
@@ -0,0 +1,548 @@
+/**
+ * @file dir_walker.hpp
+ *
+ * @brief Define a classe DirWalker, que percorre árvores de diretórios em paralelo com poucas chamadas de sistema.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef DIR_WALKER_HPP
+#define DIR_WALKER_HPP
+
+// POSIX includes {{{
+#include <dirent.h>    // `DT_*`, `fdopendir`, `readdir` (fora do Linux)
+#include <fcntl.h>     // `openat`
+#include <sys/stat.h>  // `fstatat`, `fstat`
+#include <unistd.h>    // `close`
+#if defined(__linux__)
+# include <sys/syscall.h>  // `SYS_getdents64`
+#endif
+// }}}
+
+// STL includes {{{
+#include <algorithm>           // `std::max`
+#include <condition_variable>  // `std::condition_variable`
+#include <cstdint>             // `std::uint64_t`, `std::int64_t`
+#include <cstring>             // `std::strcmp`
+#include <deque>               // `std::deque`
+#include <functional>          // `std::function`
+#include <mutex>               // `std::mutex`
+#include <thread>              // `std::thread`
+// }}}
+
+#include "../common/aliases.hpp"  // `str`, `str_view`, `vec`, `uset`, `size_t`
+#include "file_identity.hpp"      // `FileKey`, `FileKeyHash`, `SeenFiles`
+
+/**
+ * @brief Percorre diretórios com `openat` + `getdents64`, usando o `d_type` de cada entrada para evitar `stat`.
+ *
+ * @details Cada diretório é aberto uma vez e lido em blocos com `getdents64`; o tipo de cada entrada vem do próprio
+ * `d_type`. Só há `stat` (relativo ao descritor do diretório, com `fstatat`) quando:
+ *   - o sistema de arquivos não informa o tipo (`DT_UNKNOWN`);
+ *   - a entrada é um link simbólico (é preciso saber para onde ele aponta);
+ *   - a entrada é um arquivo aceito pelo filtro de nomes (o tamanho é usado no escalonamento).
+ * Diretórios e arquivos que não interessam nunca passam por `stat`.
+ *
+ * Os subdiretórios são lidos em paralelo: cada diretório encontrado vira uma tarefa numa fila compartilhada. Cada
+ * diretório guarda suas entradas na ordem do `getdents64`, e o resultado final é montado percorrendo a árvore em
+ * pré-ordem, então a ordem dos arquivos é a mesma do `std::filesystem::recursive_directory_iterator`, não importa
+ * quantas threads participaram.
+ *
+ * Links simbólicos para diretórios são seguidos em rodadas: depois que a árvore real termina, os links cujo destino
+ * ainda não foi percorrido viram novas tarefas (em pré-ordem, o primeiro link para um destino vence), e assim por
+ * diante. Um diretório nunca é percorrido duas vezes, o que também encerra ciclos de links. Por isso, quando um
+ * diretório é alcançável tanto pelo caminho real quanto por um link, os arquivos aparecem sob o caminho real.
+ */
+class DirWalker
+{
+public:
+  /// @brief Filtro de nomes: decide se um arquivo regular interessa.
+  using name_filter = std::function<bool(str_view name)>;
+
+  /**
+   * @brief Um arquivo encontrado.
+   */
+  struct Found
+  {
+    str path;                    //!< Caminho (raiz + nomes das entradas).
+    FileKey key{};               //!< Identidade (dispositivo, inode).
+    std::uintmax_t size{ 0 };    //!< Tamanho em bytes.
+    std::int64_t mtime_ns{ 0 };  //!< Última modificação, em nanossegundos desde a época.
+    bool has_info{ false };      //!< Indica se o `stat` do arquivo deu certo (senão, `key`, `size` e `mtime_ns` não valem).
+  };
+
+private:
+  /// @brief Tipo de uma entrada guardada num diretório.
+  enum class ItemKind : byte
+  {
+    FILE,      //!< Arquivo aceito pelo filtro.
+    DIR,       //!< Subdiretório real.
+    LINK_DIR,  //!< Link simbólico para um diretório.
+  };
+
+  struct Node;
+
+  /**
+   * @brief Uma entrada de um diretório, na ordem do `getdents64`.
+   */
+  struct Item
+  {
+    ItemKind kind{ ItemKind::FILE };  //!< Tipo da entrada.
+    Found file{};                     //!< Arquivo (`FILE`), ou caminho e identidade do destino (`LINK_DIR`).
+    Node* child{ nullptr };           //!< Diretório percorrido a partir desta entrada (ou `nullptr`).
+  };
+
+  /**
+   * @brief Um diretório percorrido.
+   */
+  struct Node
+  {
+    str path;                 //!< Caminho do diretório.
+    Node* parent{ nullptr };  //!< Diretório pai (para detectar ciclos de *bind mounts*).
+    FileKey key{};            //!< Identidade do diretório, obtida com `fstat` ao abri-lo.
+    bool opened{ false };     //!< Indica se o diretório pôde ser aberto.
+    vec<Item> items{};        //!< Entradas relevantes, na ordem em que foram lidas.
+  };
+
+  option m_recursive;                //!< Se `false`, apenas as entradas da raiz são lidas.
+  name_filter m_accept;              //!< Filtro de nomes dos arquivos.
+  size_t m_n_threads;                //!< Quantidade de threads da travessia.
+
+  std::deque<Node> m_nodes{};        //!< Diretórios (o `deque` não move os elementos já criados).
+  std::deque<Node*> m_pending{};     //!< Diretórios ainda não lidos.
+  size_t m_active{ 0 };              //!< Threads lendo um diretório no momento.
+  std::mutex m_mutex{};              //!< Protege `m_nodes`, `m_pending` e `m_active`.
+  std::condition_variable m_wake{};  //!< Acorda threads quando há trabalho novo ou a travessia terminou.
+
+  /**
+   * @brief Junta o caminho de um diretório com o nome de uma entrada.
+   */
+  static str join(const str& directory, str_view name)
+  {
+    str path{ directory };
+    if (not path.empty() and path.back() != '/')
+    {
+      path += '/';
+    }
+    path += name;
+    return path;
+  }
+
+  /**
+   * @brief Cria um diretório filho de @a parent e o coloca na fila. Deve ser chamado com `m_mutex` travado.
+   */
+  Node* push_node(str path, Node* parent)
+  {
+    m_nodes.push_back(Node{ std::move(path), parent });
+    m_pending.push_back(&m_nodes.back());
+    m_wake.notify_one();  // [!] Acorda uma thread ociosa para o novo diretório.
+    return &m_nodes.back();
+  }
+
+  /**
+   * @brief Chama @a visit(nome, d_type, d_ino) para cada entrada do diretório aberto em @a fd.
+   */
+  template <typename Visitor>
+  static void read_entries(int fd, vec<char>& buffer, Visitor&& visit)
+  {
+#if defined(__linux__)
+    // [!] Formato das entradas devolvidas pelo `getdents64` (não há um cabeçalho público com esta struct).
+    struct LinuxDirent64
+    {
+      std::uint64_t d_ino;
+      std::int64_t d_off;
+      unsigned short d_reclen;
+      unsigned char d_type;
+      char d_name[1];
+    };
+
+    while (true)
+    {
+      const long n_read{ ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size()) };
+      if (n_read <= 0)
+      {
+        break;  // [!] Fim do diretório (ou erro de leitura).
+      }
+      for (long offset{ 0 }; offset < n_read;)
+      {
+        const auto* entry{ reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset) };
+        visit(entry->d_name, entry->d_type, static_cast<ino_t>(entry->d_ino));
+        offset += entry->d_reclen;
+      }
+    }
+#else
+    // [!] Fora do Linux: `readdir` sobre uma cópia do descritor (o `closedir` fecha a cópia).
+    DIR* directory{ ::fdopendir(::dup(fd)) };
+    if (directory == nullptr)
+    {
+      return;
+    }
+    while (const dirent* entry{ ::readdir(directory) })
+    {
+      visit(entry->d_name, entry->d_type, entry->d_ino);
+    }
+    ::closedir(directory);
+#endif
+  }
+
+  /**
+   * @brief Classifica as entradas do diretório aberto em @a fd, chamando @a on_item(tipo, entrada) para cada arquivo
+   * aceito, subdiretório (com `recursive`) e link simbólico para diretório (com `recursive`), na ordem do `getdents64`.
+   *
+   * @details Para subdiretórios reais, apenas `path` da entrada é preenchido.
+   */
+  template <typename OnItem>
+  void read_directory(int fd, const str& path, vec<char>& buffer, OnItem&& on_item) const
+  {
+    read_entries(fd, buffer, [&](const char* name, unsigned char type, ino_t /*ino*/) {
+      if (std::strcmp(name, ".") == 0 or std::strcmp(name, "..") == 0)
+      {
+        return;
+      }
+
+      struct stat entry_info{};
+      if (type == DT_UNKNOWN)
+      {
+        // [!] O sistema de arquivos não informou o tipo: único caso em que um `stat` é inevitável.
+        if (::fstatat(fd, name, &entry_info, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+          return;
+        }
+        type = S_ISDIR(entry_info.st_mode) ? DT_DIR : S_ISREG(entry_info.st_mode) ? DT_REG : S_ISLNK(entry_info.st_mode) ? DT_LNK : DT_UNKNOWN;
+      }
+
+      if (type == DT_DIR)
+      {
+        if (m_recursive)
+        {
+          on_item(ItemKind::DIR, Found{ join(path, name) });
+        }
+        return;
+      }
+
+      const bool is_link{ type == DT_LNK };
+      if (type != DT_REG and not is_link)
+      {
+        return;  // [!] Dispositivos, *sockets*, *pipes*...
+      }
+      if (is_link and not m_accept(name) and not m_recursive)
+      {
+        return;  // [!] Link que não pode ser um arquivo aceito nem um diretório a percorrer.
+      }
+      if (not is_link and not m_accept(name))
+      {
+        return;  // [!] Arquivo que não interessa: nenhum `stat`.
+      }
+
+      // [!] Links são seguidos; arquivos regulares aceitos precisam do tamanho e da identidade.
+      const bool has_info{ ::fstatat(fd, name, &entry_info, 0) == 0 };
+      if (is_link and has_info and S_ISDIR(entry_info.st_mode))
+      {
+        if (m_recursive)
+        {
+          on_item(ItemKind::LINK_DIR, Found{ join(path, name), { entry_info.st_dev, entry_info.st_ino } });
+        }
+        return;
+      }
+      if (is_link and (not has_info or not S_ISREG(entry_info.st_mode) or not m_accept(name)))
+      {
+        return;  // [!] Link quebrado ou para algo que não é um arquivo aceito.
+      }
+
+      Found found{ join(path, name) };
+      found.has_info = has_info;
+      if (has_info)
+      {
+        found.key = { entry_info.st_dev, entry_info.st_ino };
+        found.size = static_cast<std::uintmax_t>(entry_info.st_size);
+        found.mtime_ns = mtime_ns_of(entry_info);
+      }
+      on_item(ItemKind::FILE, std::move(found));
+    });
+  }
+
+  /**
+   * @brief Lê um diretório, guardando arquivos aceitos e subdiretórios em `node.items`.
+   */
+  void read_node(Node& node, vec<char>& buffer)
+  {
+    const int fd{ ::openat(AT_FDCWD, node.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) };
+    if (fd < 0)
+    {
+      return;  // [!] Sem permissão (ou removido durante a travessia): é ignorado, como em `skip_permission_denied`.
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0)
+    {
+      node.opened = true;
+      node.key = { info.st_dev, info.st_ino };
+    }
+
+    // [!] *Bind mount* que contém a si mesmo: o diretório já é um ancestral, então não é lido de novo.
+    for (const Node* ancestor{ node.parent }; node.opened and ancestor != nullptr; ancestor = ancestor->parent)
+    {
+      if (ancestor->key == node.key)
+      {
+        node.opened = false;
+      }
+    }
+    if (not node.opened)
+    {
+      ::close(fd);
+      return;
+    }
+
+    read_directory(fd, node.path, buffer, [&](ItemKind kind, Found&& found) {
+      if (kind == ItemKind::DIR)
+      {
+        node.items.push_back({ ItemKind::DIR, {}, nullptr });
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        node.items.back().child = push_node(std::move(found.path), &node);
+        return;
+      }
+      node.items.push_back({ kind, std::move(found), nullptr });
+    });
+
+    ::close(fd);
+  }
+
+  /**
+   * @brief Percorre @a path em profundidade, na própria thread, entregando cada arquivo novo a @a emit.
+   *
+   * @details As entradas do diretório são lidas por inteiro antes de descer nos subdiretórios, então há no máximo um
+   * descritor aberto por vez, não importa a profundidade da árvore. Links simbólicos para diretórios não são seguidos
+   * aqui: vão para @a links, em pré-ordem.
+   */
+  void stream_directory(const str& path, SeenFiles& seen, vec<char>& buffer, vec<Found>& links,
+                        const std::function<void(Found&&)>& emit) const
+  {
+    const int fd{ ::openat(AT_FDCWD, path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) };
+    if (fd < 0)
+    {
+      return;
+    }
+
+    // [!] Diretório já percorrido (ciclo de links, *bind mount* ou raiz sobreposta): não é lido de novo.
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 or not seen.insert_directory(FileKey{ info.st_dev, info.st_ino }))
+    {
+      ::close(fd);
+      return;
+    }
+
+    vec<Item> items{};
+    read_directory(fd, path, buffer, [&](ItemKind kind, Found&& found) { items.push_back({ kind, std::move(found), nullptr }); });
+    ::close(fd);
+
+    for (auto& item : items)
+    {
+      if (item.kind == ItemKind::DIR)
+      {
+        stream_directory(item.file.path, seen, buffer, links, emit);
+      }
+      else if (item.kind == ItemKind::LINK_DIR)
+      {
+        links.push_back(std::move(item.file));
+      }
+      else if (seen.insert_file(item.file.path, item.file.has_info ? &item.file.key : nullptr))
+      {
+        emit(std::move(item.file));
+      }
+    }
+  }
+
+  /**
+   * @brief Laço de cada thread: lê diretórios da fila até ela esvaziar e ninguém mais estar produzindo trabalho.
+   */
+  void work()
+  {
+    vec<char> buffer(64 * 1024);  //!< Buffer do `getdents64`, exclusivo desta thread.
+
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    while (true)
+    {
+      m_wake.wait(lock, [this] { return not m_pending.empty() or m_active == 0; });
+      if (m_pending.empty())
+      {
+        break;  // [!] Ninguém está lendo e não há mais diretórios: a rodada terminou.
+      }
+
+      Node* node{ m_pending.front() };
+      m_pending.pop_front();
+      ++m_active;
+
+      lock.unlock();
+      read_node(*node, buffer);
+      lock.lock();
+
+      --m_active;
+      m_wake.notify_all();
+    }
+  }
+
+  /**
+   * @brief Esvazia a fila de diretórios usando `m_n_threads` threads (a thread chamadora incluída).
+   */
+  void run_round()
+  {
+    vec<std::thread> threads{};
+    for (size_t t{ 1 }; t < m_n_threads; ++t)
+    {
+      threads.emplace_back(&DirWalker::work, this);
+    }
+    work();
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  /**
+   * @brief Percorre a árvore em pré-ordem, chamando @a visit em cada item.
+   */
+  template <typename Visitor>
+  static void preorder(Node& node, Visitor& visit)
+  {
+    for (auto& item : node.items)
+    {
+      visit(node, item);
+      if (item.child != nullptr)
+      {
+        preorder(*item.child, visit);
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Cria um percorredor.
+   *
+   * @param recursive  Se `true`, desce nos subdiretórios (e segue links simbólicos para diretórios).
+   * @param accept     Filtro de nomes: apenas arquivos aceitos por ele são devolvidos (e passam por `stat`).
+   * @param n_threads  Quantidade de threads da travessia.
+   */
+  DirWalker(option recursive, name_filter accept, size_t n_threads)
+    : m_recursive{ recursive }, m_accept{ std::move(accept) }, m_n_threads{ std::max(size_t{ 1 }, n_threads) }
+  { /* empty */
+  }
+
+  /**
+   * @brief Percorre @a root e devolve os arquivos aceitos, em pré-ordem.
+   *
+   * @param root  Diretório raiz.
+   * @param seen  Arquivos e diretórios já vistos (inclusive em raízes anteriores). Diretórios já vistos são pulados e
+   *              arquivos já vistos não são devolvidos.
+   *
+   * @return vec<Found>  Arquivos encontrados, na ordem de `recursive_directory_iterator`.
+   */
+  vec<Found> walk(const str& root, SeenFiles& seen)
+  {
+    m_nodes.clear();
+    Node* root_node{ push_node(root, nullptr) };
+    run_round();
+
+    // [!] Rodadas de links simbólicos: um destino ainda não percorrido vira um novo diretório, em pré-ordem.
+    if (m_recursive)
+    {
+      uset<FileKey, FileKeyHash> walked{};
+      for (const auto& node : m_nodes)
+      {
+        walked.insert(node.key);
+      }
+
+      while (true)
+      {
+        auto claim{ [&](Node& node, Item& item) {
+          if (item.kind == ItemKind::LINK_DIR and item.child == nullptr and walked.insert(item.file.key).second)
+          {
+            item.child = push_node(item.file.path, &node);
+          }
+        } };
+        preorder(*root_node, claim);
+
+        if (m_pending.empty())
+        {
+          break;
+        }
+        const size_t first_new{ m_nodes.size() - m_pending.size() };
+        run_round();
+        for (size_t n{ first_new }; n < m_nodes.size(); ++n)
+        {
+          walked.insert(m_nodes[n].key);
+        }
+      }
+    }
+
+    // [!] Monta o resultado em pré-ordem, pulando diretórios e arquivos já vistos.
+    vec<Found> files{};
+    if (not root_node->opened or not seen.insert_directory(root_node->key))
+    {
+      return files;
+    }
+
+    auto collect{ [&](Node& /*node*/, Item& item) {
+      if (item.kind == ItemKind::FILE)
+      {
+        if (seen.insert_file(item.file.path, item.file.has_info ? &item.file.key : nullptr))
+        {
+          files.push_back(std::move(item.file));
+        }
+      }
+      else if (item.child != nullptr and (not item.child->opened or not seen.insert_directory(item.child->key)))
+      {
+        item.child = nullptr;  // [!] Diretório já visto por outro caminho: não desce nele.
+      }
+    } };
+    preorder(*root_node, collect);
+
+    return files;
+  }
+
+  /**
+   * @brief Percorre @a root na thread chamadora, entregando cada arquivo aceito a @a emit assim que ele é encontrado.
+   *
+   * @details Feito para o *pipeline*: a análise dos primeiros arquivos começa enquanto o resto da árvore ainda está
+   * sendo lido. A travessia é sequencial e em profundidade, e os links simbólicos para diretórios são seguidos em
+   * rodadas depois da árvore real, como em `walk`: os arquivos entregues são os mesmos, com os mesmos caminhos. A
+   * única diferença é a ordem, pois os arquivos alcançados por links vêm depois dos demais, em vez de no lugar do link.
+   *
+   * @param root  Diretório raiz.
+   * @param seen  Arquivos e diretórios já vistos (inclusive em raízes anteriores).
+   * @param emit  Recebe cada arquivo novo, em pré-ordem.
+   *
+   * @return size_t  Quantidade de arquivos entregues.
+   */
+  size_t stream(const str& root, SeenFiles& seen, const std::function<void(Found&&)>& emit) const
+  {
+    size_t n_emitted{ 0 };
+    vec<char> buffer(64 * 1024);  //!< Buffer do `getdents64`.
+    const std::function<void(Found&&)> counted_emit{ [&](Found&& found) {
+      ++n_emitted;
+      emit(std::move(found));
+    } };
+
+    vec<Found> links{};  //!< Links para diretórios da rodada atual, em pré-ordem.
+    stream_directory(root, seen, buffer, links, counted_emit);
+
+    // [!] Rodadas de links simbólicos: destinos já percorridos são pulados pelo próprio `stream_directory`.
+    while (not links.empty())
+    {
+      vec<Found> round{};
+      round.swap(links);
+      for (const auto& link : round)
+      {
+        stream_directory(link.path, seen, buffer, links, counted_emit);
+      }
+    }
+    return n_emitted;
+  }
+};
+
+#endif  //!< DIR_WALKER_HPP
@@ -27,14 +27,15 @@
  */
 enum class FieldOption : byte
 {
-  NONE,         //!< Sem ordenação.
-  FILENAME,     //!< Ordenar pelo nome do arquivo.
-  FILETYPE,     //!< Ordenar pelo tipo do arquivo.
-  COMMENTS,     //!< Ordenar pela quantidade de comentários regulares.
-  DOC_COMENTS,  //!< Ordenar pela quantidade de comentários de documentação.
-  BLANK_LINES,  //!< Ordenar pela quantidade de linhas vazias.
-  SLOC,         //!< Ordenar pela quantidade de linhas de código.
-  ALL,          //!< Ordenar pela quantidade de linhas totais.
+  NONE,             //!< Sem ordenação.
+  FILENAME,         //!< Ordenar pelo nome do arquivo.
+  FILETYPE,         //!< Ordenar pelo tipo do arquivo.
+  COMMENTS,         //!< Ordenar pela quantidade de comentários regulares.
+  DOC_COMENTS,      //!< Ordenar pela quantidade de comentários de documentação.
+  BLANK_LINES,      //!< Ordenar pela quantidade de linhas vazias.
+  SLOC,             //!< Ordenar pela quantidade de linhas de código.
+  ALL,              //!< Ordenar pela quantidade de linhas totais.
+  COMMENT_DENSITY,  //!< Ordenar pela fração de linhas que são comentários (chave derivada).
 };
 
 #endif  //!< FIELD_OPTION_HPP
@@ -0,0 +1,137 @@
+/**
+ * @file file_identity.hpp
+ *
+ * @brief Define a classe SeenFiles, que identifica arquivos e diretórios pelo inode para evitar duplicatas.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-31
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef FILE_IDENTITY_HPP
+#define FILE_IDENTITY_HPP
+
+// POSIX includes {{{
+#include <sys/stat.h>  // `stat`, `dev_t`, `ino_t`
+// }}}
+
+// STL includes {{{
+#include <cstdint>       // `std::uint64_t`, `std::int64_t`
+#include <filesystem>    // `std::filesystem::path`, `std::filesystem::weakly_canonical`
+#include <system_error>  // `std::error_code`
+// }}}
+
+#include "../common/aliases.hpp"  // `uset`, `str`, `size_t`
+
+/**
+ * @brief Identidade de um arquivo no sistema: o par (dispositivo, inode).
+ *
+ * @details Caminhos diferentes para o mesmo arquivo (`src` e `./src/../src`, raízes sobrepostas, links simbólicos e
+ * *hardlinks*) levam sempre ao mesmo par.
+ */
+struct FileKey
+{
+  dev_t dev{ 0 };  //!< Dispositivo (`st_dev`).
+  ino_t ino{ 0 };  //!< Inode (`st_ino`).
+
+  bool operator==(const FileKey& other) const { return dev == other.dev and ino == other.ino; }
+};
+
+/**
+ * @brief Retorna o instante da última modificação registrado em @a info, em nanossegundos desde a época.
+ */
+inline std::int64_t mtime_ns_of(const struct stat& info)
+{
+  return static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1'000'000'000 + static_cast<std::int64_t>(info.st_mtim.tv_nsec);
+}
+
+/**
+ * @brief Função de hash de `FileKey`.
+ */
+struct FileKeyHash
+{
+  size_t operator()(const FileKey& key) const
+  {
+    // [!] Inodes costumam ser sequenciais: a multiplicação espalha os bits antes de misturar o dispositivo.
+    const auto ino{ static_cast<std::uint64_t>(key.ino) * 0x9E3779B97F4A7C15ULL };
+    return static_cast<size_t>(ino ^ (static_cast<std::uint64_t>(key.dev) << 32 | static_cast<std::uint64_t>(key.dev) >> 32));
+  }
+};
+
+/**
+ * @brief Conjunto dos arquivos e diretórios já vistos durante a descoberta.
+ *
+ * @details Cada inserção custa O(1) em média, então a descoberta inteira é linear no número de arquivos. Quando não é
+ * possível obter o inode (o `stat` falhou), a identidade passa a ser o caminho canônico.
+ *
+ * Os diretórios ficam num conjunto à parte: ao seguir links simbólicos, um diretório já visitado indica um ciclo (ou
+ * uma raiz sobreposta) e não deve ser percorrido de novo.
+ */
+class SeenFiles
+{
+private:
+  uset<FileKey, FileKeyHash> m_files{};        //!< Arquivos já aceitos, por inode.
+  uset<str> m_paths{};                         //!< Arquivos já aceitos sem inode conhecido, pelo caminho canônico.
+  uset<FileKey, FileKeyHash> m_directories{};  //!< Diretórios já percorridos, por inode.
+
+  /**
+   * @brief Retorna o caminho canônico de @a path (ou o caminho normalizado, se nem isso for possível).
+   */
+  static str canonical_path(const std::filesystem::path& path)
+  {
+    std::error_code error{};
+    const std::filesystem::path canonical{ std::filesystem::weakly_canonical(path, error) };
+    return error ? path.lexically_normal().string() : canonical.string();
+  }
+
+public:
+  /**
+   * @brief Registra um arquivo.
+   *
+   * @param path  Caminho do arquivo.
+   * @param key   Identidade do arquivo, ou `nullptr` se o `stat` falhou.
+   *
+   * @return bool  `true` se o arquivo ainda não tinha sido visto.
+   */
+  bool insert_file(const std::filesystem::path& path, const FileKey* key)
+  {
+    return key != nullptr ? m_files.insert(*key).second : m_paths.insert(canonical_path(path)).second;
+  }
+
+  /**
+   * @brief Registra um arquivo já identificado.
+   *
+   * @return bool  `true` se o arquivo ainda não tinha sido visto.
+   */
+  bool insert_file(const FileKey& key) { return m_files.insert(key).second; }
+
+  /**
+   * @brief Registra um diretório a ser percorrido.
+   *
+   * @param path  Caminho do diretório (links simbólicos são seguidos).
+   *
+   * @return bool  `true` se o diretório ainda não tinha sido percorrido (ou se não foi possível identificá-lo).
+   */
+  bool insert_directory(const std::filesystem::path& path)
+  {
+    struct stat info{};
+    if (::stat(path.c_str(), &info) != 0)
+    {
+      return true;
+    }
+    return insert_directory(FileKey{ info.st_dev, info.st_ino });
+  }
+
+  /**
+   * @brief Registra um diretório já identificado.
+   *
+   * @return bool  `true` se o diretório ainda não tinha sido percorrido.
+   */
+  bool insert_directory(const FileKey& key) { return m_directories.insert(key).second; }
+};
+
+#endif  //!< FILE_IDENTITY_HPP
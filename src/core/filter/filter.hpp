@@ -16,14 +16,22 @@
 #ifndef FILTER_HPP
 #define FILTER_HPP
 
-#include <algorithm>   // to `std::find`
-#include <filesystem>  // to `std::filesystem::*`
-#include <iomanip>     // to `std::quoted`
-#include <iostream>    // to `std::cout`
+#include <sys/stat.h>  // to `stat`
+
+#include <algorithm>     // to `std::max`, `std::lower_bound`
+#include <filesystem>    // to `std::filesystem::*`
+#include <functional>    // to `std::function`
+#include <iomanip>       // to `std::quoted`
+#include <iostream>      // to `std::cout`, `std::ostream`
+#include <optional>      // to `std::optional`
 
 #include "../common/aliases.hpp"       // to `unmap`, `str`, `vec`, `size_t`
+#include "../common/constants.hpp"     // to `STDIN_SOURCE`
 #include "../core/sloc/file_info.hpp"  // to `FileInfo`
 #include "../core/sloc/lang_type.hpp"  // to `LangType`
+#include "dir_walker.hpp"              // to `DirWalker`
+#include "file_identity.hpp"           // to `SeenFiles`, `mtime_ns_of`
+#include "git_index.hpp"               // to `GitIndex`
 
 namespace fs = std::filesystem;  // Alias para facilitar uso de filesystem.
 
@@ -32,9 +40,16 @@ namespace fs = std::filesystem;  // Alias para facilitar uso de filesystem.
  *
  * Esta classe contém métodos para verificar se um arquivo é válido, se já foi adicionado
  * à lista de arquivos filtrados e para filtrar arquivos em um diretório.
+ *
+ * Arquivos são identificados pelo par (dispositivo, inode), guardado num conjunto de hash (`SeenFiles`): caminhos
+ * diferentes para o mesmo arquivo são contados uma única vez, e a descoberta é linear no número de arquivos.
  */
 class Filter
 {
+public:
+  /// @brief Destino dos arquivos filtrados, chamado uma vez por arquivo, na ordem de descoberta.
+  using file_sink = std::function<void(FileInfo&&)>;
+
 private:
   //!< Mapa que relaciona extensões suportadas aos seus respectivos tipos de linguagem.
   const static inline umap<str, LangType> supported_extensions = {
@@ -58,28 +73,28 @@ private:
   }
 
   /**
-   * @brief  metodo que verifica se o arquivo já foi adicionado à lista de arquivos filtrados.
+   * @brief  metodo que recupera a extensão de um nome de arquivo (como `std::filesystem::path::extension`).
    *
-   * @param file  Arquivo a ser verificado.
-   * @param filtered_files  Lista de arquivos filtrados.
-   * @return true  se o arquivo já foi adicionado à lista.
-   * @return false caso contrário.
+   * @param name  Nome do arquivo (sem diretórios).
+   * @return str  Extensão, com o ponto (ou vazia, inclusive para arquivos ocultos como `.c`).
    */
-  static bool was_pushed(const FileInfo& file, const vec<FileInfo>& filtered_files)
+  static str extension_of(str_view name)
   {
-    // [!] Usa `std::find` para verificar se arquivo já foi adicionado na lista dos filtrados.
-    return std::find(filtered_files.cbegin(), filtered_files.cend(), file) != filtered_files.end();
+    const size_t dot{ name.rfind('.') };
+    return dot == str_view::npos or dot == 0 or name == ".." ? str{} : str{ name.substr(dot) };
   }
 
   /**
    * @brief  metodo que tenta adicionar um arquivo à lista de arquivos filtrados.
    *
    * @param file  Arquivo a ser adicionado.
-   * @param filtered_files  Lista de arquivos filtrados.
+   * @param info  Resultado do `stat` do arquivo (seguindo links simbólicos).
+   * @param emit  Recebe o arquivo, se ele for adicionado.
+   * @param seen  Arquivos e diretórios já vistos.
    * @return true  se o arquivo foi adicionado à lista.
    * @return false caso contrário.
    */
-  static bool try_push_file(const fs::path& file, vec<FileInfo>& filtered_files)
+  static bool try_push_file(const fs::path& file, const struct stat& info, const file_sink& emit, SeenFiles& seen)
   {
     /* [!]
      * Tenta adicionar um novo arquivo na lista.
@@ -89,117 +104,273 @@ private:
 
     if (is_valid_file(file_extension))  // [!] Verifica se ele é válido.
     {
-      // [!] Instancia um novo objeto `FileInfo` com as informações iniciais do arquivo.
-      FileInfo file_info(file, supported_extensions.at(file_extension));
-
-      if (not was_pushed(file_info, filtered_files))  // [!] Verifica se esse arquivo já foi adicionado na lista.
+      const FileKey key{ info.st_dev, info.st_ino };
+      if (seen.insert_file(file, &key))  // [!] Verifica se esse arquivo já foi adicionado na lista.
       {
-        // [!] Se ele é duplicado, adiciona na lista.
-        filtered_files.push_back(file_info);
+        // [!] Instancia um novo objeto `FileInfo` com as informações iniciais do arquivo.
+        FileInfo file_info(file, supported_extensions.at(file_extension));
+
+        // [!] Guarda o tamanho do arquivo já na descoberta, para que o escalonador comece pelos maiores.
+        file_info.m_size = static_cast<std::uintmax_t>(info.st_size);
+        file_info.m_mtime_ns = mtime_ns_of(info);
+        file_info.m_inode = static_cast<std::uint64_t>(info.st_ino);
+
+        emit(std::move(file_info));
         return true;
       }
     }
     return false;
   }
 
+  /**
+   * @brief  metodo que converte um arquivo encontrado pelo `DirWalker` em um `FileInfo`.
+   */
+  static FileInfo to_file_info(DirWalker::Found&& found)
+  {
+    const str_view name{ str_view{ found.path }.substr(found.path.rfind('/') + 1) };
+    FileInfo file_info(std::move(found.path), supported_extensions.at(extension_of(name)));
+    file_info.m_size = found.size;
+    if (found.has_info)
+    {
+      file_info.m_mtime_ns = found.mtime_ns;
+      file_info.m_inode = static_cast<std::uint64_t>(found.key.ino);
+    }
+    return file_info;
+  }
+
   /**
    * @brief  metodo que filtra arquivos em um diretório.
    *
-   * @tparam IteratorType  Tipo do iterador a ser usado (recursivo ou não).
+   * @details A travessia é feita pelo `DirWalker` (`getdents64` + `d_type`), que só faz `stat` nos arquivos com
+   * extensão suportada, em links simbólicos e em entradas de tipo desconhecido. Links simbólicos para diretórios são
+   * seguidos; um diretório que já foi visto (um ciclo de links simbólicos, ou uma raiz contida em outra) não é
+   * percorrido de novo.
+   *
+   * Com @a n_threads maior que zero, os subdiretórios são lidos em paralelo e os arquivos são entregues quando a
+   * travessia termina. Com @a n_threads igual a zero, a travessia é sequencial e cada arquivo é entregue assim que é
+   * encontrado (usado pelo *pipeline*).
+   *
    * @param dir_root  Diretório raiz a ser filtrado.
-   * @param filtered_files  Lista de arquivos filtrados.
+   * @param recursive  Se `true`, percorre também os subdiretórios.
+   * @param n_threads  Quantidade de threads da travessia (0: sequencial, entregando os arquivos imediatamente).
+   * @param emit  Recebe cada arquivo adicionado, em pré-ordem.
+   * @param seen  Arquivos e diretórios já vistos.
    * @return size_t  Número de arquivos adicionados à lista.
    */
-  template <typename IteratorType>
-  static size_t filter_files_in_directory(const fs::path& dir_root, vec<FileInfo>& filtered_files)
+  static size_t filter_files_in_directory(const str& dir_root, bool recursive, size_t n_threads, const file_sink& emit, SeenFiles& seen)
   {
-    size_t n_files_pushed{};  //!< Armazena quantos arquivos do diretório `dir_root` foram adicionados na lista.
+    DirWalker walker{ recursive, [](str_view name) { return is_valid_file(extension_of(name)); }, n_threads };
+
+    // [!] O `DirWalker` já descarta arquivos e diretórios vistos antes, então todos os encontrados são adicionados.
+    if (n_threads == 0)
+    {
+      return walker.stream(dir_root, seen, [&](DirWalker::Found&& found) { emit(to_file_info(std::move(found))); });
+    }
+
+    vec<DirWalker::Found> found{ walker.walk(dir_root, seen) };
+    for (auto& file : found)
+    {
+      emit(to_file_info(std::move(file)));
+    }
+
+    return found.size();
+  }
 
-    for (const auto& entry : IteratorType(dir_root))
+  /**
+   * @brief  metodo que filtra os arquivos rastreados pelo git em um diretório, lendo o índice (`.git/index`).
+   *
+   * @details Nenhum diretório é percorrido: os arquivos vêm do índice, já em ordem de caminho, e só os que estão sob
+   * @a dir_root (diretamente, sem @a recursive) e têm extensão suportada recebem um `lstat`, que confirma que ainda
+   * existem na árvore de trabalho e fornece tamanho, mtime e inode atuais. Arquivos cujo `lstat` bate com os dados do
+   * índice são contados como inalterados desde que o git os viu pela última vez.
+   *
+   * @param dir_root  Diretório a ser filtrado.
+   * @param recursive  Se `true`, inclui os arquivos dos subdiretórios.
+   * @param emit  Recebe cada arquivo adicionado.
+   * @param seen  Arquivos e diretórios já vistos.
+   * @param notes  Recebe o resumo do índice lido.
+   * @return std::optional<size_t>  Número de arquivos adicionados, ou `std::nullopt` se @a dir_root não está em uma
+   *         árvore de trabalho git com índice legível.
+   */
+  static std::optional<size_t> filter_tracked_files(const str& dir_root, bool recursive, const file_sink& emit, SeenFiles& seen,
+                                                    std::ostream& notes)
+  {
+    const auto repository{ GitIndex::find_repository(dir_root) };
+    GitIndex index{};
+    if (not repository or not index.load(repository->second))
     {
-      // [!] Se `entry` for um arquivo e tiver sido adicionado na lista, incrementa o contador.
-      if (fs::is_regular_file(entry))
+      return std::nullopt;
+    }
+
+    // [!] Caminho de `dir_root` relativo à raiz da árvore de trabalho (vazio na própria raiz), terminado em '/'.
+    std::error_code error{};
+    str prefix{ fs::canonical(dir_root, error).lexically_relative(repository->first).generic_string() };
+    prefix = prefix == "." ? str{} : prefix + '/';
+    // [!] Os arquivos são exibidos a partir da entrada, como na travessia de diretórios.
+    const str base{ dir_root.back() == '/' ? dir_root : dir_root + '/' };
+
+    size_t pusheds{ 0 };    //!< Arquivos adicionados.
+    size_t unchanged{ 0 };  //!< Arquivos adicionados cujo `lstat` bate com o índice.
+    const auto& entries{ index.entries() };
+    // [!] O índice é ordenado por caminho: as entradas sob `prefix` formam um intervalo contíguo.
+    auto entry{ std::lower_bound(entries.begin(), entries.end(), prefix,
+                                 [](const GitIndex::Entry& e, const str& p) { return e.path < p; }) };
+    for (; entry != entries.end() and entry->path.compare(0, prefix.size(), prefix) == 0; ++entry)
+    {
+      const str_view relative{ str_view{ entry->path }.substr(prefix.size()) };
+      if (not recursive and relative.find('/') != str_view::npos)
+      {
+        continue;
+      }
+      const str_view name{ relative.substr(relative.rfind('/') + 1) };
+      if (not is_valid_file(extension_of(name)))
+      {
+        continue;
+      }
+
+      // [!] Removidos da árvore de trabalho (ou trocados por outro tipo de arquivo) desde o último `git add`: ignorados.
+      str path{ base + str{ relative } };
+      struct stat info{};
+      if (::lstat(path.c_str(), &info) != 0 or not S_ISREG(info.st_mode))
+      {
+        continue;
+      }
+      if (seen.insert_file(FileKey{ info.st_dev, info.st_ino }))
       {
-        n_files_pushed += try_push_file(entry, filtered_files) ? 1 : 0;
+        unchanged += index.unchanged(*entry, info) ? 1 : 0;
+
+        FileInfo file_info(std::move(path), supported_extensions.at(extension_of(name)));
+        file_info.m_size = static_cast<std::uintmax_t>(info.st_size);
+        file_info.m_mtime_ns = mtime_ns_of(info);
+        file_info.m_inode = static_cast<std::uint64_t>(info.st_ino);
+        emit(std::move(file_info));
+        ++pusheds;
       }
     }
 
-    return n_files_pushed;
+    notes << std::quoted(dir_root) << ": " << pusheds << " tracked source files from the git index (" << pusheds - unchanged
+              << " modified since last indexed).\n";
+    return pusheds;
   }
 
 public:
   /**
-   * @brief  metodo que filtra arquivos a partir de uma lista de entradas.
+   * @brief  metodo que filtra arquivos a partir de uma lista de entradas, entregando cada um a @a emit.
    *
    * @details  Este método verifica se as entradas são arquivos ou diretórios e filtra os arquivos válidos.
    * Se uma entrada for um diretório, ele filtra os arquivos dentro dele (recursivamente ou não).
    * Se uma entrada for um arquivo, ele tenta adicioná-lo diretamente à lista de arquivos filtrados.
    * Se uma entrada não for um arquivo ou diretório válido, uma mensagem de erro é exibida.
    * Se uma entrada não existir, uma mensagem de erro é exibida.
+   * A entrada `-` representa a entrada padrão: não é um caminho, então é aceita sem verificação, com a linguagem
+   * informada em @a stdin_lang.
    *
    * @param input_sources  Lista de entradas (arquivos ou diretórios) a serem filtradas.
    * @param recursive  Se `true`, filtra arquivos recursivamente em diretórios.
-
-   * @return vec<FileInfo>  Lista de arquivos filtrados.
+   * @param stdin_lang  Linguagem atribuída à entrada padrão (`--stdin-lang`).
+   * @param n_threads  Quantidade de threads usadas para percorrer diretórios (0: travessia sequencial, entregando
+   *                   cada arquivo assim que é encontrado).
+   * @param emit  Recebe cada arquivo filtrado, na ordem das entradas.
+   * @param use_git  Se `true`, diretórios dentro de uma árvore de trabalho git fornecem apenas os arquivos rastreados,
+   *                 lidos do índice em vez de percorridos (`--git`).
+   * @param notes  Recebe os avisos sobre as entradas (inexistentes, sem arquivos suportados...).
    */
-  static vec<FileInfo> filter(const vec<str>& input_sources, const bool& recursive)
+  static void discover(const vec<str>& input_sources, const bool& recursive, LangType stdin_lang, size_t n_threads,
+                       const file_sink& emit, bool use_git = false, std::ostream& notes = std::cout)
   {
-    vec<FileInfo> filtered_files{};  //!< Vetor de arquivos filtrados.
+    SeenFiles seen{};            //!< Arquivos e diretórios já vistos (por inode).
+    bool stdin_pushed{ false };  //!< Indica se a entrada padrão já foi adicionada.
 
     for (const auto& input : input_sources)
     {
-      if (fs::exists(input))  //[!] Verifica se o input do usuário representa um caminho real do sistema de arquivos.
+      if (input == STDIN_SOURCE)  // [!] Entrada padrão: lida em blocos pelo `Sloc`, sem tamanho conhecido.
+      {
+        if (not stdin_pushed)
+        {
+          emit(FileInfo{ input, stdin_lang });
+          stdin_pushed = true;
+        }
+      }
+      // [!] Um único `stat` por entrada responde se ela existe, se é diretório e se é arquivo regular.
+      else if (struct stat info{}; ::stat(input.c_str(), &info) == 0)
       {
         fs::path entry(input);  //!< Variável para arquivo/diretório.
 
-        if (fs::is_directory(entry))
+        if (S_ISDIR(info.st_mode))
         {
           size_t pusheds{ 0 };  //!< Arquivos totais que foram adicionados do diretório.
 
+          // [!] Com `--git`, a lista vem do índice; fora de um repositório, volta para a travessia.
+          const std::optional<size_t> tracked{ use_git ? filter_tracked_files(input, recursive, emit, seen, notes) : std::nullopt };
+          if (use_git and not tracked)
+          {
+            notes << entry << ": Not a git work tree (or no index), walking the directory instead.\n";
+          }
+
           // [!] Itera sobre o diretório recursivamente (ou não) e conta os arquivos adicionados.
-          pusheds = recursive ? filter_files_in_directory<fs::recursive_directory_iterator>(entry, filtered_files)
-                              : filter_files_in_directory<fs::directory_iterator>(entry, filtered_files);
+          pusheds = tracked ? *tracked : filter_files_in_directory(input, recursive, n_threads, emit, seen);
 
           if (pusheds == 0)  // [!] Exibe mensagem de alerta caso o diretório não tenha arquivos válidos.
           {
-            std::cout << entry << ": Sorry, no supported source files found in directory.\n";
+            notes << entry << ": Sorry, no supported source files found in directory.\n";
           }
         }
         // [!] Se `entry` não for um diretório, mas for um arquivo, tenta adicionar direto na lista.
-        else if (fs::is_regular_file(entry))
+        else if (S_ISREG(info.st_mode))
         {
           str entry_extension{ entry.extension() };  // [!] Recupera a extensão do arquivo.
           if (is_valid_file(entry_extension))
           {
             // [!] Como não é um diretório, tenta adicionar na lista
-            try_push_file(entry, filtered_files);
+            try_push_file(entry, info, emit, seen);
           }
           else
           {
             // [!] Se não for válido, exibe uma mensagem de alerta.
             if (not entry_extension.empty())
             {
-              std::cout << entry << ": Sorry, " << std::quoted(entry_extension) << " files are not supported at this time.\n";
+              notes << entry << ": Sorry, " << std::quoted(entry_extension) << " files are not supported at this time.\n";
             }
             else
             {
-              std::cout << entry << ": Sorry, this type of files are not supported at this time.\n";
+              notes << entry << ": Sorry, this type of files are not supported at this time.\n";
             }
           }
         }
         else
         {
           // [!] Alerta ao usuário que a entrada não é arquivo nem diretório.
-          std::cout << std::quoted(input) << ": Sorry, this isn't a file or directory.\n";
+          notes << std::quoted(input) << ": Sorry, this isn't a file or directory.\n";
         }
       }
       else
       {
         // [!] Alerta ao usuário que entrada não existe.
-        std::cout << std::quoted(input) << ": Sorry, no such file or directory.\n";
+        notes << std::quoted(input) << ": Sorry, no such file or directory.\n";
       }
     }
+  }
 
+  /**
+   * @brief  metodo que filtra arquivos a partir de uma lista de entradas, devolvendo todos de uma vez.
+   *
+   * @details  Equivale a `discover`, reunindo os arquivos em uma lista.
+   *
+   * @param input_sources  Lista de entradas (arquivos ou diretórios) a serem filtradas.
+   * @param recursive  Se `true`, filtra arquivos recursivamente em diretórios.
+   * @param stdin_lang  Linguagem atribuída à entrada padrão (`--stdin-lang`).
+   * @param n_threads  Quantidade de threads usadas para percorrer diretórios.
+   * @param use_git  Se `true`, lê os arquivos rastreados do índice do git em vez de percorrer diretórios.
+   * @param notes  Recebe os avisos sobre as entradas.
+
+   * @return vec<FileInfo>  Lista de arquivos filtrados.
+   */
+  static vec<FileInfo> filter(const vec<str>& input_sources, const bool& recursive, LangType stdin_lang = LangType::CPP,
+                              size_t n_threads = 1, bool use_git = false, std::ostream& notes = std::cout)
+  {
+    vec<FileInfo> filtered_files{};  //!< Vetor de arquivos filtrados.
+    discover(input_sources, recursive, stdin_lang, std::max(size_t{ 1 }, n_threads),
+             [&](FileInfo&& file) { filtered_files.push_back(std::move(file)); }, use_git, notes);
     return filtered_files;
   }
 };
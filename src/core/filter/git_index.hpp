@@ -0,0 +1,317 @@
+/**
+ * @file git_index.hpp
+ *
+ * @brief Define a classe GitIndex, que lê a lista de arquivos rastreados diretamente do `.git/index`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-05
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef GIT_INDEX_HPP
+#define GIT_INDEX_HPP
+
+// POSIX includes {{{
+#include <sys/stat.h>  // `stat`
+// }}}
+
+// STL includes {{{
+#include <cstdint>       // `std::uint32_t`, `std::int64_t`
+#include <cstring>       // `std::memchr`
+#include <filesystem>    // `std::filesystem::path`, `std::filesystem::canonical`
+#include <fstream>       // `std::ifstream`
+#include <optional>      // `std::optional`
+#include <system_error>  // `std::error_code`
+#include <utility>       // `std::pair`
+// }}}
+
+#include "../common/aliases.hpp"       // `byte`, `str`, `str_view`, `vec`, `size_t`
+#include "../core/io/file_reader.hpp"  // `FileReader`
+#include "file_identity.hpp"           // `mtime_ns_of`
+
+/**
+ * @brief Leitor do índice do git (`.git/index`, formato "DIRC", versões 2, 3 e 4), sem executar o `git`.
+ *
+ * @details O índice guarda, para cada arquivo rastreado, o caminho relativo à raiz da árvore de trabalho, o modo e os
+ * dados de `stat` do momento em que o arquivo foi adicionado ou conferido pela última vez (mtime, tamanho, inode...).
+ * Ler o índice substitui a travessia de diretórios: só arquivos rastreados são vistos, e saídas de compilação e
+ * arquivos não rastreados nunca são visitados.
+ *
+ * Os dados de `stat` do índice também dizem se um arquivo mudou: se o `lstat` atual bate com o do índice, o conteúdo é
+ * o mesmo que o git já conhece, sem precisar ler o arquivo. Como o git, um arquivo modificado no mesmo instante em que
+ * o índice foi escrito (ou depois) é considerado "racy" e nunca é dado como inalterado.
+ *
+ * Entradas que não são arquivos regulares (links simbólicos, submódulos, diretórios de um índice esparso), entradas
+ * fora da árvore de trabalho (`skip-worktree`) e estágios extras de conflitos de *merge* são ignorados.
+ */
+class GitIndex
+{
+public:
+  /**
+   * @brief Um arquivo rastreado.
+   */
+  struct Entry
+  {
+    str path;                    //!< Caminho relativo à raiz da árvore de trabalho.
+    std::int64_t mtime_ns{ 0 };  //!< Instante da última modificação, quando o arquivo entrou no índice.
+    std::uint32_t size{ 0 };     //!< Tamanho (truncado em 32 bits, como no índice).
+    std::uint32_t ino{ 0 };      //!< Inode (truncado em 32 bits, como no índice).
+  };
+
+private:
+  static constexpr std::uint32_t MODE_TYPE_MASK{ 0170000 };     //!< Bits de tipo do modo.
+  static constexpr std::uint32_t MODE_REGULAR{ 0100000 };       //!< Arquivo regular.
+  static constexpr std::uint16_t FLAG_EXTENDED{ 0x4000 };       //!< Há mais 16 bits de flags (versão 3 em diante).
+  static constexpr std::uint16_t FLAG_STAGE{ 0x3000 };          //!< Estágio de *merge* (0 fora de conflitos).
+  static constexpr std::uint16_t FLAG_SKIP_WORKTREE{ 0x4000 };  //!< Fora da árvore de trabalho (*sparse checkout*).
+
+  vec<Entry> m_entries{};              //!< Arquivos rastreados, na ordem do índice (por caminho).
+  std::int64_t m_index_mtime_ns{ 0 };  //!< Instante em que o índice foi escrito.
+
+  /**
+   * @brief Lê um inteiro *big-endian* de 32 bits.
+   */
+  static std::uint32_t be32(const char* bytes)
+  {
+    const auto* b{ reinterpret_cast<const byte*>(bytes) };
+    return static_cast<std::uint32_t>(b[0]) << 24 | static_cast<std::uint32_t>(b[1]) << 16 | static_cast<std::uint32_t>(b[2]) << 8
+           | static_cast<std::uint32_t>(b[3]);
+  }
+
+  /**
+   * @brief Lê um inteiro *big-endian* de 16 bits.
+   */
+  static std::uint16_t be16(const char* bytes)
+  {
+    const auto* b{ reinterpret_cast<const byte*>(bytes) };
+    return static_cast<std::uint16_t>(b[0] << 8 | b[1]);
+  }
+
+  /**
+   * @brief Retorna o primeiro valor de `objectformat` em @a config (ou vazio).
+   */
+  static str object_format(const std::filesystem::path& config)
+  {
+    std::ifstream stream{ config };
+    str line{};
+    while (std::getline(stream, line))
+    {
+      const size_t key{ line.find("objectformat") };
+      const size_t equals{ line.find('=') };
+      if (key != str::npos and equals != str::npos and equals > key)
+      {
+        const size_t first{ line.find_first_not_of(" \t", equals + 1) };
+        return first == str::npos ? str{} : line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+      }
+    }
+    return {};
+  }
+
+  /**
+   * @brief Retorna o tamanho dos identificadores de objeto do repositório (20 para SHA-1, 32 para SHA-256).
+   */
+  static size_t oid_size(const std::filesystem::path& git_dir)
+  {
+    // [!] Árvores de trabalho extras (`git worktree`) guardam a configuração no diretório comum.
+    std::filesystem::path common{ git_dir };
+    std::ifstream commondir{ git_dir / "commondir" };
+    str relative{};
+    if (std::getline(commondir, relative) and not relative.empty())
+    {
+      common = std::filesystem::path{ relative }.is_absolute() ? std::filesystem::path{ relative } : git_dir / relative;
+    }
+    return object_format(common / "config") == "sha256" ? 32 : 20;
+  }
+
+public:
+  /**
+   * @brief Procura a árvore de trabalho git que contém @a directory.
+   *
+   * @return std::optional<std::pair<fs::path, fs::path>>  Raiz da árvore de trabalho e diretório do git (`.git`, ou o
+   *         indicado por um arquivo `.git` com `gitdir:`), ambos canônicos; `std::nullopt` fora de um repositório.
+   */
+  static std::optional<std::pair<std::filesystem::path, std::filesystem::path>> find_repository(const std::filesystem::path& directory)
+  {
+    std::error_code error{};
+    std::filesystem::path current{ std::filesystem::canonical(directory, error) };
+    if (error)
+    {
+      return std::nullopt;
+    }
+
+    while (true)
+    {
+      const std::filesystem::path dot_git{ current / ".git" };
+      if (std::filesystem::is_directory(dot_git, error))
+      {
+        return std::make_pair(current, dot_git);
+      }
+      if (std::filesystem::is_regular_file(dot_git, error))
+      {
+        // [!] Submódulos e árvores de trabalho extras: o arquivo `.git` aponta para o diretório real.
+        std::ifstream stream{ dot_git };
+        str line{};
+        if (std::getline(stream, line) and line.rfind("gitdir:", 0) == 0)
+        {
+          const size_t first{ line.find_first_not_of(" \t", 7) };
+          const std::filesystem::path target{ first == str::npos ? str{} : line.substr(first) };
+          const std::filesystem::path git_dir{ std::filesystem::canonical(target.is_absolute() ? target : current / target, error) };
+          if (not error)
+          {
+            return std::make_pair(current, git_dir);
+          }
+        }
+        return std::nullopt;
+      }
+      if (current == current.root_path() or not current.has_parent_path())
+      {
+        return std::nullopt;
+      }
+      current = current.parent_path();
+    }
+  }
+
+  /**
+   * @brief Lê o índice do repositório em @a git_dir.
+   *
+   * @return bool  `false` se o índice não existe, não é suportado ou está corrompido.
+   */
+  bool load(const std::filesystem::path& git_dir)
+  {
+    m_entries.clear();
+
+    const str index_path{ (git_dir / "index").string() };
+    struct stat index_info{};
+    if (::stat(index_path.c_str(), &index_info) != 0)
+    {
+      return false;
+    }
+    m_index_mtime_ns = mtime_ns_of(index_info);
+
+    FileReader reader{};
+    const std::optional<str_view> contents{ reader.open(index_path.c_str()) };
+    if (not contents or contents->size() < 12 or contents->substr(0, 4) != "DIRC")
+    {
+      return false;
+    }
+
+    const char* data{ contents->data() };
+    const char* end{ data + contents->size() };
+    const std::uint32_t version{ be32(data + 4) };
+    const std::uint32_t n_entries{ be32(data + 8) };
+    if (version < 2 or version > 4)
+    {
+      return false;
+    }
+
+    const size_t oid_bytes{ oid_size(git_dir) };
+    const size_t fixed_size{ 40 + oid_bytes + 2 };  //!< Dados de `stat` (40 bytes), identificador e flags.
+    m_entries.reserve(n_entries);
+
+    str path{};  //!< Caminho da entrada atual (na versão 4, os caminhos são comprimidos em relação ao anterior).
+    const char* cursor{ data + 12 };
+    for (std::uint32_t e{ 0 }; e < n_entries; ++e)
+    {
+      const char* entry{ cursor };
+      if (static_cast<size_t>(end - cursor) < fixed_size)
+      {
+        m_entries.clear();
+        return false;
+      }
+
+      const std::uint32_t mode{ be32(entry + 24) };
+      const std::uint16_t flags{ be16(entry + 40 + oid_bytes) };
+      cursor = entry + fixed_size;
+
+      std::uint16_t extended_flags{ 0 };
+      if ((flags & FLAG_EXTENDED) != 0 and version >= 3)
+      {
+        if (end - cursor < 2)
+        {
+          m_entries.clear();
+          return false;
+        }
+        extended_flags = be16(cursor);
+        cursor += 2;
+      }
+
+      if (version == 4)
+      {
+        // [!] Número variável de bytes a remover do fim do caminho anterior, seguido do sufixo terminado em NUL.
+        size_t strip{ 0 };
+        byte c{ 0 };
+        bool first{ true };
+        do
+        {
+          if (cursor >= end)
+          {
+            m_entries.clear();
+            return false;
+          }
+          c = static_cast<byte>(*cursor++);
+          strip = first ? (c & 0x7F) : ((strip + 1) << 7) | (c & 0x7F);
+          first = false;
+        } while ((c & 0x80) != 0);
+
+        const void* nul{ std::memchr(cursor, '\0', static_cast<size_t>(end - cursor)) };
+        if (nul == nullptr or strip > path.size())
+        {
+          m_entries.clear();
+          return false;
+        }
+        path.resize(path.size() - strip);
+        path.append(cursor, static_cast<const char*>(nul));
+        cursor = static_cast<const char*>(nul) + 1;
+      }
+      else
+      {
+        const void* nul{ std::memchr(cursor, '\0', static_cast<size_t>(end - cursor)) };
+        if (nul == nullptr)
+        {
+          m_entries.clear();
+          return false;
+        }
+        path.assign(cursor, static_cast<const char*>(nul));
+        // [!] Versões 2 e 3: a entrada é completada com 1 a 8 bytes NUL até um múltiplo de 8.
+        const size_t entry_size{ (static_cast<size_t>(static_cast<const char*>(nul) - entry) + 8) & ~size_t{ 7 } };
+        cursor = entry + entry_size;
+        if (cursor > end)
+        {
+          m_entries.clear();
+          return false;
+        }
+      }
+
+      const bool regular{ (mode & MODE_TYPE_MASK) == MODE_REGULAR };
+      const bool first_stage{ (flags & FLAG_STAGE) == 0 or m_entries.empty() or m_entries.back().path != path };
+      if (regular and first_stage and (extended_flags & FLAG_SKIP_WORKTREE) == 0)
+      {
+        const std::int64_t mtime_ns{ static_cast<std::int64_t>(be32(entry + 8)) * 1'000'000'000 + be32(entry + 12) };
+        m_entries.push_back({ path, mtime_ns, be32(entry + 36), be32(entry + 20) });
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Retorna os arquivos rastreados, ordenados por caminho.
+   */
+  const vec<Entry>& entries() const { return m_entries; }
+
+  /**
+   * @brief Indica se o arquivo descrito por @a info (resultado do `lstat` atual) não mudou desde que entrou no índice.
+   */
+  bool unchanged(const Entry& entry, const struct stat& info) const
+  {
+    const std::int64_t mtime_ns{ mtime_ns_of(info) };
+    return mtime_ns == entry.mtime_ns and mtime_ns < m_index_mtime_ns
+           and static_cast<std::uint32_t>(info.st_size) == entry.size and static_cast<std::uint32_t>(info.st_ino) == entry.ino;
+  }
+};
+
+#endif  //!< GIT_INDEX_HPP
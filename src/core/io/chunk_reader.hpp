@@ -0,0 +1,113 @@
+/**
+ * @file chunk_reader.hpp
+ *
+ * @brief Define a classe ChunkReader, que entrega um arquivo (ou a entrada padrão) em blocos de tamanho fixo.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef CHUNK_READER_HPP
+#define CHUNK_READER_HPP
+
+// POSIX includes {{{
+#include <fcntl.h>   // `open`
+#include <unistd.h>  // `read`, `close`, `STDIN_FILENO`
+// }}}
+
+// STL includes {{{
+#include <cerrno>    // `errno`
+#include <optional>  // `std::optional`
+// }}}
+
+#include "../common/aliases.hpp"    // `str_view`, `vec`, `size_t`
+#include "../common/constants.hpp"  // `STREAM_CHUNK_SIZE`
+
+/**
+ * @brief Leitor em fluxo, com um único buffer de tamanho fixo reutilizado entre blocos e arquivos.
+ *
+ * @details Feito para entradas em que `mmap` não está disponível ou é lento (pipes, entrada padrão, sistemas de
+ * arquivos FUSE). Cada chamada de `next` faz um `read` sequencial para o mesmo buffer de `STREAM_CHUNK_SIZE` bytes,
+ * então a memória usada não depende do tamanho do arquivo nem do tamanho das linhas.
+ *
+ * O bloco retornado por `next` é válido até a próxima chamada de `next`, `open`, `open_stdin` ou `close`.
+ */
+class ChunkReader
+{
+private:
+  vec<char> m_buffer;       //!< Buffer reutilizado (alocado uma única vez, na primeira abertura).
+  int m_fd{ -1 };           //!< Descritor aberto atualmente (ou -1).
+  bool m_owns_fd{ false };  //!< Indica se o descritor deve ser fechado por este leitor (não é o caso da entrada padrão).
+
+public:
+  ChunkReader() = default;
+  ChunkReader(const ChunkReader&) = delete;
+  ChunkReader& operator=(const ChunkReader&) = delete;
+  ~ChunkReader() { close(); }
+
+  /**
+   * @brief Fecha o descritor atual (a entrada padrão nunca é fechada).
+   */
+  void close()
+  {
+    if (m_owns_fd and m_fd >= 0)
+    {
+      ::close(m_fd);
+    }
+    m_fd = -1;
+    m_owns_fd = false;
+  }
+
+  /**
+   * @brief Abre o arquivo @a path para leitura em blocos.
+   *
+   * @return bool  `true` se o arquivo foi aberto.
+   */
+  bool open(const char* path)
+  {
+    close();
+    m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    m_owns_fd = true;
+    m_buffer.resize(STREAM_CHUNK_SIZE);
+    return m_fd >= 0;
+  }
+
+  /**
+   * @brief Passa a ler a entrada padrão, sem assumir a posse do descritor.
+   */
+  void open_stdin()
+  {
+    close();
+    m_fd = STDIN_FILENO;
+    m_owns_fd = false;
+    m_buffer.resize(STREAM_CHUNK_SIZE);
+  }
+
+  /**
+   * @brief Lê o próximo bloco.
+   *
+   * @return std::optional<str_view>  Bloco lido (vazio no fim da entrada), ou `std::nullopt` em caso de erro.
+   */
+  std::optional<str_view> next()
+  {
+    while (true)
+    {
+      const ssize_t result{ ::read(m_fd, m_buffer.data(), m_buffer.size()) };
+      if (result >= 0)
+      {
+        return str_view{ m_buffer.data(), static_cast<size_t>(result) };
+      }
+      if (errno != EINTR)  // [!] Leitura interrompida por um sinal é repetida; os demais erros encerram o arquivo.
+      {
+        return std::nullopt;
+      }
+    }
+  }
+};
+
+#endif  //!< CHUNK_READER_HPP
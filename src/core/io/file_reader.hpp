@@ -0,0 +1,163 @@
+/**
+ * @file file_reader.hpp
+ *
+ * @brief Define a classe FileReader, que entrega o conteúdo inteiro de um arquivo como um único bloco contíguo.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef FILE_READER_HPP
+#define FILE_READER_HPP
+
+// POSIX includes {{{
+#include <fcntl.h>     // `open`
+#include <sys/mman.h>  // `mmap`, `madvise`, `munmap`
+#include <sys/stat.h>  // `fstat`
+#include <unistd.h>    // `pread`, `close`
+// }}}
+
+// STL includes {{{
+#include <cerrno>    // `errno`
+#include <optional>  // `std::optional`
+// }}}
+
+#include "../common/aliases.hpp"    // `str_view`, `vec`, `size_t`
+#include "../common/constants.hpp"  // `MMAP_MIN_SIZE`
+
+/**
+ * @brief Leitor de arquivos que evita cópias linha a linha.
+ *
+ * @details Arquivos a partir de `MMAP_MIN_SIZE` bytes são mapeados em memória somente leitura (com
+ * `madvise(MADV_SEQUENTIAL)`, já que a análise percorre o arquivo uma única vez, do início ao fim). Arquivos pequenos,
+ * ou que não puderam ser mapeados, são lidos com `pread` para um buffer reutilizado entre chamadas, então o custo de
+ * alocação é pago apenas quando aparece um arquivo maior que todos os anteriores.
+ *
+ * O bloco retornado por `open` é válido até a próxima chamada de `open` ou `release` (ou até a destruição do leitor).
+ */
+class FileReader
+{
+private:
+  vec<char> m_buffer;           //!< Buffer reutilizado para arquivos lidos com `pread`.
+  void* m_mapping{ nullptr };   //!< Região mapeada atualmente (ou `nullptr`).
+  size_t m_mapping_size{ 0 };   //!< Tamanho da região mapeada.
+
+  /**
+   * @brief Lê o arquivo inteiro para `m_buffer` com `pread`.
+   *
+   * @details Lê até o fim do arquivo, independentemente do tamanho informado por `fstat` (que pode estar desatualizado
+   * ou ser zero em sistemas de arquivos especiais).
+   *
+   * @param fd         Descritor do arquivo aberto.
+   * @param size_hint  Tamanho esperado do arquivo.
+   *
+   * @return std::optional<str_view>  Conteúdo lido ou `std::nullopt` em caso de erro de leitura.
+   */
+  std::optional<str_view> read_into_buffer(int fd, size_t size_hint)
+  {
+    // [!] Sempre cabe ao menos um byte além do esperado, para detectar o fim do arquivo sem realocar.
+    if (m_buffer.size() < size_hint + 1)
+    {
+      m_buffer.resize(size_hint + 1);
+    }
+
+    size_t n_read{ 0 };  //!< Bytes lidos até o momento.
+    while (true)
+    {
+      if (n_read == m_buffer.size())
+      {
+        m_buffer.resize(m_buffer.size() * 2);  // [!] O arquivo cresceu desde o `fstat`.
+      }
+
+      const ssize_t result{ ::pread(fd, m_buffer.data() + n_read, m_buffer.size() - n_read, static_cast<off_t>(n_read)) };
+      if (result < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        return std::nullopt;
+      }
+      if (result == 0)
+      {
+        break;  // [!] Fim do arquivo.
+      }
+      n_read += static_cast<size_t>(result);
+    }
+
+    return str_view{ m_buffer.data(), n_read };
+  }
+
+public:
+  FileReader() = default;
+  FileReader(const FileReader&) = delete;
+  FileReader& operator=(const FileReader&) = delete;
+  ~FileReader() { release(); }
+
+  /**
+   * @brief Desfaz o mapeamento do último arquivo aberto (se houver).
+   */
+  void release()
+  {
+    if (m_mapping != nullptr)
+    {
+      ::munmap(m_mapping, m_mapping_size);
+      m_mapping = nullptr;
+      m_mapping_size = 0;
+    }
+  }
+
+  /**
+   * @brief Abre o arquivo e retorna todo o seu conteúdo como um bloco contíguo somente leitura.
+   *
+   * @param path  Caminho do arquivo.
+   *
+   * @return std::optional<str_view>  Conteúdo do arquivo, ou `std::nullopt` se ele não pôde ser aberto ou lido.
+   */
+  std::optional<str_view> open(const char* path)
+  {
+    release();  // [!] O bloco do arquivo anterior deixa de ser válido.
+
+    const int fd{ ::open(path, O_RDONLY | O_CLOEXEC) };
+    if (fd < 0)
+    {
+      return std::nullopt;
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+      ::close(fd);
+      return std::nullopt;
+    }
+
+    const auto size{ static_cast<size_t>(info.st_size) };
+
+    // [!] Arquivos regulares grandes o suficiente são mapeados; o mapeamento continua válido após o `close`.
+    if (S_ISREG(info.st_mode) and size >= MMAP_MIN_SIZE)
+    {
+      void* mapping{ ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) };
+      if (mapping != MAP_FAILED)
+      {
+        ::madvise(mapping, size, MADV_SEQUENTIAL);  // [!] Dica ao kernel: leitura sequencial, vale fazer read-ahead.
+        ::close(fd);
+
+        m_mapping = mapping;
+        m_mapping_size = size;
+        return str_view{ static_cast<const char*>(mapping), size };
+      }
+    }
+
+    // [!] Arquivos pequenos (ou que falharam ao mapear) são lidos para o buffer reutilizado.
+    std::optional<str_view> contents{ read_into_buffer(fd, size) };
+    ::close(fd);
+    return contents;
+  }
+};
+
+#endif  //!< FILE_READER_HPP
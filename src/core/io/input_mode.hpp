@@ -0,0 +1,31 @@
+/**
+ * @file input_mode.hpp
+ *
+ * @brief Define os modos de leitura dos arquivos analisados pela classe `Sloc`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef INPUT_MODE_HPP
+#define INPUT_MODE_HPP
+
+#include "../common/aliases.hpp"  // `byte`
+
+/**
+ * @enum InputMode
+ *
+ * @brief Enum class que representa como o conteúdo dos arquivos chega ao scanner.
+ */
+enum class InputMode : byte
+{
+  MAPPED,  //!< O arquivo inteiro como um bloco contíguo (`mmap` ou `pread`), via `FileReader`.
+  STREAM,  //!< Blocos de `STREAM_CHUNK_SIZE` bytes em um buffer fixo, via `ChunkReader`.
+};
+
+#endif  //!< INPUT_MODE_HPP
@@ -0,0 +1,233 @@
+/**
+ * @file output_buffer.hpp
+ *
+ * @brief Define a classe OutputBuffer, que monta a saída num buffer reutilizável e a escreve em blocos grandes.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef OUTPUT_BUFFER_HPP
+#define OUTPUT_BUFFER_HPP
+
+// POSIX includes {{{
+#include <unistd.h>  // `write`, `STDOUT_FILENO`
+// }}}
+
+// STL includes {{{
+#include <algorithm>  // `std::min`
+#include <cerrno>     // `errno`, `EINTR`
+#include <charconv>   // `std::to_chars`
+#include <cstdint>    // `std::uint64_t`
+#include <cstring>    // `std::memcpy`, `std::memset`
+#include <iostream>   // `std::cout`
+// }}}
+
+#include "../common/aliases.hpp"    // `byte`, `str_view`, `vec`, `size_t`
+#include "../common/constants.hpp"  // `OUTPUT_BUFFER_SIZE`
+
+/**
+ * @brief Buffer de saída de tamanho fixo, alocado uma única vez e reutilizado até o fim da escrita.
+ *
+ * @details Os valores são escritos direto no buffer (números com `std::to_chars`, sem *locale* nem `ostringstream`), e
+ * o buffer só vai para o descritor quando enche ou em `flush`, com chamadas de `write` de até `OUTPUT_BUFFER_SIZE`
+ * bytes. Um milhão de linhas de resultados custam algumas dezenas de chamadas de sistema.
+ *
+ * Antes de cada escrita na saída padrão, o `std::cout` é esvaziado: o que já foi impresso por ele (avisos da
+ * descoberta, cabeçalhos) sai antes, na ordem certa.
+ */
+class OutputBuffer
+{
+private:
+  vec<char> m_data;        //!< Buffer (alocado no construtor).
+  size_t m_used{ 0 };      //!< Bytes ocupados.
+  int m_fd;                //!< Descritor de destino.
+  bool m_failed{ false };  //!< Indica se alguma escrita falhou (o resto da saída é descartado).
+
+  /**
+   * @brief Garante espaço para @a n bytes contíguos, esvaziando o buffer se preciso.
+   */
+  char* prepare(size_t n)
+  {
+    if (m_used + n > m_data.size())
+    {
+      flush();
+    }
+    return m_data.data() + m_used;
+  }
+
+  /**
+   * @brief Escreve @a size bytes de @a data no descritor, repetindo em escritas parciais e interrupções.
+   */
+  void write_all(const char* data, size_t size)
+  {
+    while (size > 0 and not m_failed)
+    {
+      const ssize_t written{ ::write(m_fd, data, size) };
+      if (written < 0)
+      {
+        m_failed = errno != EINTR;
+        continue;
+      }
+      data += written;
+      size -= static_cast<size_t>(written);
+    }
+  }
+
+public:
+  /**
+   * @brief Cria um buffer que escreve em @a fd (por padrão, a saída padrão).
+   */
+  explicit OutputBuffer(int fd = STDOUT_FILENO) : m_data(OUTPUT_BUFFER_SIZE), m_fd{ fd } {}
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+  ~OutputBuffer() { flush(); }
+
+  /**
+   * @brief Escreve no descritor tudo o que está no buffer.
+   */
+  void flush()
+  {
+    if (m_fd == STDOUT_FILENO)
+    {
+      std::cout.flush();
+    }
+    write_all(m_data.data(), m_used);
+    m_used = 0;
+  }
+
+  /// @brief Indica se alguma escrita falhou.
+  bool failed() const { return m_failed; }
+
+  /**
+   * @brief Acrescenta @a text.
+   */
+  OutputBuffer& append(str_view text)
+  {
+    if (text.size() > m_data.size())
+    {
+      flush();
+      write_all(text.data(), text.size());  // [!] Maior que o buffer: vai direto para o descritor.
+      return *this;
+    }
+    std::memcpy(prepare(text.size()), text.data(), text.size());
+    m_used += text.size();
+    return *this;
+  }
+
+  /**
+   * @brief Acrescenta o caractere @a c.
+   */
+  OutputBuffer& append(char c)
+  {
+    *prepare(1) = c;
+    ++m_used;
+    return *this;
+  }
+
+  /**
+   * @brief Acrescenta @a value em decimal.
+   */
+  OutputBuffer& append_uint(std::uint64_t value)
+  {
+    char digits[20];  // [!] 20 dígitos bastam para qualquer inteiro de 64 bits.
+    return append(str_view{ digits, static_cast<size_t>(std::to_chars(digits, digits + 20, value).ptr - digits) });
+  }
+
+  /**
+   * @brief Acrescenta @a value em notação fixa, com @a precision casas decimais (como `std::fixed`).
+   */
+  OutputBuffer& append_fixed(double value, int precision)
+  {
+    constexpr size_t MAX_CHARS{ 352 };  // [!] Sinal, 309 dígitos inteiros de um `double`, ponto e as casas pedidas.
+    char* out{ prepare(MAX_CHARS) };
+    m_used += static_cast<size_t>(std::to_chars(out, out + MAX_CHARS, value, std::chars_format::fixed, precision).ptr - out);
+    return *this;
+  }
+
+  /**
+   * @brief Acrescenta @a n cópias do caractere @a c.
+   */
+  OutputBuffer& fill(char c, size_t n)
+  {
+    while (n > 0)
+    {
+      const size_t chunk{ std::min(n, m_data.size()) };
+      std::memset(prepare(chunk), c, chunk);
+      m_used += chunk;
+      n -= chunk;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Acrescenta @a n cópias de @a text.
+   */
+  OutputBuffer& repeat(str_view text, size_t n)
+  {
+    for (size_t i{ 0 }; i < n; ++i)
+    {
+      append(text);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Acrescenta @a text, completando com espaços à direita até @a width bytes (como `std::left` e `std::setw`).
+   */
+  OutputBuffer& append_left(str_view text, size_t width)
+  {
+    append(text);
+    return fill(' ', width > text.size() ? width - text.size() : 0);
+  }
+
+  /**
+   * @brief Acrescenta @a value em decimal, completando com espaços à direita até @a width bytes.
+   */
+  OutputBuffer& append_left(std::uint64_t value, size_t width)
+  {
+    char digits[20];
+    return append_left(str_view{ digits, static_cast<size_t>(std::to_chars(digits, digits + 20, value).ptr - digits) }, width);
+  }
+
+  /**
+   * @brief Acrescenta @a text entre aspas, com os escapes do JSON.
+   *
+   * @details Aspas, barras invertidas e caracteres de controle são escapados; os demais bytes (inclusive UTF-8) passam
+   * como estão.
+   */
+  OutputBuffer& append_json_string(str_view text)
+  {
+    static constexpr char HEX[]{ "0123456789abcdef" };
+
+    append('"');
+    size_t run{ 0 };  //!< Início do trecho que não precisa de escape.
+    for (size_t i{ 0 }; i < text.size(); ++i)
+    {
+      const auto c{ static_cast<byte>(text[i]) };
+      if (c >= 0x20 and c != '"' and c != '\\')
+      {
+        continue;
+      }
+      append(text.substr(run, i - run));
+      switch (c)
+      {
+      case '"': append("\\\""); break;
+      case '\\': append("\\\\"); break;
+      case '\n': append("\\n"); break;
+      case '\t': append("\\t"); break;
+      case '\r': append("\\r"); break;
+      default: append("\\u00").append(HEX[c >> 4]).append(HEX[c & 0xF]); break;
+      }
+      run = i + 1;
+    }
+    return append(text.substr(run)).append('"');
+  }
+};
+
+#endif  //!< OUTPUT_BUFFER_HPP
@@ -0,0 +1,33 @@
+/**
+ * @file output_format.hpp
+ *
+ * @brief Define os formatos de saída dos resultados.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef OUTPUT_FORMAT_HPP
+#define OUTPUT_FORMAT_HPP
+
+#include "../common/aliases.hpp"  // `byte`
+
+/**
+ * @enum OutputFormat
+ *
+ * @brief Enum class que representa o formato em que os resultados são escritos na saída padrão (`--format`).
+ */
+enum class OutputFormat : byte
+{
+  TABLE,   //!< Tabela alinhada, para leitura humana (padrão).
+  CSV,     //!< Uma linha de cabeçalho e uma linha por arquivo, separadas por vírgulas (RFC 4180).
+  JSON,    //!< Um único documento JSON, com a lista de arquivos e os totais.
+  NDJSON,  //!< Um objeto JSON por linha: um por arquivo e, por último, os totais.
+};
+
+#endif  //!< OUTPUT_FORMAT_HPP
@@ -0,0 +1,319 @@
+/**
+ * @file result_writer.hpp
+ *
+ * @brief Define a classe ResultWriter, que escreve os resultados na saída padrão em um dos formatos suportados.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef RESULT_WRITER_HPP
+#define RESULT_WRITER_HPP
+
+// STL includes {{{
+#include <algorithm>  // `std::min`
+#include <array>      // `std::array`
+#include <charconv>   // `std::to_chars`
+#include <cstdint>    // `std::uint64_t`
+// }}}
+
+#include "../common/aliases.hpp"          // `str_view`, `size_t`
+#include "../core/sloc/lang_type.hpp"     // `LangType`
+#include "../core/sloc/result_store.hpp"  // `ResultStore::Counts`
+#include "output_buffer.hpp"              // `OutputBuffer`
+#include "output_format.hpp"              // `OutputFormat`
+
+/**
+ * @brief Escreve os resultados, linha a linha, no formato escolhido (`--format`).
+ *
+ * @details Uso: `begin`, uma chamada de `row` por arquivo e `end` com os totais (ou, com `--by-dir`,
+ * `begin_directories`, uma chamada de `directory` por diretório e `end`). Nada é guardado entre as linhas, então
+ * o mesmo escritor atende a tabela completa e a saída contínua (`--stream-output`).
+ *   - `TABLE`: a tabela alinhada de sempre (coluna de nomes com @a name_width bytes).
+ *   - `CSV`: cabeçalho e uma linha por arquivo, com os contadores absolutos; o `SUM` não entra (é a soma das colunas,
+ *     a não ser com `--dedupe-sum once`).
+ *   - `JSON`: `{"files": [...], "sum": {...}, "files_processed": N}`, um arquivo por linha do texto.
+ *   - `NDJSON`: um objeto por arquivo, um por linha, e por último `{"sum": {...}, "files_processed": N}`.
+ *
+ * Todos os valores vão direto para um `OutputBuffer` (sem `ostringstream` nem `std::setw` por célula).
+ */
+class ResultWriter
+{
+private:
+  static constexpr size_t TABLE_COLUMNS_WIDTH{ 94 };  //!< Largura das colunas da tabela, fora a dos nomes.
+
+  OutputBuffer m_out;           //!< Buffer da saída.
+  OutputFormat m_format;        //!< Formato da saída.
+  size_t m_name_width;          //!< Largura da coluna de nomes (só na tabela).
+  size_t m_n_rows{ 0 };         //!< Linhas escritas até agora.
+  bool m_directories{ false };  //!< Indica se as linhas são diretórios (`begin_directories`).
+
+  /**
+   * @brief Escreve uma linha horizontal da tabela, entre os cantos @a left e @a right.
+   */
+  void table_rule(str_view left, str_view right)
+  {
+    m_out.append(left).repeat("─", m_name_width + TABLE_COLUMNS_WIDTH).append(right).append('\n');
+  }
+
+  /**
+   * @brief Escreve uma célula "valor (porcentagem%)" da tabela, com 16 bytes.
+   */
+  void table_percentage(std::uint64_t value, std::uint64_t total)
+  {
+    char cell[64];
+    char* end{ std::to_chars(cell, cell + 20, value).ptr };
+    *end++ = ' ';
+    *end++ = '(';
+    const double percentage{ total == 0 ? 0.0 : static_cast<double>(value) * 100.0 / static_cast<double>(total) };
+    end = std::to_chars(end, cell + sizeof(cell) - 2, percentage, std::chars_format::fixed, 1).ptr;
+    *end++ = '%';
+    *end++ = ')';
+    m_out.append_left(str_view{ cell, static_cast<size_t>(end - cell) }, 16);
+  }
+
+  /**
+   * @brief Escreve @a text como um campo CSV: entre aspas (dobradas por dentro) só se tiver vírgula, aspas ou quebra
+   * de linha.
+   */
+  void csv_field(str_view text)
+  {
+    if (text.find_first_of(",\"\r\n") == str_view::npos)
+    {
+      m_out.append(text);
+      return;
+    }
+    m_out.append('"');
+    for (const char c : text)
+    {
+      if (c == '"')
+      {
+        m_out.append('"');
+      }
+      m_out.append(c);
+    }
+    m_out.append('"');
+  }
+
+  /**
+   * @brief Escreve os contadores de @a counts como membros de um objeto JSON (sem as chaves).
+   */
+  void json_counts(const ResultStore::Counts& counts)
+  {
+    m_out.append("\"comments\": ").append_uint(counts.n_reg_comments);
+    m_out.append(", \"doc_comments\": ").append_uint(counts.n_doc_comments);
+    m_out.append(", \"blank\": ").append_uint(counts.n_blank_lines);
+    m_out.append(", \"code\": ").append_uint(counts.n_loc);
+    m_out.append(", \"lines\": ").append_uint(counts.n_lines);
+  }
+
+  /**
+   * @brief Escreve um arquivo como objeto JSON, numa única linha (sem a quebra de linha).
+   */
+  void json_file(str_view path, LangType type, const ResultStore::Counts& counts)
+  {
+    m_out.append("{\"filename\": ");
+    m_out.append_json_string(path);
+    m_out.append(", \"language\": ");
+    m_out.append_json_string(language_name(type));
+    m_out.append(", ");
+    json_counts(counts);
+    m_out.append('}');
+  }
+
+public:
+  /**
+   * @brief Cria um escritor no formato @a format.
+   *
+   * @param name_width  Largura da coluna de nomes na tabela (ignorada nos outros formatos).
+   * @param fd          Descritor de destino (por padrão, a saída padrão).
+   */
+  ResultWriter(OutputFormat format, size_t name_width, int fd = STDOUT_FILENO)
+    : m_out{ fd }, m_format{ format }, m_name_width{ name_width }
+  {
+  }
+
+  /**
+   * @brief Retorna o nome de exibição da linguagem @a type.
+   */
+  static str_view language_name(LangType type)
+  {
+    static constexpr std::array<str_view, 5> NAMES{ "C", "C/C++ header", "C++", "C++ header", "" };
+    return NAMES[static_cast<size_t>(type)];
+  }
+
+  /// @brief Escreve na saída tudo o que está no buffer (na saída contínua, para cada linha aparecer logo).
+  void flush() { m_out.flush(); }
+
+  /**
+   * @brief Escreve o cabeçalho.
+   */
+  void begin()
+  {
+    switch (m_format)
+    {
+    case OutputFormat::TABLE:
+      table_rule("┌", "┐");
+      m_out.append("│ ").append_left("Filename", m_name_width + 2);
+      m_out.append_left("Language", 16).append_left("Comments", 16).append_left("Doc Comments", 16);
+      m_out.append_left("Blank", 16).append_left("Code", 16).append_left("# of lines", 10).append(" │\n");
+      table_rule("├", "┤");
+      break;
+    case OutputFormat::CSV:
+      m_out.append("filename,language,comments,doc_comments,blank,code,lines\n");
+      break;
+    case OutputFormat::JSON:
+      m_out.append("{\"files\": [");
+      break;
+    case OutputFormat::NDJSON:
+      break;
+    }
+  }
+
+  /**
+   * @brief Escreve a linha de um arquivo.
+   */
+  void row(str_view path, LangType type, const ResultStore::Counts& counts)
+  {
+    switch (m_format)
+    {
+    case OutputFormat::TABLE:
+    {
+      // [!] As porcentagens usam a soma das quatro categorias (mais 2) como total, como sempre fizeram.
+      const std::uint64_t total_lines{ counts.n_blank_lines + counts.n_doc_comments + counts.n_loc + counts.n_reg_comments + 2 };
+      m_out.append("│ ").append_left(path, m_name_width + 2).append_left(language_name(type), 16);
+      table_percentage(counts.n_reg_comments, total_lines);
+      table_percentage(counts.n_doc_comments, total_lines);
+      table_percentage(counts.n_blank_lines, total_lines);
+      table_percentage(counts.n_loc, total_lines);
+      m_out.append_left(counts.n_lines, 10).append(" │\n");
+      break;
+    }
+    case OutputFormat::CSV:
+      csv_field(path);
+      m_out.append(',').append(language_name(type));
+      m_out.append(',').append_uint(counts.n_reg_comments).append(',').append_uint(counts.n_doc_comments);
+      m_out.append(',').append_uint(counts.n_blank_lines).append(',').append_uint(counts.n_loc);
+      m_out.append(',').append_uint(counts.n_lines).append('\n');
+      break;
+    case OutputFormat::JSON:
+      m_out.append(m_n_rows == 0 ? "\n  " : ",\n  ");
+      json_file(path, type, counts);
+      break;
+    case OutputFormat::NDJSON:
+      json_file(path, type, counts);
+      m_out.append('\n');
+      break;
+    }
+    ++m_n_rows;
+  }
+
+  /**
+   * @brief Escreve o cabeçalho da saída por diretório (`--by-dir`), no lugar de `begin`.
+   */
+  void begin_directories()
+  {
+    m_directories = true;
+    switch (m_format)
+    {
+    case OutputFormat::TABLE:
+      table_rule("┌", "┐");
+      m_out.append("│ ").append_left("Directory", m_name_width + 2);
+      m_out.append_left("Files", 16).append_left("Comments", 16).append_left("Doc Comments", 16);
+      m_out.append_left("Blank", 16).append_left("Code", 16).append_left("# of lines", 10).append(" │\n");
+      table_rule("├", "┤");
+      break;
+    case OutputFormat::CSV:
+      m_out.append("directory,depth,files,comments,doc_comments,blank,code,lines\n");
+      break;
+    case OutputFormat::JSON:
+      m_out.append("{\"directories\": [");
+      break;
+    case OutputFormat::NDJSON:
+      break;
+    }
+  }
+
+  /**
+   * @brief Escreve a linha de um diretório, com os totais da sua subárvore.
+   *
+   * @param label    Nome exibido na tabela (recuado 2 espaços por nível).
+   * @param path     Caminho completo (nos outros formatos).
+   * @param depth    Profundidade na árvore exibida (0 no topo).
+   * @param n_files  Arquivos da subárvore.
+   */
+  void directory(str_view label, str_view path, size_t depth, std::uint64_t n_files, const ResultStore::Counts& counts)
+  {
+    switch (m_format)
+    {
+    case OutputFormat::TABLE:
+      m_out.append("│ ").fill(' ', 2 * depth).append_left(label, m_name_width + 2 - std::min(m_name_width + 2, 2 * depth));
+      m_out.append_left(n_files, 16).append_left(counts.n_reg_comments, 16).append_left(counts.n_doc_comments, 16);
+      m_out.append_left(counts.n_blank_lines, 16).append_left(counts.n_loc, 16).append_left(counts.n_lines, 10).append(" │\n");
+      break;
+    case OutputFormat::CSV:
+      csv_field(path);
+      m_out.append(',').append_uint(depth).append(',').append_uint(n_files);
+      m_out.append(',').append_uint(counts.n_reg_comments).append(',').append_uint(counts.n_doc_comments);
+      m_out.append(',').append_uint(counts.n_blank_lines).append(',').append_uint(counts.n_loc);
+      m_out.append(',').append_uint(counts.n_lines).append('\n');
+      break;
+    case OutputFormat::JSON:
+    case OutputFormat::NDJSON:
+      m_out.append(m_format == OutputFormat::NDJSON ? "" : m_n_rows == 0 ? "\n  " : ",\n  ");
+      m_out.append("{\"directory\": ");
+      m_out.append_json_string(path);
+      m_out.append(", \"depth\": ").append_uint(depth).append(", \"files\": ").append_uint(n_files).append(", ");
+      json_counts(counts);
+      m_out.append(m_format == OutputFormat::NDJSON ? "}\n" : "}");
+      break;
+    }
+    ++m_n_rows;
+  }
+
+  /**
+   * @brief Escreve os totais @a sum (de @a n_files arquivos) e esvazia o buffer.
+   */
+  void end(const ResultStore::Counts& sum, size_t n_files)
+  {
+    switch (m_format)
+    {
+    case OutputFormat::TABLE:
+      table_rule("├", "┤");
+      // [!] Na saída por diretório, a coluna da linguagem dá lugar ao número de arquivos.
+      m_out.append("│ ").append_left("SUM", m_name_width + 2);
+      if (m_directories)
+      {
+        m_out.append_left(n_files, 16);
+      }
+      else
+      {
+        m_out.fill(' ', 16);
+      }
+      m_out.append_left(sum.n_reg_comments, 16).append_left(sum.n_doc_comments, 16).append_left(sum.n_blank_lines, 16);
+      m_out.append_left(sum.n_loc, 16).append_left(sum.n_lines, 10).append(" │\n");
+      table_rule("└", "┘");
+      break;
+    case OutputFormat::CSV:
+      break;
+    case OutputFormat::JSON:
+      m_out.append(m_n_rows == 0 ? "],\n \"sum\": {" : "\n ],\n \"sum\": {");
+      json_counts(sum);
+      m_out.append("},\n \"files_processed\": ").append_uint(n_files).append("}\n");
+      break;
+    case OutputFormat::NDJSON:
+      m_out.append("{\"sum\": {");
+      json_counts(sum);
+      m_out.append("}, \"files_processed\": ").append_uint(n_files).append("}\n");
+      break;
+    }
+    m_out.flush();
+  }
+};
+
+#endif  //!< RESULT_WRITER_HPP
@@ -15,9 +15,17 @@
 #ifndef RUNNING_OPTIONS_HPP
 #define RUNNING_OPTIONS_HPP
 
+#include <limits>  // `std::numeric_limits`
+
 #include "../common/aliases.hpp"            // `option`, `vec`
+#include "../common/constants.hpp"          // `SPLIT_MIN_SIZE`, `PIPELINE_QUEUE_DEPTH`
+#include "../core/cache/cache_mode.hpp"     // `CacheMode`
 #include "../core/filter/field_option.hpp"  // `FieldOption`
+#include "../core/io/input_mode.hpp"        // `InputMode`
+#include "../core/io/output_format.hpp"     // `OutputFormat`
 #include "../core/sloc/file_info.hpp"       // `FileInfo`
+#include "../core/sloc/lang_type.hpp"       // `LangType`
+#include "../core/sloc/scan_engine.hpp"     // `ScanEngine`
 
 /**
  * @struct RunningOptions
@@ -32,7 +40,28 @@ struct RunningOptions
 {
   option recursive{ false };                    //!< Sinalizador de análise recursiva (predefinição: false).
   option ascending{ false };                    //!< Sinalizador de tipo de ordenação (default: descendente).
-  FieldOption sort_field{ FieldOption::NONE };  //!< Campo de ordenação para a saída da tabela.
+  vec<FieldOption> sort_fields;                 //!< Chaves de ordenação da tabela, da principal para a última.
+  size_t top{ 0 };                              //!< Se maior que zero, só as `top` primeiras linhas são exibidas.
+  size_t n_workers{ 1 };                        //!< Número de threads usadas na análise dos arquivos.
+  option worker_stats{ false };                 //!< Sinalizador de relatório de tempo ocupado/ocioso por worker.
+  option stats{ false };                        //!< Sinalizador do perfil da execução por fase (`--stats`).
+  str trace_file;                               //!< Arquivo do trace de eventos (`--trace`); vazio se não pedido.
+  ScanEngine engine{ ScanEngine::DFA };         //!< Motor de análise de linhas.
+  InputMode input_mode{ InputMode::MAPPED };    //!< Modo de leitura dos arquivos (mapeado ou em blocos).
+  LangType stdin_lang{ LangType::CPP };         //!< Linguagem atribuída à entrada padrão (`sloc -`).
+  size_t split_size{ SPLIT_MIN_SIZE };          //!< Tamanho a partir do qual um arquivo é dividido entre workers (0: nunca).
+  option pipeline{ false };                     //!< Sinalizador de descoberta e análise sobrepostas (`--pipeline`).
+  size_t queue_depth{ PIPELINE_QUEUE_DEPTH };   //!< Capacidade das filas entre os estágios do *pipeline*.
+  CacheMode cache_mode{ CacheMode::USE };       //!< Uso do cache de resultados (`ResultCache`).
+  option dedupe{ false };                       //!< Sinalizador de detecção de arquivos idênticos (`--dedupe`).
+  option duplicates_once{ false };              //!< Se `true`, cópias idênticas entram uma única vez no `SUM`.
+  option git{ false };                          //!< Sinalizador de descoberta pelo índice do git (`--git`).
+  option stream_output{ false };                //!< Sinalizador de saída contínua, linha a linha (`--stream-output`).
+  size_t name_width{ STREAM_NAME_WIDTH };       //!< Largura da coluna de nomes na saída contínua.
+  OutputFormat format{ OutputFormat::TABLE };   //!< Formato da saída dos resultados (`--format`).
+  option by_dir{ false };                       //!< Sinalizador de totais por diretório (`--by-dir`).
+  size_t by_dir_depth{ std::numeric_limits<size_t>::max() };  //!< Profundidade máxima exibida com `--by-dir`.
+  vec<str> inputs;                              //!< Entradas informadas pelo usuário (arquivos, diretórios ou `-`).
   vec<FileInfo> sources;                        //!< Lista de arquivos de código fonte.
 };
 
@@ -0,0 +1,150 @@
+/**
+ * @file bounded_queue.hpp
+ *
+ * @brief Define a classe BoundedQueue, uma fila de capacidade limitada com vários produtores e consumidores.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-02
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+// STL includes {{{
+#include <algorithm>           // `std::max`
+#include <condition_variable>  // `std::condition_variable`
+#include <deque>               // `std::deque`
+#include <mutex>               // `std::mutex`
+#include <optional>            // `std::optional`
+// }}}
+
+#include "../common/aliases.hpp"       // `size_t`
+#include "../core/profile/trace.hpp"  // `Trace`
+
+/**
+ * @brief Fila MPMC (vários produtores, vários consumidores) com capacidade limitada e fechamento explícito.
+ *
+ * @details `push` bloqueia enquanto a fila está cheia: é isso que cria a contrapressão entre os estágios de um
+ * *pipeline*, pois um produtor mais rápido que os consumidores fica esperando em vez de acumular itens na memória.
+ * `pop` bloqueia enquanto a fila está vazia e ainda aberta. Depois de `close`, os itens restantes continuam sendo
+ * entregues e, quando acabam, `pop` devolve `std::nullopt`, o que sinaliza o fim do estágio anterior.
+ */
+template <typename T>
+class BoundedQueue
+{
+private:
+  std::deque<T> m_items{};                //!< Itens na fila, do mais antigo para o mais novo.
+  size_t m_capacity;                      //!< Quantidade máxima de itens na fila.
+  bool m_closed{ false };                 //!< Indica que nenhum item novo será inserido.
+  size_t m_n_full_waits{ 0 };             //!< Quantas vezes um produtor esperou com a fila cheia.
+  size_t m_waiting_producers{ 0 };        //!< Produtores esperando por espaço.
+  size_t m_waiting_consumers{ 0 };        //!< Consumidores esperando por itens.
+  std::mutex m_mutex{};                   //!< Protege todos os membros acima.
+  std::condition_variable m_not_full{};   //!< Acorda produtores quando há espaço.
+  std::condition_variable m_not_empty{};  //!< Acorda consumidores quando há itens (ou a fila foi fechada).
+
+public:
+  /**
+   * @brief Cria uma fila com espaço para @a capacity itens (no mínimo 1).
+   */
+  explicit BoundedQueue(size_t capacity) : m_capacity{ std::max(size_t{ 1 }, capacity) } { /* empty */ }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * @brief Insere @a item no fim da fila, esperando enquanto ela estiver cheia.
+   *
+   * @return bool  `false` (e @a item descartado) se a fila já foi fechada.
+   */
+  bool push(T item)
+  {
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    if (m_items.size() >= m_capacity and not m_closed)
+    {
+      ++m_n_full_waits;
+      ++m_waiting_producers;
+      const auto waited{ Trace::now() };
+      m_not_full.wait(lock, [this] { return m_items.size() < m_capacity or m_closed; });
+      Trace::wait("wait (queue full)", waited, Trace::now());
+      --m_waiting_producers;
+    }
+    if (m_closed)
+    {
+      return false;
+    }
+
+    m_items.push_back(std::move(item));
+    const bool wake{ m_waiting_consumers > 0 };  // [!] Ninguém esperando: evita a chamada de sistema do `notify`.
+    lock.unlock();
+    if (wake)
+    {
+      m_not_empty.notify_one();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Retira o item mais antigo, esperando enquanto a fila estiver vazia e aberta.
+   *
+   * @details Um produtor que esperou pela fila cheia só é acordado quando ela cai para a metade da capacidade. Sem essa
+   * folga, produtor e consumidor se alternariam a cada item (uma troca de contexto por item) assim que a fila enchesse.
+   *
+   * @return std::optional<T>  O item, ou `std::nullopt` se a fila foi fechada e não há mais itens.
+   */
+  std::optional<T> pop()
+  {
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    if (m_items.empty() and not m_closed)
+    {
+      ++m_waiting_consumers;
+      const auto waited{ Trace::now() };
+      m_not_empty.wait(lock, [this] { return not m_items.empty() or m_closed; });
+      Trace::wait("wait (queue empty)", waited, Trace::now());
+      --m_waiting_consumers;
+    }
+    if (m_items.empty())
+    {
+      return std::nullopt;
+    }
+
+    std::optional<T> item{ std::move(m_items.front()) };
+    m_items.pop_front();
+    const bool wake{ m_waiting_producers > 0 and m_items.size() <= m_capacity / 2 };
+    lock.unlock();
+    if (wake)
+    {
+      m_not_full.notify_one();
+    }
+    return item;
+  }
+
+  /**
+   * @brief Fecha a fila: produtores não podem mais inserir, e consumidores recebem `std::nullopt` quando ela esvaziar.
+   */
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock{ m_mutex };
+      m_closed = true;
+    }
+    m_not_full.notify_all();
+    m_not_empty.notify_all();
+  }
+
+  /**
+   * @brief Retorna quantas vezes um produtor encontrou a fila cheia (uma medida da contrapressão).
+   */
+  size_t n_full_waits()
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_n_full_waits;
+  }
+};
+
+#endif  //!< BOUNDED_QUEUE_HPP
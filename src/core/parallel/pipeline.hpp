@@ -0,0 +1,221 @@
+/**
+ * @file pipeline.hpp
+ *
+ * @brief Define a classe Pipeline, que sobrepõe a descoberta dos arquivos, a leitura/análise e o relatório.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-02
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+// STL includes {{{
+#include <algorithm>   // `std::max`
+#include <atomic>      // `std::atomic`
+#include <chrono>      // `std::chrono::steady_clock`
+#include <functional>  // `std::function`, `std::ref`
+#include <optional>    // `std::optional`
+#include <thread>      // `std::thread`
+// }}}
+
+// Outros includes {{{
+#include "../common/aliases.hpp"  // `str`, `vec`, `size_t`
+#include "../core/cache/result_cache.hpp"
+#include "../core/filter/filter.hpp"
+#include "../core/options/running_options.hpp"
+#include "../core/profile/trace.hpp"
+#include "../core/sloc/file_info.hpp"
+#include "../core/sloc/result_store.hpp"
+#include "../core/sloc/sloc.hpp"
+#include "bounded_queue.hpp"
+#include "worker_pool.hpp"
+// }}}
+
+/**
+ * @brief Estatísticas de uma execução do *pipeline*, em segundos desde o início.
+ */
+struct PipelineStats
+{
+  double first_result_seconds{ 0.0 };  //!< Até o primeiro arquivo analisado chegar ao relator.
+  double discovery_seconds{ 0.0 };     //!< Até a descoberta terminar.
+  double wall_seconds{ 0.0 };          //!< Até o último arquivo analisado chegar ao relator.
+  size_t n_discovery_waits{ 0 };       //!< Vezes que a descoberta esperou por espaço na fila (contrapressão).
+};
+
+/**
+ * @brief *Pipeline* de três estágios: descoberta → leitura e análise → relatório.
+ *
+ * @details
+ *   - Descoberta (uma thread): percorre as entradas com `Filter::discover` em modo sequencial e insere cada arquivo,
+ *     assim que encontrado, numa fila limitada.
+ *   - Leitura e análise (`n_workers` threads): cada worker retira arquivos da fila, analisa com seu próprio `Sloc` e
+ *     insere o resultado numa segunda fila limitada.
+ *   - Relatório (a thread chamadora): retira os resultados, devolve cada arquivo à sua posição de descoberta e soma os
+ *     totais.
+ *
+ * Assim a travessia de diretórios e a análise dos arquivos se sobrepõem: com o cache frio, os workers começam a ler
+ * os primeiros arquivos enquanto a descoberta ainda espera pelo disco, e o primeiro resultado chega bem antes do fim
+ * da travessia. As filas limitam a memória: se a análise não acompanha a descoberta, a descoberta espera (a
+ * capacidade das filas, `--queue-depth`, regula essa contrapressão).
+ *
+ * Como os arquivos chegam à análise na ordem de descoberta, não há escalonamento do maior para o menor nem divisão de
+ * arquivos enormes: para entradas com poucos arquivos muito grandes, o `WorkerPool` continua sendo a melhor opção.
+ */
+class Pipeline
+{
+private:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Um arquivo e sua posição na ordem de descoberta.
+   */
+  struct Record
+  {
+    size_t index{ 0 };  //!< Posição do arquivo na ordem de descoberta.
+    FileInfo file{};    //!< Arquivo (com as contagens, depois da análise).
+  };
+
+  /**
+   * @brief Laço de cada worker: analisa arquivos de @a files até a fila ser fechada e esvaziar.
+   *
+   * @param files       Fila de arquivos descobertos.
+   * @param results     Fila de arquivos analisados.
+   * @param engine      Motor de análise de linhas.
+   * @param input_mode  Modo de leitura dos arquivos.
+   * @param cache       Cache de resultados (ou `nullptr`).
+   * @param stats       Estatísticas exclusivas deste worker.
+   * @param running     Workers ainda ativos; o último a terminar fecha @a results.
+   * @param self        Índice deste worker (só para o trace).
+   */
+  static void scan(BoundedQueue<Record>& files, BoundedQueue<Record>& results, ScanEngine engine, InputMode input_mode,
+                   const ResultCache* cache, WorkerStats& stats, std::atomic<size_t>& running, size_t self)
+  {
+    Trace::name_thread("worker " + std::to_string(self));
+    Sloc sloc_counter{ engine, input_mode };  //!< Máquina de estados (e buffers de leitura) exclusiva deste worker.
+
+    while (std::optional<Record> record{ files.pop() })
+    {
+      if (cache != nullptr and cache->lookup(record->file))
+      {
+        results.push(std::move(*record));  // [!] Arquivo inalterado: as contagens vieram do cache.
+        continue;
+      }
+
+      const auto start{ clock::now() };
+      sloc_counter.analyze_file(record->file);
+      stats.busy_seconds += std::chrono::duration<double>(clock::now() - start).count();
+      stats.n_bytes += record->file.m_size;
+      stats.n_files++;
+
+      results.push(std::move(*record));
+    }
+
+    if (running.fetch_sub(1) == 1)
+    {
+      results.close();  // [!] Último worker: não haverá mais resultados.
+    }
+  }
+
+public:
+  /**
+   * @brief Descobre e analisa os arquivos de @a options.inputs, com os estágios sobrepostos.
+   *
+   * @param options         Opções de execução (entradas, recursão, workers, motor, modo de leitura, capacidade).
+   * @param results         Recebe os arquivos analisados, uma linha por arquivo na ordem de descoberta (a mesma de
+   *                        `Filter::filter`).
+   * @param cache           Se não for nulo, arquivos inalterados desde a última execução não são analisados.
+   * @param stats           Se não for nulo, recebe as estatísticas de cada worker.
+   * @param pipeline_stats  Se não for nulo, recebe as estatísticas do *pipeline*.
+   * @param report          Se não for vazio, recebe cada arquivo analisado assim que ele chega ao relator (na ordem
+   *                        de término), e @a results fica vazio: a memória não cresce com o número de arquivos.
+   *
+   * @return FileInfo  Totais gerais (soma de todos os arquivos).
+   */
+  static FileInfo run(const RunningOptions& options, ResultStore& results, const ResultCache* cache = nullptr,
+                      vec<WorkerStats>* stats = nullptr, PipelineStats* pipeline_stats = nullptr,
+                      const std::function<void(const FileInfo&)>& report = {})
+  {
+    const size_t n_workers{ std::max(size_t{ 1 }, options.n_workers) };
+
+    BoundedQueue<Record> discovered{ options.queue_depth };  //!< Descoberta → análise.
+    BoundedQueue<Record> analyzed{ options.queue_depth };    //!< Análise → relatório.
+    std::atomic<size_t> running{ n_workers };                //!< Workers ainda ativos.
+    vec<WorkerStats> worker_stats(n_workers);                //!< Estatísticas de cada worker.
+    PipelineStats timings{};                                 //!< Estatísticas do *pipeline*.
+
+    const auto start{ clock::now() };
+    auto elapsed{ [start] { return std::chrono::duration<double>(clock::now() - start).count(); } };
+
+    // [!] Estágio 1: descoberta sequencial, entregando cada arquivo assim que ele é encontrado.
+    std::thread discovery{ [&] {
+      Trace::name_thread("discovery");
+      const auto traced{ Trace::now() };
+      size_t index{ 0 };
+      Filter::discover(options.inputs, options.recursive, options.stdin_lang, 0,
+                       [&](FileInfo&& file) { discovered.push(Record{ index++, std::move(file) }); }, options.git);
+      discovered.close();
+      timings.discovery_seconds = elapsed();
+      Trace::span("discovery", traced, Trace::now());
+    } };
+
+    // [!] Estágio 2: leitura e análise.
+    vec<std::thread> workers{};
+    workers.reserve(n_workers);
+    for (size_t w{ 0 }; w < n_workers; ++w)
+    {
+      workers.emplace_back(scan, std::ref(discovered), std::ref(analyzed), options.engine, options.input_mode, cache,
+                           std::ref(worker_stats[w]), std::ref(running), w);
+    }
+
+    // [!] Estágio 3: relatório, na thread chamadora. Cada arquivo volta à sua posição de descoberta.
+    FileInfo total{};
+    results = ResultStore{};
+    bool first{ true };
+    while (std::optional<Record> record{ analyzed.pop() })
+    {
+      if (first)
+      {
+        timings.first_result_seconds = elapsed();
+        first = false;
+      }
+      total += record->file;
+      if (report)
+      {
+        report(record->file);  // [!] Modo contínuo: só os totais são mantidos.
+        continue;
+      }
+      results.assign(record->index, record->file);
+    }
+    timings.wall_seconds = elapsed();
+
+    discovery.join();
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+    timings.n_discovery_waits = discovered.n_full_waits();
+
+    if (stats != nullptr)
+    {
+      for (auto& worker : worker_stats)
+      {
+        worker.idle_seconds = std::max(0.0, timings.wall_seconds - worker.busy_seconds);
+      }
+      *stats = std::move(worker_stats);
+    }
+    if (pipeline_stats != nullptr)
+    {
+      *pipeline_stats = timings;
+    }
+
+    return total;
+  }
+};
+
+#endif  //!< PIPELINE_HPP
@@ -0,0 +1,343 @@
+/**
+ * @file worker_pool.hpp
+ *
+ * @brief Define a classe WorkerPool, responsável por distribuir a análise dos arquivos entre várias threads.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+// STL includes {{{
+#include <algorithm>   // `std::min`, `std::stable_sort`
+#include <chrono>      // `std::chrono::steady_clock`
+#include <deque>       // `std::deque`
+#include <functional>  // `std::ref`, `std::cref`
+#include <limits>      // `std::numeric_limits`
+#include <mutex>       // `std::mutex`
+#include <optional>    // `std::optional`
+#include <thread>      // `std::thread`
+// }}}
+
+// Outros includes {{{
+#include "../common/aliases.hpp"    // `vec`, `size_t`
+#include "../common/constants.hpp"  // `CACHE_LINE_SIZE`, `SPLIT_CHUNK_SIZE`
+#include "../core/cache/result_cache.hpp"
+#include "../core/io/input_mode.hpp"
+#include "../core/profile/trace.hpp"
+#include "../core/sloc/file_info.hpp"
+#include "../core/sloc/sloc.hpp"
+#include "../core/sloc/speculative_scan.hpp"
+// }}}
+
+/**
+ * @brief Estatísticas de execução de um worker.
+ */
+struct WorkerStats
+{
+  double busy_seconds{ 0.0 };   //!< Tempo gasto analisando arquivos.
+  double idle_seconds{ 0.0 };   //!< Tempo gasto procurando trabalho ou esperando os demais terminarem.
+  size_t n_files{ 0 };          //!< Quantidade de arquivos analisados.
+  size_t n_stolen{ 0 };         //!< Quantos desses arquivos foram roubados da fila de outro worker.
+  std::uintmax_t n_bytes{ 0 };  //!< Quantidade de bytes analisados.
+};
+
+/**
+ * @brief Conjunto de threads que analisam os arquivos de entrada em paralelo.
+ *
+ * @details Cada worker possui sua própria máquina de estados (`Sloc`), seu próprio acumulador de totais e sua própria
+ * fila (deque) de arquivos. Os arquivos são ordenados do maior para o menor (o tamanho é conhecido desde a descoberta)
+ * e distribuídos em rodízio entre as filas, então todos os workers começam pelos maiores arquivos. Cada worker consome
+ * a frente da sua fila; quando ela esvazia, rouba o fim da fila de outro worker. Assim, um arquivo enorme prende apenas
+ * um worker, enquanto os demais esvaziam o restante do trabalho.
+ *
+ * Arquivos a partir de `split_size` bytes viram várias tarefas, uma por pedaço de `SPLIT_CHUNK_SIZE` bytes, analisados
+ * de forma especulativa (`SpeculativeScan`) por quem os pegar; depois que todos os workers terminam, os pedaços de
+ * cada arquivo são costurados em ordem. Assim nenhum arquivo, por maior que seja, prende um único núcleo.
+ *
+ * Como cada arquivo é escrito por um único worker, os resultados de `files` mantêm a ordem original. Ao final, os
+ * acumuladores de cada thread são reduzidos em um único `FileInfo` com os totais gerais.
+ */
+class WorkerPool
+{
+private:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Uma tarefa: um arquivo inteiro ou um pedaço de um arquivo dividido.
+   */
+  struct Task
+  {
+    size_t file{ 0 };          //!< Índice do arquivo em `files`.
+    size_t chunk{ 0 };         //!< Índice do pedaço (sempre 0 para arquivos inteiros).
+    std::uintmax_t size{ 0 };  //!< Bytes a analisar, usado no escalonamento.
+  };
+
+  /// @brief Marca, em `split_of`, os arquivos que não foram divididos.
+  static constexpr size_t NOT_SPLIT{ std::numeric_limits<size_t>::max() };
+
+  /**
+   * @brief Um arquivo dividido em pedaços e os resultados especulativos de cada um.
+   */
+  struct SplitFile
+  {
+    size_t file{ 0 };                      //!< Índice do arquivo em `files`.
+    size_t chunk_size{ 0 };                //!< Tamanho nominal de cada pedaço.
+    vec<SpeculativeScan::Chunk> chunks{};  //!< Resultado de cada pedaço (cada um escrito por um único worker).
+  };
+
+  /**
+   * @brief Fila de trabalho de um worker, alinhada à linha de cache.
+   *
+   * @details O alinhamento evita *false sharing*: filas e acumuladores de threads diferentes nunca dividem a mesma
+   * linha de cache, então as operações de um worker não invalidam o cache dos demais.
+   */
+  struct alignas(CACHE_LINE_SIZE) WorkQueue
+  {
+    std::mutex mutex{};      //!< Protege `tasks` (o dono e os ladrões disputam a mesma fila).
+    std::deque<Task> tasks;  //!< Tarefas ainda não executadas, da maior para a menor.
+  };
+
+  /**
+   * @brief Acumulador de totais de um worker, alinhado à linha de cache.
+   */
+  struct alignas(CACHE_LINE_SIZE) Accumulator
+  {
+    FileInfo total{};     //!< Totais parciais dos arquivos analisados por este worker.
+    WorkerStats stats{};  //!< Estatísticas de execução deste worker.
+  };
+
+  /**
+   * @brief Retira a próxima tarefa da própria fila (pela frente: maiores primeiro).
+   */
+  static std::optional<Task> pop(WorkQueue& queue)
+  {
+    std::lock_guard<std::mutex> lock{ queue.mutex };
+    if (queue.tasks.empty())
+    {
+      return std::nullopt;
+    }
+    const Task task{ queue.tasks.front() };
+    queue.tasks.pop_front();
+    return task;
+  }
+
+  /**
+   * @brief Rouba uma tarefa do fim da fila de outro worker.
+   */
+  static std::optional<Task> steal(WorkQueue& queue)
+  {
+    std::lock_guard<std::mutex> lock{ queue.mutex };
+    if (queue.tasks.empty())
+    {
+      return std::nullopt;
+    }
+    const Task task{ queue.tasks.back() };
+    queue.tasks.pop_back();
+    return task;
+  }
+
+  /**
+   * @brief Laço executado por cada worker.
+   *
+   * @details Como nenhuma tarefa gera novas tarefas, um worker pode encerrar assim que encontra todas as filas vazias.
+   *
+   * @param files        Arquivos a serem analisados.
+   * @param splits       Arquivos divididos em pedaços, indexados por `split_of`.
+   * @param split_of     Para cada arquivo, sua posição em @a splits (ou `NOT_SPLIT`).
+   * @param queues       Filas de todos os workers.
+   * @param self         Índice do worker atual em @a queues.
+   * @param engine       Motor de análise de linhas.
+   * @param input_mode   Modo de leitura dos arquivos.
+   * @param accumulator  Acumulador exclusivo deste worker.
+   */
+  static void work(vec<FileInfo>& files, vec<SplitFile>& splits, const vec<size_t>& split_of, vec<WorkQueue>& queues,
+                   size_t self, ScanEngine engine, InputMode input_mode, Accumulator& accumulator)
+  {
+    Sloc sloc_counter{ engine, input_mode };  //!< Máquina de estados (e buffers de leitura) exclusiva deste worker.
+    if (self > 0)
+    {
+      Trace::name_thread("worker " + std::to_string(self));  // [!] O worker 0 é a thread chamadora.
+    }
+
+    while (true)
+    {
+      std::optional<Task> task{ pop(queues[self]) };
+
+      // [!] Fila própria vazia: tenta roubar dos demais, começando pelo vizinho.
+      for (size_t offset{ 1 }; not task and offset < queues.size(); ++offset)
+      {
+        task = steal(queues[(self + offset) % queues.size()]);
+        accumulator.stats.n_stolen += task ? 1 : 0;
+      }
+
+      if (not task)
+      {
+        break;  // [!] Não há mais trabalho em nenhuma fila.
+      }
+
+      FileInfo& file{ files[task->file] };
+      const auto start{ clock::now() };
+
+      if (split_of[task->file] != NOT_SPLIT)
+      {
+        // [!] Pedaço de um arquivo dividido: o resultado só entra nos totais depois da costura.
+        SplitFile& split{ splits[split_of[task->file]] };
+        sloc_counter.analyze_chunk(file, task->chunk, split.chunks.size(), split.chunk_size, split.chunks[task->chunk]);
+        accumulator.stats.n_files += task->chunk == 0 ? 1 : 0;
+      }
+      else
+      {
+        sloc_counter.analyze_file(file);
+        accumulator.total += file;
+        accumulator.stats.n_files++;
+      }
+
+      accumulator.stats.busy_seconds += std::chrono::duration<double>(clock::now() - start).count();
+      accumulator.stats.n_bytes += task->size;
+    }
+  }
+
+public:
+  /**
+   * @brief Retorna o número de workers padrão: a quantidade de núcleos detectada.
+   */
+  static size_t default_workers()
+  {
+    const size_t n_cores{ std::thread::hardware_concurrency() };
+    return n_cores == 0 ? 1 : n_cores;  // [!] `hardware_concurrency` pode retornar 0 quando não consegue detectar.
+  }
+
+  /**
+   * @brief Analisa todos os arquivos usando até @a n_workers threads.
+   *
+   * @details Com um único worker (ou uma única tarefa) a análise é feita na própria thread chamadora, sem criar
+   * threads, o que equivale ao caminho sequencial.
+   *
+   * @param files       Arquivos a serem analisados. As contagens de cada um são preenchidas no lugar.
+   * @param n_workers   Número máximo de threads a serem utilizadas.
+   * @param engine      Motor de análise de linhas usado por todos os workers.
+   * @param input_mode  Modo de leitura dos arquivos usado por todos os workers.
+   * @param split_size  Arquivos a partir deste tamanho (em bytes) são divididos em pedaços analisados em paralelo
+   *                    (0 desliga a divisão). Só vale no modo `InputMode::MAPPED` e com mais de um worker.
+   * @param cache       Se não for nulo, arquivos inalterados desde a última execução recebem as contagens guardadas
+   *                    e não viram tarefas.
+   * @param stats       Se não for nulo, recebe as estatísticas de cada worker (tempo ocupado/ocioso).
+   *
+   * @return FileInfo  Totais gerais (soma de todos os arquivos).
+   */
+  static FileInfo analyze(vec<FileInfo>& files, size_t n_workers, ScanEngine engine, InputMode input_mode,
+                          size_t split_size, const ResultCache* cache = nullptr, vec<WorkerStats>* stats = nullptr)
+  {
+    const bool can_split{ n_workers > 1 and split_size > 0 and input_mode == InputMode::MAPPED };
+
+    // [!] Monta as tarefas: arquivos grandes o suficiente viram um pedaço por tarefa.
+    FileInfo total{};
+    vec<Task> tasks{};
+    vec<SplitFile> splits{};
+    vec<size_t> split_of(files.size(), NOT_SPLIT);
+    tasks.reserve(files.size());
+    for (size_t f{ 0 }; f < files.size(); ++f)
+    {
+      const std::uintmax_t size{ files[f].m_size };
+      if (cache != nullptr and cache->lookup(files[f]))
+      {
+        total += files[f];  // [!] Arquivo inalterado: as contagens vieram do cache.
+      }
+      else if (can_split and size >= split_size and size > SPLIT_CHUNK_SIZE)
+      {
+        const auto n_chunks{ static_cast<size_t>((size + SPLIT_CHUNK_SIZE - 1) / SPLIT_CHUNK_SIZE) };
+        split_of[f] = splits.size();
+        splits.push_back({ f, SPLIT_CHUNK_SIZE, vec<SpeculativeScan::Chunk>(n_chunks) });
+        for (size_t c{ 0 }; c < n_chunks; ++c)
+        {
+          tasks.push_back({ f, c, std::min<std::uintmax_t>(SPLIT_CHUNK_SIZE, size - c * SPLIT_CHUNK_SIZE) });
+        }
+      }
+      else
+      {
+        tasks.push_back({ f, 0, size });
+      }
+    }
+
+    // [!] Não faz sentido ter mais workers que tarefas.
+    n_workers = std::max(size_t{ 1 }, std::min(n_workers, tasks.size()));
+
+    // [!] Ordena as tarefas da maior para a menor (empates mantêm a ordem de descoberta).
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.size > b.size; });
+
+    vec<WorkQueue> queues(n_workers);          //!< Uma fila por worker.
+    vec<Accumulator> accumulators(n_workers);  //!< Um acumulador por worker.
+
+    // [!] Distribui em rodízio: a i-ésima maior tarefa vai para a fila `i % n_workers`.
+    for (size_t i{ 0 }; i < tasks.size(); ++i)
+    {
+      queues[i % n_workers].tasks.push_back(tasks[i]);
+    }
+
+    const auto start{ clock::now() };
+
+    if (n_workers == 1)
+    {
+      work(files, splits, split_of, queues, 0, engine, input_mode, accumulators.front());
+    }
+    else
+    {
+      vec<std::thread> workers{};
+      workers.reserve(n_workers - 1);
+
+      // [!] A thread chamadora também trabalha, então cria apenas `n_workers - 1` threads novas.
+      for (size_t w{ 1 }; w < n_workers; ++w)
+      {
+        workers.emplace_back(work, std::ref(files), std::ref(splits), std::cref(split_of), std::ref(queues), w, engine, input_mode,
+                             std::ref(accumulators[w]));
+      }
+      work(files, splits, split_of, queues, 0, engine, input_mode, accumulators.front());
+
+      for (auto& worker : workers)
+      {
+        worker.join();
+      }
+    }
+
+    const double wall_seconds{ std::chrono::duration<double>(clock::now() - start).count() };
+
+    // [!] Costura os pedaços de cada arquivo dividido, agora que todos foram analisados.
+    for (const auto& split : splits)
+    {
+      FileInfo& file{ files[split.file] };
+      if (SpeculativeScan::stitch(split.chunks, file))
+      {
+        total += file;
+      }
+    }
+
+    // [!] Redução final dos acumuladores de cada worker.
+    for (auto& accumulator : accumulators)
+    {
+      total += accumulator.total;
+      // [!] Tudo o que não foi gasto analisando arquivos, até o fim do último worker, conta como ocioso.
+      accumulator.stats.idle_seconds = std::max(0.0, wall_seconds - accumulator.stats.busy_seconds);
+    }
+
+    if (stats != nullptr)
+    {
+      stats->clear();
+      for (const auto& accumulator : accumulators)
+      {
+        stats->push_back(accumulator.stats);
+      }
+    }
+
+    return total;
+  }
+};
+
+#endif  //!< WORKER_POOL_HPP
@@ -0,0 +1,243 @@
+/**
+ * @file run_profile.hpp
+ *
+ * @brief Define a classe RunProfile, que mede o tempo, a CPU e as alocações de cada fase de uma execução (`--stats`).
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef RUN_PROFILE_HPP
+#define RUN_PROFILE_HPP
+
+// STL includes {{{
+#include <chrono>   // `std::chrono::steady_clock`
+#include <cstdint>  // `std::uint64_t`
+#include <ctime>    // `clock_gettime`, `CLOCK_PROCESS_CPUTIME_ID`
+#include <iomanip>  // `std::setw`, `std::setprecision`
+#include <ostream>  // `std::ostream`
+// }}}
+
+#include <sys/resource.h>  // `getrusage`
+
+#include "../common/alloc_hook.hpp"  // `AllocHook`
+#include "../common/aliases.hpp"     // `str_view`, `vec`, `size_t`
+#include "trace.hpp"                 // `Trace`
+
+/**
+ * @brief Perfil de uma execução: tempo de parede, tempo de CPU e alocações no heap de cada fase, mais os totais de
+ * arquivos e bytes, a vazão da análise e o pico de memória residente.
+ *
+ * @details As medições acontecem só nas fronteiras das fases: `phase` fecha a fase anterior e abre a seguinte lendo
+ * o relógio de parede, o relógio de CPU do processo (somando todas as threads) e o contador do `AllocHook`, e `finish`
+ * fecha a última. Nada é medido por arquivo nem por byte, então o custo total é de algumas chamadas de sistema por
+ * execução. O pico de memória vem de `getrusage` no fim.
+ *
+ * Com `--trace`, cada fase vira também um intervalo na linha da thread principal do trace.
+ *
+ * Desligado (sem `--stats` nem `--trace`), `phase` e `finish` retornam logo na entrada.
+ */
+class RunProfile
+{
+public:
+  /**
+   * @brief Medições de uma fase.
+   */
+  struct Phase
+  {
+    str_view name{};                   //!< Nome exibido no relatório.
+    bool scan{ false };                //!< Indica se é a fase de leitura e análise (base da vazão).
+    double wall_seconds{ 0.0 };        //!< Tempo de parede.
+    double cpu_seconds{ 0.0 };         //!< Tempo de CPU do processo (todas as threads).
+    std::uint64_t n_allocations{ 0 };  //!< Alocações no heap (zero se o `AllocHook` estiver desligado).
+  };
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Leitura dos três contadores num instante.
+   */
+  struct Mark
+  {
+    clock::time_point wall{};          //!< Relógio de parede.
+    double cpu_seconds{ 0.0 };         //!< Tempo de CPU do processo.
+    std::uint64_t n_allocations{ 0 };  //!< Contador do `AllocHook`.
+  };
+
+  bool m_enabled;                //!< Indica se o perfil foi pedido (`--stats` ou `--trace`).
+  Mark m_start{};                //!< Início do perfil.
+  Mark m_phase_start{};          //!< Início da fase aberta.
+  Mark m_end{};                  //!< Fim do perfil (`finish`).
+  vec<Phase> m_phases{};         //!< Fases, em ordem; a última pode estar aberta.
+  bool m_open{ false };          //!< Indica se a última fase ainda está aberta.
+  size_t m_n_files{ 0 };         //!< Arquivos com resultado.
+  size_t m_n_cached{ 0 };        //!< Desses, quantos vieram do cache.
+  std::uint64_t m_n_bytes{ 0 };  //!< Bytes lidos e analisados.
+
+  /**
+   * @brief Retorna o tempo de CPU consumido pelo processo até agora, em segundos.
+   */
+  static double cpu_seconds()
+  {
+    timespec now{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+  }
+
+  /// @brief Lê os contadores agora.
+  static Mark mark() { return Mark{ clock::now(), cpu_seconds(), AllocHook::count() }; }
+
+  /**
+   * @brief Preenche em @a phase as diferenças entre @a from e @a to.
+   */
+  static void measure(Phase& phase, const Mark& from, const Mark& to)
+  {
+    phase.wall_seconds = std::chrono::duration<double>(to.wall - from.wall).count();
+    phase.cpu_seconds = to.cpu_seconds - from.cpu_seconds;
+    phase.n_allocations = to.n_allocations - from.n_allocations;
+  }
+
+  /**
+   * @brief Encerra a fase aberta (se houver) em @a now.
+   */
+  void close(const Mark& now)
+  {
+    if (m_open)
+    {
+      measure(m_phases.back(), m_phase_start, now);
+      Trace::span(m_phases.back().name, m_phase_start.wall, now.wall);
+      m_open = false;
+    }
+  }
+
+public:
+  /**
+   * @brief Cria o perfil; se @a enabled, começa a medir a partir daqui.
+   */
+  explicit RunProfile(bool enabled) : m_enabled{ enabled }
+  {
+    if (m_enabled)
+    {
+      m_start = mark();
+    }
+  }
+
+  /// @brief Indica se o perfil está ligado.
+  bool enabled() const { return m_enabled; }
+
+  /**
+   * @brief Encerra a fase aberta (se houver) e abre a fase @a name.
+   *
+   * @param scan  Indica que é a fase de leitura e análise dos arquivos, cujo tempo de parede é a base da vazão.
+   */
+  void phase(str_view name, bool scan = false)
+  {
+    if (not m_enabled)
+    {
+      return;
+    }
+    const Mark now{ mark() };
+    close(now);
+    m_phases.push_back(Phase{ name, scan, 0.0, 0.0, 0 });
+    m_phase_start = now;
+    m_open = true;
+  }
+
+  /**
+   * @brief Encerra a fase aberta e o perfil.
+   */
+  void finish()
+  {
+    if (m_enabled)
+    {
+      m_end = mark();
+      close(m_end);
+    }
+  }
+
+  /**
+   * @brief Registra o resultado da análise: @a n_files arquivos (@a n_cached deles vindos do cache) e @a n_bytes bytes
+   * lidos e analisados.
+   */
+  void set_totals(size_t n_files, size_t n_cached, std::uint64_t n_bytes)
+  {
+    m_n_files = n_files;
+    m_n_cached = n_cached;
+    m_n_bytes = n_bytes;
+  }
+
+  /// @brief Retorna as fases, em ordem.
+  const vec<Phase>& phases() const { return m_phases; }
+
+  /**
+   * @brief Retorna o pico de memória residente do processo, em bytes.
+   */
+  static std::uint64_t peak_rss_bytes()
+  {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;  // [!] No Linux, `ru_maxrss` vem em KiB.
+  }
+
+  /**
+   * @brief Escreve o relatório em @a os: uma linha por fase, os totais, a vazão da análise e o pico de memória.
+   *
+   * @details A coluna de CPU soma todas as threads, então CPU maior que o tempo de parede indica paralelismo.
+   */
+  void report(std::ostream& os) const
+  {
+    if (not m_enabled)
+    {
+      return;
+    }
+
+    Phase total{ "total", false, 0.0, 0.0, 0 };
+    measure(total, m_start, m_end);
+    double scan_seconds{ 0.0 };
+    for (const auto& phase : m_phases)
+    {
+      scan_seconds += phase.scan ? phase.wall_seconds : 0.0;
+    }
+
+    const auto flags{ os.flags() };
+    const auto precision{ os.precision() };
+    os << std::left << std::fixed << "\n Phase            Wall (s)    CPU (s)     Allocations\n";
+    auto line{ [&os](const Phase& phase) {
+      os << ' ' << std::setw(17) << phase.name << std::setw(12) << std::setprecision(3) << phase.wall_seconds;
+      os << std::setw(12) << phase.cpu_seconds;
+      if (AllocHook::enabled())
+      {
+        os << phase.n_allocations;
+      }
+      else
+      {
+        os << '-';
+      }
+      os << '\n';
+    } };
+    for (const auto& phase : m_phases)
+    {
+      line(phase);
+    }
+    line(total);
+
+    const double mib{ static_cast<double>(m_n_bytes) / (1024.0 * 1024.0) };
+    os << "\n Files: " << m_n_files << " (" << m_n_cached << " from the cache), scanned " << std::setprecision(1) << mib
+       << " MiB";
+    if (m_n_bytes > 0 and scan_seconds > 0.0)
+    {
+      os << " at " << mib / scan_seconds << " MiB/s";
+    }
+    os << "\n Peak RSS: " << static_cast<double>(peak_rss_bytes()) / (1024.0 * 1024.0) << " MiB\n\n";
+    os.flags(flags);
+    os.precision(precision);
+  }
+};
+
+#endif  //!< RUN_PROFILE_HPP
@@ -0,0 +1,293 @@
+/**
+ * @file trace.hpp
+ *
+ * @brief Define a classe Trace, que registra a atividade de cada thread e a exporta no formato de eventos do Chrome
+ * (`--trace`).
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+// POSIX includes {{{
+#include <fcntl.h>   // `open`
+#include <unistd.h>  // `close`
+// }}}
+
+// STL includes {{{
+#include <atomic>   // `std::atomic`
+#include <chrono>   // `std::chrono::steady_clock`
+#include <cstdint>  // `std::int64_t`, `std::uint64_t`
+#include <memory>   // `std::unique_ptr`
+#include <mutex>    // `std::mutex`
+// }}}
+
+#include "../common/aliases.hpp"         // `str`, `str_view`, `vec`, `size_t`
+#include "../common/constants.hpp"       // `TRACE_SMALL_FILE_SIZE`, `TRACE_BATCH_MAX_FILES`, `TRACE_MIN_WAIT_NS`
+#include "../core/io/output_buffer.hpp"  // `OutputBuffer`
+
+/**
+ * @brief Registro de intervalos (*spans*) por thread, exportado como JSON de eventos do Chrome (abre no Perfetto e no
+ * `chrome://tracing`).
+ *
+ * @details Cada thread escreve num buffer só seu, criado na primeira vez que ela registra algo (só essa criação passa
+ * por um mutex); depois disso, registrar um evento é um `push_back` num vetor local, sem trava nem atômico além da
+ * leitura de `enabled`. Os buffers pertencem à classe e sobrevivem às threads, e `write` só é chamado depois que todas
+ * terminaram.
+ *
+ * Por arquivo são registrados dois intervalos: `open` (abertura e mapeamento, ou a abertura no modo em blocos) e `scan`
+ * (a análise; com o arquivo mapeado, inclui as faltas de página, ou seja, a leitura de fato). Para o trace não crescer
+ * com o número de arquivos, os menores que `TRACE_SMALL_FILE_SIZE` não têm eventos próprios: arquivos pequenos
+ * seguidos de uma thread viram um único evento `small files`, com a quantidade, os bytes e os tempos somados de abertura
+ * e análise. Um lote termina com `TRACE_BATCH_MAX_FILES` arquivos ou com um intervalo de `TRACE_BATCH_GAP_NS` sem
+ * arquivos, então esperas continuam visíveis como buracos na linha da thread. Pelo mesmo motivo, esperas nas filas
+ * mais curtas que `TRACE_MIN_WAIT_NS` são descartadas: só os gargalos de fato aparecem.
+ *
+ * Desligado (sem `--trace`), `now` e os registros retornam logo após ler `enabled`.
+ */
+class Trace
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  /**
+   * @brief Um intervalo completo (evento `"ph": "X"`).
+   */
+  struct Event
+  {
+    str_view name{};                //!< Nome do evento (sempre um literal).
+    std::int64_t start_ns{ 0 };     //!< Início, desde `start`.
+    std::int64_t duration_ns{ 0 };  //!< Duração.
+    str path{};                     //!< Arquivo (vazio se não se aplicar).
+    std::uint64_t bytes{ 0 };       //!< Bytes do arquivo (ou do lote).
+    std::uint64_t n_files{ 0 };     //!< Arquivos do lote (zero fora dos lotes).
+    std::int64_t open_ns{ 0 };      //!< Tempo somado de abertura dos arquivos do lote.
+    std::int64_t scan_ns{ 0 };      //!< Tempo somado de análise dos arquivos do lote.
+  };
+
+  /**
+   * @brief Eventos de uma thread e o lote de arquivos pequenos em aberto.
+   */
+  struct Buffer
+  {
+    size_t tid{ 0 };      //!< Identificador da thread no trace.
+    str name{};           //!< Nome da thread no trace.
+    vec<Event> events{};  //!< Eventos encerrados.
+    Event batch{};        //!< Lote de arquivos pequenos em aberto (`n_files > 0`).
+  };
+
+  static inline std::atomic<bool> s_enabled{ false };      //!< Indica se o trace foi pedido.
+  static inline clock::time_point s_origin{};              //!< Instante zero do trace.
+  static inline std::mutex s_mutex{};                      //!< Protege só a criação de buffers.
+  static inline vec<std::unique_ptr<Buffer>> s_buffers{};  //!< Um buffer por thread que registrou algo.
+
+  /**
+   * @brief Retorna o buffer da thread atual, criando-o no primeiro uso.
+   */
+  static Buffer& buffer()
+  {
+    thread_local Buffer* local{ nullptr };
+    if (local == nullptr)
+    {
+      std::lock_guard<std::mutex> lock{ s_mutex };
+      s_buffers.push_back(std::make_unique<Buffer>());
+      local = s_buffers.back().get();
+      local->tid = s_buffers.size();
+      local->name = "thread " + std::to_string(local->tid);
+    }
+    return *local;
+  }
+
+  /// @brief Converte @a t em nanossegundos desde `start`.
+  static std::int64_t since_origin(clock::time_point t)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t - s_origin).count();
+  }
+
+  /**
+   * @brief Encerra o lote em aberto de @a buffer, se houver.
+   */
+  static void close_batch(Buffer& buffer)
+  {
+    if (buffer.batch.n_files > 0)
+    {
+      buffer.events.push_back(std::move(buffer.batch));
+      buffer.batch = Event{};
+    }
+  }
+
+  /**
+   * @brief Escreve @a ns (nanossegundos) em microssegundos, a unidade do formato.
+   */
+  static void append_us(OutputBuffer& out, std::int64_t ns) { out.append_fixed(static_cast<double>(ns) / 1000.0, 3); }
+
+public:
+  /**
+   * @brief Liga o registro; o instante atual vira o zero do trace e a thread atual se chama `main`.
+   */
+  static void start()
+  {
+    s_origin = clock::now();
+    s_enabled.store(true, std::memory_order_relaxed);
+    name_thread("main");
+  }
+
+  /// @brief Indica se o registro está ligado.
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /// @brief Retorna o instante atual (ou um valor qualquer, sem ler o relógio, com o registro desligado).
+  static clock::time_point now() { return enabled() ? clock::now() : clock::time_point{}; }
+
+  /**
+   * @brief Dá à thread atual o nome @a name no trace.
+   */
+  static void name_thread(str name)
+  {
+    if (enabled())
+    {
+      buffer().name = std::move(name);
+    }
+  }
+
+  /**
+   * @brief Registra o intervalo @a name entre @a begin e @a end na thread atual.
+   *
+   * @param path   Arquivo ao qual o intervalo se refere (opcional).
+   * @param bytes  Bytes envolvidos (opcional).
+   */
+  static void span(str_view name, clock::time_point begin, clock::time_point end, str_view path = {}, std::uint64_t bytes = 0)
+  {
+    if (not enabled())
+    {
+      return;
+    }
+    Buffer& local{ buffer() };
+    close_batch(local);  // [!] Mantém os eventos de cada thread em ordem de início.
+    local.events.push_back(Event{ name, since_origin(begin), since_origin(end) - since_origin(begin), str{ path }, bytes, 0, 0, 0 });
+  }
+
+  /**
+   * @brief Registra a espera @a name entre @a begin e @a end, se ela durou pelo menos `TRACE_MIN_WAIT_NS`.
+   */
+  static void wait(str_view name, clock::time_point begin, clock::time_point end)
+  {
+    if (enabled() and since_origin(end) - since_origin(begin) >= TRACE_MIN_WAIT_NS)
+    {
+      span(name, begin, end);
+    }
+  }
+
+  /**
+   * @brief Registra a abertura (de @a opened a @a scanned) e a análise (de @a scanned a @a done) do arquivo @a path,
+   * com @a bytes bytes; arquivos pequenos entram no lote da thread.
+   */
+  static void file(str_view path, std::uint64_t bytes, clock::time_point opened, clock::time_point scanned, clock::time_point done)
+  {
+    if (not enabled())
+    {
+      return;
+    }
+    if (bytes >= TRACE_SMALL_FILE_SIZE)
+    {
+      span("open", opened, scanned, path, bytes);
+      span("scan", scanned, done, path, bytes);
+      return;
+    }
+
+    Buffer& local{ buffer() };
+    Event& batch{ local.batch };
+    const std::int64_t begin{ since_origin(opened) };
+    const std::int64_t end{ since_origin(done) };
+    if (batch.n_files > 0
+        and (batch.n_files >= TRACE_BATCH_MAX_FILES or begin - (batch.start_ns + batch.duration_ns) > TRACE_BATCH_GAP_NS))
+    {
+      close_batch(local);
+    }
+    if (batch.n_files == 0)
+    {
+      batch.name = "small files";
+      batch.start_ns = begin;
+    }
+    batch.duration_ns = end - batch.start_ns;
+    batch.bytes += bytes;
+    batch.n_files++;
+    batch.open_ns += since_origin(scanned) - begin;
+    batch.scan_ns += end - since_origin(scanned);
+  }
+
+  /**
+   * @brief Grava todos os eventos em @a path, no formato de eventos do Chrome.
+   *
+   * @details Deve ser chamado depois que todas as threads que registraram eventos terminaram.
+   *
+   * @return bool  `false` se o arquivo não pôde ser escrito.
+   */
+  static bool write(const str& path)
+  {
+    const int fd{ ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (fd < 0)
+    {
+      return false;
+    }
+
+    bool failed{ false };
+    {
+      OutputBuffer out{ fd };
+      out.append("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+      bool first{ true };
+      auto separator{ [&] {
+        out.append(first ? "  " : ",\n  ");
+        first = false;
+      } };
+
+      for (const auto& local : s_buffers)
+      {
+        close_batch(*local);
+        separator();
+        out.append("{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": ").append_uint(local->tid);
+        out.append(", \"args\": {\"name\": ").append_json_string(local->name).append("}}");
+      }
+
+      for (const auto& local : s_buffers)
+      {
+        for (const auto& event : local->events)
+        {
+          separator();
+          out.append("{\"name\": \"").append(event.name).append("\", \"cat\": \"sloc\", \"ph\": \"X\", \"pid\": 1, \"tid\": ");
+          out.append_uint(local->tid).append(", \"ts\": ");
+          append_us(out, event.start_ns);
+          out.append(", \"dur\": ");
+          append_us(out, event.duration_ns);
+          out.append(", \"args\": {");
+          if (event.n_files > 0)
+          {
+            out.append("\"files\": ").append_uint(event.n_files).append(", \"bytes\": ").append_uint(event.bytes);
+            out.append(", \"open_us\": ");
+            append_us(out, event.open_ns);
+            out.append(", \"scan_us\": ");
+            append_us(out, event.scan_ns);
+          }
+          else if (not event.path.empty())
+          {
+            out.append("\"path\": ").append_json_string(event.path).append(", \"bytes\": ").append_uint(event.bytes);
+          }
+          out.append("}}");
+        }
+      }
+      out.append("\n]}\n");
+      out.flush();
+      failed = out.failed();
+    }
+    return ::close(fd) == 0 and not failed;
+  }
+};
+
+#endif  //!< TRACE_HPP
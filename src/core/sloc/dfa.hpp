@@ -0,0 +1,404 @@
+/**
+ * @file dfa.hpp
+ *
+ * @brief Define a classe Dfa, uma versão da máquina de estados do `Sloc` compilada em tabelas de transição.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef DFA_HPP
+#define DFA_HPP
+
+// STL includes {{{
+#include <array>    // `std::array`
+#include <cstdint>  // `std::uint16_t`, `std::uint32_t`
+#include <cstring>  // `std::memchr`
+// }}}
+
+#include "../common/aliases.hpp"  // `byte`, `str_view`
+#include "file_info.hpp"          // `FileInfo`, `count_t`
+#include "state.hpp"              // `State`
+
+/**
+ * @enum DfaState
+ *
+ * @brief Estados do autômato determinístico equivalente à cadeia `handle_*` do `Sloc`.
+ *
+ * @details A cadeia original decide alguns casos olhando até dois caracteres à frente (`//`, `/ *`, `/ **`, `* /`,
+ *          `\\` no fim da linha). O autômato troca essa espiada por estados "pendentes" (`SLASH`, `LINE_OPEN`,
+ *          `BLOCK_OPEN`, `*_STAR`, `ESC_*`) que só são resolvidos no byte seguinte ou no fim da linha. A
+ *          correspondência com o enum `State` é:
+ *            - `CODE`                      -> `State::UNDEF` / `State::CODE`;
+ *            - `LIT_*` / `ESC_*`           -> `State::LITERAL` / `State::ESCAPING`, com o delimitador embutido no estado;
+ *            - `BLOCK_REG*` / `BLOCK_DOC*` -> `State::BLOCK_REG_COMMENT` / `State::BLOCK_DOC_COMMENT`;
+ *            - `LINE_REG` / `LINE_DOC`     -> `State::LINE_REG_COMMENT` / `State::LINE_DOC_COMMENT`.
+ *
+ *          No início de uma linha o autômato só pode estar em `CODE`, `LIT_DQ`, `LIT_SQ`, `BLOCK_REG` ou `BLOCK_DOC`.
+ */
+enum class DfaState : byte
+{
+  CODE,            //!< Código (ou nada ainda) fora de literais e comentários.
+  SLASH,           //!< Um `/` em código; depende do próximo byte.
+  BLOCK_OPEN,      //!< `/ *` visto; o próximo byte decide entre regular e documentação.
+  BLOCK_REG,       //!< Dentro de um comentário de bloco regular.
+  BLOCK_REG_STAR,  //!< Dentro de um comentário de bloco regular, logo após um `*`.
+  BLOCK_DOC,       //!< Dentro de um comentário de bloco de documentação.
+  BLOCK_DOC_STAR,  //!< Dentro de um comentário de bloco de documentação, logo após um `*`.
+  LIT_DQ,          //!< Dentro de um literal delimitado por `"`.
+  LIT_SQ,          //!< Dentro de um literal delimitado por `'`.
+  ESC_DQ,          //!< Após um `\` dentro de um literal `"`.
+  ESC_SQ,          //!< Após um `\` dentro de um literal `'`.
+  LINE_OPEN,       //!< `//` visto; o próximo byte decide entre regular e documentação.
+  LINE_REG,        //!< Comentário de linha regular: o restante da linha é ignorado.
+  LINE_DOC,        //!< Comentário de linha de documentação: o restante da linha é ignorado.
+};
+
+/**
+ * @brief Tipos e construtores (`constexpr`) das tabelas do autômato `Dfa`.
+ *
+ * @details Fica numa classe separada porque as tabelas, membros `static constexpr` de `Dfa`, só podem ser calculadas
+ * por funções de uma classe já completa.
+ */
+class DfaTables
+{
+public:
+  /// @brief Bits de ação acumulados por linha.
+  enum Action : byte
+  {
+    NONE = 0,
+    HAD_CODE = 1 << 0,         //!< A linha contém código.
+    HAD_REG_COMMENT = 1 << 1,  //!< A linha contém comentário regular.
+    HAD_DOC_COMMENT = 1 << 2,  //!< A linha contém comentário de documentação.
+    HAD_BLANK = 1 << 3,        //!< A linha é vazia.
+  };
+
+  /// @brief Classes de byte relevantes para o autômato.
+  enum ByteClass : byte
+  {
+    OTHER,      //!< Qualquer byte que não seja espaço nem um dos abaixo.
+    SPACE,      //!< Espaço em branco (mesmo conjunto de `std::isspace` no locale "C").
+    SLASH,      //!< `/`
+    STAR,       //!< `*`
+    DQUOTE,     //!< `"`
+    SQUOTE,     //!< `'`
+    BACKSLASH,  //!< `\`
+    BANG,       //!< `!`
+    EOL,        //!< Fim da linha (classe virtual, não corresponde a nenhum byte).
+    N_CLASSES,
+  };
+
+  static constexpr size_t N_STATES{ static_cast<size_t>(DfaState::LINE_DOC) + 1 };
+
+  /// @brief Uma transição: próximo estado nos 4 bits baixos, ações nos 4 bits altos.
+  using transition = byte;
+
+protected:
+  using S = DfaState;
+
+  static constexpr transition make(S next, byte actions = NONE)
+  {
+    return static_cast<transition>(static_cast<byte>(next) | static_cast<byte>(actions << 4));
+  }
+
+  /**
+   * @brief Tabela de classes dos bytes ASCII (bytes acima de 127 são `OTHER`).
+   */
+  static constexpr std::array<byte, 256> build_byte_classes()
+  {
+    std::array<byte, 256> classes{};
+    for (auto& byte_class : classes)
+    {
+      byte_class = OTHER;
+    }
+    for (const char c : { ' ', '\t', '\n', '\r', '\f', '\v' })
+    {
+      classes[static_cast<byte>(c)] = SPACE;
+    }
+    classes[static_cast<byte>('/')] = SLASH;
+    classes[static_cast<byte>('*')] = STAR;
+    classes[static_cast<byte>('"')] = DQUOTE;
+    classes[static_cast<byte>('\'')] = SQUOTE;
+    classes[static_cast<byte>('\\')] = BACKSLASH;
+    classes[static_cast<byte>('!')] = BANG;
+    return classes;
+  }
+
+  /**
+   * @brief Tabela densa de transições indexada por (estado, classe de byte).
+   */
+  static constexpr std::array<std::array<transition, N_CLASSES>, N_STATES> build_transitions()
+  {
+    std::array<std::array<transition, N_CLASSES>, N_STATES> table{};
+
+    auto row{ [&table](S state) -> std::array<transition, N_CLASSES>& { return table[static_cast<size_t>(state)]; } };
+    auto fill{ [](std::array<transition, N_CLASSES>& r, transition t) {
+      for (size_t c{ 0 }; c < EOL; ++c)
+      {
+        r[c] = t;
+      }
+    } };
+
+    // [!] Código: qualquer byte que não seja espaço é código; aspas abrem literais; `/` fica pendente.
+    fill(row(S::CODE), make(S::CODE, HAD_CODE));
+    row(S::CODE)[SPACE] = make(S::CODE);
+    row(S::CODE)[SLASH] = make(S::SLASH);
+    row(S::CODE)[DQUOTE] = make(S::LIT_DQ, HAD_CODE);
+    row(S::CODE)[SQUOTE] = make(S::LIT_SQ, HAD_CODE);
+    row(S::CODE)[EOL] = make(S::CODE);
+
+    // [!] `/` pendente: `//` e `/ *` abrem comentários; senão o `/` era código e o byte atual segue como em `CODE`.
+    for (size_t c{ 0 }; c < N_CLASSES; ++c)
+    {
+      row(S::SLASH)[c] = static_cast<transition>(row(S::CODE)[c] | make(S::CODE, HAD_CODE));
+    }
+    row(S::SLASH)[SLASH] = make(S::LINE_OPEN);
+    row(S::SLASH)[STAR] = make(S::BLOCK_OPEN);
+
+    // [!] `//` visto: `///` e `//!` são documentação.
+    fill(row(S::LINE_OPEN), make(S::LINE_REG, HAD_REG_COMMENT));
+    row(S::LINE_OPEN)[SLASH] = make(S::LINE_DOC, HAD_DOC_COMMENT);
+    row(S::LINE_OPEN)[BANG] = make(S::LINE_DOC, HAD_DOC_COMMENT);
+    row(S::LINE_OPEN)[EOL] = make(S::CODE, HAD_REG_COMMENT);
+
+    // [!] Comentários de linha absorvem o restante da linha.
+    fill(row(S::LINE_REG), make(S::LINE_REG));
+    row(S::LINE_REG)[EOL] = make(S::CODE);
+    fill(row(S::LINE_DOC), make(S::LINE_DOC));
+    row(S::LINE_DOC)[EOL] = make(S::CODE);
+
+    /* [!]
+     * `/ *` visto: `/ **` e `/ *!` são documentação. O `*` de `/ *` ainda pode fechar o bloco (`/ * /` é um bloco
+     * completo), e em `/ **` o segundo `*` também pode.
+     */
+    fill(row(S::BLOCK_OPEN), make(S::BLOCK_REG, HAD_REG_COMMENT));
+    row(S::BLOCK_OPEN)[STAR] = make(S::BLOCK_DOC_STAR, HAD_DOC_COMMENT);
+    row(S::BLOCK_OPEN)[BANG] = make(S::BLOCK_DOC, HAD_DOC_COMMENT);
+    row(S::BLOCK_OPEN)[SLASH] = make(S::CODE, HAD_REG_COMMENT);
+    row(S::BLOCK_OPEN)[EOL] = make(S::BLOCK_REG, HAD_REG_COMMENT);
+
+    // [!] Dentro de blocos, todo byte é comentário; `*` seguido de `/` fecha o bloco.
+    const std::array<std::array<S, 2>, 2> blocks{ { { S::BLOCK_REG, S::BLOCK_REG_STAR }, { S::BLOCK_DOC, S::BLOCK_DOC_STAR } } };
+    const std::array<byte, 2> block_actions{ HAD_REG_COMMENT, HAD_DOC_COMMENT };
+    for (size_t b{ 0 }; b < 2; ++b)
+    {
+      const S plain{ blocks[b][0] };
+      const S star{ blocks[b][1] };
+      fill(row(plain), make(plain, block_actions[b]));
+      row(plain)[STAR] = make(star, block_actions[b]);
+      row(plain)[EOL] = make(plain);
+
+      fill(row(star), make(plain, block_actions[b]));
+      row(star)[STAR] = make(star, block_actions[b]);
+      row(star)[SLASH] = make(S::CODE, block_actions[b]);
+      row(star)[EOL] = make(plain);
+    }
+
+    // [!] Literais: todo byte é código; o delimitador fecha; `\` escapa o próximo byte (se houver um na linha).
+    const std::array<std::array<S, 2>, 2> literals{ { { S::LIT_DQ, S::ESC_DQ }, { S::LIT_SQ, S::ESC_SQ } } };
+    const std::array<ByteClass, 2> delimiters{ DQUOTE, SQUOTE };
+    for (size_t l{ 0 }; l < 2; ++l)
+    {
+      const S literal{ literals[l][0] };
+      const S escape{ literals[l][1] };
+      fill(row(literal), make(literal, HAD_CODE));
+      row(literal)[delimiters[l]] = make(S::CODE, HAD_CODE);
+      row(literal)[BACKSLASH] = make(escape);
+      row(literal)[EOL] = make(literal);
+
+      fill(row(escape), make(literal));
+      row(escape)[EOL] = make(literal, HAD_CODE);  // [!] `\` no fim da linha não escapa nada: é conteúdo do literal.
+    }
+
+    return table;
+  }
+
+  /**
+   * @brief Combina classes e transições numa tabela (estado, byte): uma única leitura por byte no laço interno.
+   *
+   * @details Cada entrada guarda o próximo estado já multiplicado por 256 (byte alto) e as ações (byte baixo). Assim o
+   * próximo índice é só `entrada & 0xFF00 | byte`, sem deslocamentos na cadeia de dependência entre bytes.
+   */
+  static constexpr std::array<std::uint16_t, N_STATES * 256> build_byte_transitions()
+  {
+    const std::array<byte, 256> classes{ build_byte_classes() };
+    const std::array<std::array<transition, N_CLASSES>, N_STATES> transitions{ build_transitions() };
+
+    std::array<std::uint16_t, N_STATES * 256> table{};
+    for (size_t s{ 0 }; s < N_STATES; ++s)
+    {
+      for (size_t b{ 0 }; b < 256; ++b)
+      {
+        const transition t{ transitions[s][classes[b]] };
+        table[s * 256 + b] = static_cast<std::uint16_t>(((t & 0x0F) << 8) | (t >> 4));
+      }
+    }
+    return table;
+  }
+
+  /**
+   * @brief Ações de uma linha vazia (ou só com espaços), de acordo com o estado no início da linha.
+   */
+  static constexpr std::array<byte, N_STATES> build_blank_actions()
+  {
+    std::array<byte, N_STATES> actions{};
+    actions[static_cast<size_t>(S::CODE)] = HAD_BLANK;
+    actions[static_cast<size_t>(S::LIT_DQ)] = HAD_CODE;  // [!] Ex.: linha vazia dentro de uma *raw string*.
+    actions[static_cast<size_t>(S::LIT_SQ)] = HAD_CODE;
+    actions[static_cast<size_t>(S::BLOCK_REG)] = HAD_REG_COMMENT;
+    actions[static_cast<size_t>(S::BLOCK_DOC)] = HAD_DOC_COMMENT;
+    return actions;
+  }
+
+};
+
+/**
+ * @brief Autômato finito determinístico, dirigido por tabelas, que classifica linhas exatamente como o `Sloc`.
+ *
+ * @details Cada byte da linha (já sem espaços nas pontas) é convertido em uma classe (`BYTE_CLASS`) e o par
+ * (estado, classe) indexa uma tabela densa cuja entrada guarda o próximo estado e os bits de ação (código, comentário
+ * regular, comentário de documentação) da linha. As duas tabelas são combinadas em tempo de compilação numa tabela
+ * (estado, byte), então o laço interno faz uma única leitura de tabela por byte.
+ */
+class Dfa : public DfaTables
+{
+public:
+  static constexpr std::array<byte, 256> BYTE_CLASS{ build_byte_classes() };  //!< Classe de cada byte.
+  static constexpr std::array<std::array<transition, N_CLASSES>, N_STATES> TRANSITIONS{ build_transitions() };  //!< (estado, classe).
+  static constexpr std::array<std::uint16_t, N_STATES * 256> BYTE_TRANSITIONS{ build_byte_transitions() };  //!< (estado, byte).
+  static constexpr std::array<byte, N_STATES> BLANK_ACTIONS{ build_blank_actions() };  //!< Ações de linhas vazias.
+
+  /// @brief Próximo estado codificado em @a t.
+  static constexpr DfaState next_state(transition t) { return static_cast<DfaState>(t & 0x0F); }
+
+  /// @brief Ações codificadas em @a t.
+  static constexpr byte actions(transition t) { return static_cast<byte>(t >> 4); }
+
+  /**
+   * @brief Converte o estado do autômato no estado equivalente do enum `State`.
+   */
+  static constexpr State to_state(DfaState state)
+  {
+    switch (state)
+    {
+    case S::CODE:
+    case S::SLASH:
+      return State::UNDEF;
+    case S::BLOCK_OPEN:
+      return State::BLOCK_COMMENT;
+    case S::BLOCK_REG:
+    case S::BLOCK_REG_STAR:
+      return State::BLOCK_REG_COMMENT;
+    case S::BLOCK_DOC:
+    case S::BLOCK_DOC_STAR:
+      return State::BLOCK_DOC_COMMENT;
+    case S::LIT_DQ:
+    case S::LIT_SQ:
+      return State::LITERAL;
+    case S::ESC_DQ:
+    case S::ESC_SQ:
+      return State::ESCAPING;
+    case S::LINE_OPEN:
+      return State::LINE_COMMENT;
+    case S::LINE_REG:
+      return State::LINE_REG_COMMENT;
+    case S::LINE_DOC:
+      return State::LINE_DOC_COMMENT;
+    }
+    return State::UNDEF;
+  }
+
+  /**
+   * @brief Remove os espaços em branco das pontas da linha, usando a tabela de classes.
+   */
+  static str_view trim(str_view line)
+  {
+    const auto* first{ reinterpret_cast<const byte*>(line.data()) };
+    const byte* last{ first + line.size() };
+    while (first < last and BYTE_CLASS[*first] == SPACE)
+    {
+      ++first;
+    }
+    while (last > first and BYTE_CLASS[*(last - 1)] == SPACE)
+    {
+      --last;
+    }
+    return str_view{ reinterpret_cast<const char*>(first), static_cast<size_t>(last - first) };
+  }
+
+  /**
+   * @brief Classifica uma linha já sem espaços nas pontas.
+   *
+   * @param state         Estado no início da linha; ao retornar, estado no início da próxima linha.
+   * @param trimmed_line  Linha sem espaços em branco no início e fim.
+   *
+   * @return byte  Bits de `Action` da linha.
+   */
+  static byte scan_line(DfaState& state, str_view trimmed_line)
+  {
+    if (trimmed_line.empty())
+    {
+      return BLANK_ACTIONS[static_cast<size_t>(state)];
+    }
+
+    const auto* cursor{ reinterpret_cast<const byte*>(trimmed_line.data()) };
+    const byte* last{ cursor + trimmed_line.size() };
+
+    std::uint32_t row{ static_cast<std::uint32_t>(state) << 8 };  //!< Estado atual, já como deslocamento da linha da tabela.
+    std::uint32_t actions_seen{ NONE };                            //!< Ações acumuladas na linha.
+
+    for (; cursor < last; ++cursor)
+    {
+      const std::uint16_t t{ BYTE_TRANSITIONS[row | *cursor] };
+      row = t & 0xFF00U;
+      actions_seen |= t;
+    }
+
+    const transition t{ TRANSITIONS[row >> 8][EOL] };
+    state = next_state(t);
+    return static_cast<byte>((actions_seen & 0xFFU) | actions(t));
+  }
+
+  /**
+   * @brief Soma as ações de uma linha às contagens de @a file.
+   */
+  static void count_line(byte line_actions, FileInfo& file)
+  {
+    file.n_loc += static_cast<count_t>((line_actions & HAD_CODE) != 0);
+    file.n_reg_comments += static_cast<count_t>((line_actions & HAD_REG_COMMENT) != 0);
+    file.n_doc_comments += static_cast<count_t>((line_actions & HAD_DOC_COMMENT) != 0);
+    file.n_blank_lines += static_cast<count_t>((line_actions & HAD_BLANK) != 0);
+    file.n_lines++;
+  }
+
+  /**
+   * @brief Classifica um bloco de linhas completas (como `std::getline`: um trecho final sem `\n` conta como linha
+   * se não estiver vazio), somando as contagens em @a file.
+   *
+   * @param state     Estado no início do bloco; ao retornar, estado após a última linha.
+   * @param contents  Conteúdo a ser analisado.
+   * @param file      Contagens a serem incrementadas.
+   */
+  static void scan(DfaState& state, str_view contents, FileInfo& file)
+  {
+    const char* cursor{ contents.data() };
+    const char* end{ cursor + contents.size() };
+
+    while (cursor < end)
+    {
+      const auto* newline{ static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor))) };
+      const char* line_end{ newline != nullptr ? newline : end };
+
+      count_line(scan_line(state, trim(str_view{ cursor, static_cast<size_t>(line_end - cursor) })), file);
+
+      cursor = line_end + 1;
+    }
+  }
+};
+
+#endif  //!< DFA_HPP
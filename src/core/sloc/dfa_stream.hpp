@@ -0,0 +1,154 @@
+/**
+ * @file dfa_stream.hpp
+ *
+ * @brief Define a classe DfaStream, que roda o autômato `Dfa` sobre um conteúdo entregue em blocos arbitrários.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef DFA_STREAM_HPP
+#define DFA_STREAM_HPP
+
+// STL includes {{{
+#include <cstring>  // `std::memchr`
+// }}}
+
+#include "../common/aliases.hpp"  // `byte`, `str_view`, `size_t`
+#include "dfa.hpp"                // `Dfa`, `DfaState`
+#include "file_info.hpp"          // `FileInfo`
+
+/**
+ * @brief Análise em fluxo: o conteúdo chega em blocos e as linhas podem ser cortadas em qualquer byte.
+ *
+ * @details As linhas completas de cada bloco passam pelo caminho rápido do `Dfa` (`trim` + `scan_line`). Só o trecho
+ * final de um bloco, sem `\n`, é consumido byte a byte, e o que precisa sobreviver até o bloco seguinte é apenas o
+ * estado do autômato e alguns contadores, nunca os bytes da linha. Por isso a memória usada não depende do tamanho das
+ * linhas.
+ *
+ * O `trim` da linha é reproduzido sem olhar para trás: espaços antes do primeiro byte não branco são ignorados, e
+ * espaços depois dele ficam pendentes até aparecer outro byte não branco (quando então são aplicados ao autômato) ou
+ * a linha terminar (quando são descartados, como no `trim`). Basta lembrar até dois espaços pendentes, pois a
+ * transição de espaço leva qualquer estado a um ponto fixo em no máximo dois passos.
+ */
+class DfaStream
+{
+private:
+  DfaState m_state{ DfaState::CODE };  //!< Estado do autômato (no meio da linha parcial, se houver uma).
+  bool m_in_line{ false };             //!< Há uma linha parcial, vinda do fim do bloco anterior.
+  bool m_started{ false };             //!< A linha parcial já tem algum byte não branco.
+  byte m_pending_spaces{ 0 };          //!< Espaços vistos desde o último byte não branco (no máximo 2).
+  byte m_actions{ Dfa::NONE };         //!< Ações acumuladas na linha parcial.
+
+  /**
+   * @brief Aplica a transição de @a byte_class ao estado atual, acumulando as ações da linha parcial.
+   */
+  void step(byte byte_class)
+  {
+    const Dfa::transition t{ Dfa::TRANSITIONS[static_cast<size_t>(m_state)][byte_class] };
+    m_state = Dfa::next_state(t);
+    m_actions |= Dfa::actions(t);
+  }
+
+  /**
+   * @brief Consome, byte a byte, um trecho da linha parcial (sem `\n`).
+   */
+  void feed_partial(str_view piece)
+  {
+    m_in_line = m_in_line or not piece.empty();
+
+    for (const char c : piece)
+    {
+      const byte byte_class{ Dfa::BYTE_CLASS[static_cast<byte>(c)] };
+      if (byte_class == Dfa::SPACE)
+      {
+        // [!] Espaços no início da linha são descartados; os demais ficam pendentes.
+        m_pending_spaces = m_started ? static_cast<byte>(m_pending_spaces < 2 ? m_pending_spaces + 1 : 2) : 0;
+        continue;
+      }
+
+      for (; m_pending_spaces > 0; --m_pending_spaces)
+      {
+        step(Dfa::SPACE);
+      }
+      m_started = true;
+      step(byte_class);
+    }
+  }
+
+  /**
+   * @brief Fecha a linha parcial: espaços pendentes são descartados e a transição de fim de linha é aplicada.
+   */
+  void finish_partial(FileInfo& file)
+  {
+    if (m_started)
+    {
+      step(Dfa::EOL);
+    }
+    else
+    {
+      m_actions = Dfa::BLANK_ACTIONS[static_cast<size_t>(m_state)];  // [!] Só espaços: linha vazia.
+    }
+    Dfa::count_line(m_actions, file);
+
+    m_in_line = false;
+    m_started = false;
+    m_pending_spaces = 0;
+    m_actions = Dfa::NONE;
+  }
+
+public:
+  /**
+   * @brief Consome o próximo bloco do conteúdo, somando em @a file as contagens das linhas que terminam nele.
+   */
+  void feed(str_view chunk, FileInfo& file)
+  {
+    const char* cursor{ chunk.data() };
+    const char* end{ cursor + chunk.size() };
+
+    // [!] Completa a linha parcial do bloco anterior (se houver).
+    if (m_in_line)
+    {
+      const auto* newline{ static_cast<const char*>(std::memchr(cursor, '\n', chunk.size())) };
+      if (newline == nullptr)
+      {
+        feed_partial(chunk);  // [!] A linha continua no próximo bloco.
+        return;
+      }
+      feed_partial(str_view{ cursor, static_cast<size_t>(newline - cursor) });
+      finish_partial(file);
+      cursor = newline + 1;
+    }
+
+    while (cursor < end)
+    {
+      const auto* newline{ static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor))) };
+      if (newline == nullptr)
+      {
+        feed_partial(str_view{ cursor, static_cast<size_t>(end - cursor) });  // [!] Linha cortada pelo fim do bloco.
+        return;
+      }
+
+      Dfa::count_line(Dfa::scan_line(m_state, Dfa::trim(str_view{ cursor, static_cast<size_t>(newline - cursor) })), file);
+      cursor = newline + 1;
+    }
+  }
+
+  /**
+   * @brief Encerra o conteúdo: um trecho final sem `\n` conta como linha (como em `std::getline`).
+   */
+  void finish(FileInfo& file)
+  {
+    if (m_in_line)
+    {
+      finish_partial(file);
+    }
+  }
+};
+
+#endif  //!< DFA_STREAM_HPP
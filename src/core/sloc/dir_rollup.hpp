@@ -0,0 +1,311 @@
+/**
+ * @file dir_rollup.hpp
+ *
+ * @brief Define a classe DirRollup, que soma os resultados por diretório e por subárvore.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef DIR_ROLLUP_HPP
+#define DIR_ROLLUP_HPP
+
+// STL includes {{{
+#include <algorithm>   // `std::min`, `std::sort`
+#include <cstdint>     // `std::uint32_t`, `std::uint64_t`
+#include <deque>       // `std::deque`
+#include <filesystem>  // `std::filesystem::path::lexically_normal`
+#include <functional>  // `std::function`
+#include <thread>      // `std::thread`
+// }}}
+
+#include "../common/aliases.hpp"    // `str`, `str_view`, `umap`, `vec`, `size_t`
+#include "../common/constants.hpp"  // `ROLLUP_PARALLEL_MIN_ROWS`
+#include "result_store.hpp"         // `ResultStore`
+
+/**
+ * @brief Árvore de diretórios dos arquivos analisados, com os totais de cada subárvore.
+ *
+ * @details Construída em uma passada sobre as linhas do `ResultStore`, depois da análise (os caminhos já estão todos
+ * na arena, então os nós guardam só `str_view`s, sem copiar nomes):
+ *   1. Cada linha é ligada ao nó do seu diretório. Os arquivos de um mesmo diretório chegam juntos na ordem de
+ *      descoberta, então quase sempre o diretório é o mesmo da linha anterior e o mapa de diretórios nem é consultado.
+ *      Um diretório novo cria também os ancestrais que ainda faltam, sempre antes dele.
+ *   2. Os contadores de cada linha são somados no nó do seu diretório. Acima de `ROLLUP_PARALLEL_MIN_ROWS` linhas, cada
+ *      thread soma um trecho das linhas num vetor de nós próprio, e os vetores são reduzidos no fim.
+ *   3. De baixo para cima: como todo pai é criado antes dos filhos, percorrer os nós do último para o primeiro e somar
+ *      cada um no pai propaga os totais da subárvore inteira em O(nós).
+ *
+ * O nó 0 é uma raiz virtual acima de tudo. Um caminho sem `/` fica no diretório ".". Os diretórios são normalizados
+ * antes de virar nós (`a/./b` e `a/c/../b` são `a/b`), e os que começam por `..` ficam no topo, ao lado de "." (e não
+ * dentro dele): assim um subtotal só inclui arquivos que estão de fato abaixo do diretório.
+ */
+class DirRollup
+{
+public:
+  /**
+   * @brief Um diretório e os totais da sua subárvore.
+   */
+  struct Node
+  {
+    str_view path{};                 //!< Caminho do diretório (vazio na raiz virtual).
+    std::uint32_t parent{ 0 };       //!< Nó pai (a raiz virtual é pai de si mesma).
+    vec<std::uint32_t> children{};   //!< Subdiretórios, em ordem de nome.
+    std::uint64_t n_own_files{ 0 };  //!< Arquivos diretamente neste diretório.
+    std::uint64_t n_files{ 0 };      //!< Arquivos da subárvore.
+    ResultStore::Counts counts{};    //!< Contadores da subárvore.
+  };
+
+private:
+  static constexpr std::uint32_t ROOT{ 0 };  //!< Raiz virtual.
+
+  vec<Node> m_nodes{};                      //!< Nós; todo pai vem antes dos filhos.
+  umap<str_view, std::uint32_t> m_index{};  //!< Nó de cada caminho de diretório.
+  std::deque<str> m_normalized{};           //!< Caminhos normalizados que não estão na arena (endereços estáveis).
+
+  /**
+   * @brief Indica se o diretório @a path já está na forma normal: sem componentes `.` (exceto o próprio "."), sem `/`
+   * repetidas ou no fim e com `..` só no começo.
+   */
+  static bool is_normal(str_view path)
+  {
+    if (path == "." or path == "/")
+    {
+      return true;
+    }
+    bool leading{ true };  //!< Indica se só houve `..` até aqui.
+    for (size_t start{ path.front() == '/' ? size_t{ 1 } : 0 }; start <= path.size();)
+    {
+      const size_t slash{ std::min(path.find('/', start), path.size()) };
+      const str_view component{ path.substr(start, slash - start) };
+      if (component.empty() or component == "." or (component == ".." and not leading))
+      {
+        return false;
+      }
+      leading = leading and component == "..";
+      start = slash + 1;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Retorna a forma normal do diretório @a path; se ela ainda não estiver na arena, guarda uma cópia.
+   */
+  str_view normalize(str_view path)
+  {
+    if (is_normal(path))
+    {
+      return path;  // [!] O caso comum: nenhuma cópia.
+    }
+    str normal{ std::filesystem::path{ path }.lexically_normal().generic_string() };
+    while (normal.size() > 1 and normal.back() == '/')
+    {
+      normal.pop_back();
+    }
+    if (normal.empty())
+    {
+      normal = ".";
+    }
+    if (auto it{ m_index.find(normal) }; it != m_index.end())
+    {
+      return m_nodes[it->second].path;
+    }
+    return m_normalized.emplace_back(std::move(normal));
+  }
+
+  /**
+   * @brief Retorna o diretório que contém @a path (vazio se o pai for a raiz virtual).
+   *
+   * @details Com @a path normal, `..` e `../..` (que não estão abaixo de ".") ficam no topo.
+   */
+  static str_view parent_path(str_view path)
+  {
+    if (path.empty() or path == "." or path == "/" or path == ".." or (path.size() > 3 and path.substr(path.size() - 3) == "/.."))
+    {
+      return {};
+    }
+    const size_t slash{ path.rfind('/') };
+    if (slash == str_view::npos)
+    {
+      return ".";
+    }
+    return slash == 0 ? str_view{ "/" } : path.substr(0, slash);
+  }
+
+  /**
+   * @brief Retorna o nó do diretório @a path, criando-o (e os ancestrais que faltarem) se preciso.
+   */
+  std::uint32_t node_of(str_view path)
+  {
+    if (path.empty())
+    {
+      return ROOT;
+    }
+    if (auto it{ m_index.find(path) }; it != m_index.end())
+    {
+      return it->second;
+    }
+    const std::uint32_t parent{ node_of(parent_path(path)) };  // [!] O pai é criado antes: fica com índice menor.
+    const auto id{ static_cast<std::uint32_t>(m_nodes.size()) };
+    m_nodes.push_back(Node{ path, parent, {}, 0, 0, {} });
+    m_nodes[parent].children.push_back(id);
+    m_index.emplace(path, id);
+    return id;
+  }
+
+  /**
+   * @brief Soma em @a sums (e em @a n_files) os contadores das linhas [@a first, @a last), cada uma no nó do seu
+   * diretório.
+   */
+  static void accumulate(const ResultStore& results, const vec<std::uint32_t>& row_node, const vec<bool>* excluded,
+                         size_t first, size_t last, vec<ResultStore::Counts>& sums, vec<std::uint64_t>& n_files)
+  {
+    for (size_t row{ first }; row < last; ++row)
+    {
+      if (excluded != nullptr and (*excluded)[row])
+      {
+        continue;
+      }
+      const ResultStore::Counts counts{ results.counts(row) };
+      add(sums[row_node[row]], counts);
+      ++n_files[row_node[row]];
+    }
+  }
+
+  /**
+   * @brief Soma @a from em @a into.
+   */
+  static void add(ResultStore::Counts& into, const ResultStore::Counts& from)
+  {
+    into.n_reg_comments += from.n_reg_comments;
+    into.n_doc_comments += from.n_doc_comments;
+    into.n_blank_lines += from.n_blank_lines;
+    into.n_loc += from.n_loc;
+    into.n_lines += from.n_lines;
+  }
+
+public:
+  /**
+   * @brief Monta a árvore de diretórios de @a results e soma os contadores de cada subárvore.
+   *
+   * @param results    Resultados da análise (devem continuar vivos enquanto a árvore for usada).
+   * @param excluded   Se não for nulo, linhas marcadas com `true` ficam de fora (cópias com `--dedupe-sum once`).
+   * @param n_threads  Threads usadas na soma das linhas.
+   */
+  DirRollup(const ResultStore& results, const vec<bool>* excluded = nullptr, size_t n_threads = 1)
+  {
+    m_nodes.push_back(Node{});
+
+    // [!] 1. Diretório de cada linha (o mesmo da linha anterior dispensa a normalização e a busca no mapa).
+    vec<std::uint32_t> row_node(results.size());
+    str_view last_dir{};
+    std::uint32_t last_node{ ROOT };
+    for (size_t row{ 0 }; row < results.size(); ++row)
+    {
+      const str_view dir{ parent_path(results.path(row)) };
+      if (dir != last_dir)
+      {
+        last_dir = dir;
+        last_node = node_of(normalize(dir));
+      }
+      row_node[row] = last_node;
+    }
+
+    // [!] 2. Soma das linhas nos nós dos seus diretórios, em paralelo em conjuntos grandes.
+    const size_t n_parts{ results.size() >= ROLLUP_PARALLEL_MIN_ROWS ? std::max(size_t{ 1 }, n_threads) : 1 };
+    vec<vec<ResultStore::Counts>> sums(n_parts, vec<ResultStore::Counts>(m_nodes.size()));
+    vec<vec<std::uint64_t>> n_files(n_parts, vec<std::uint64_t>(m_nodes.size(), 0));
+    vec<std::thread> threads{};
+    for (size_t p{ 1 }; p < n_parts; ++p)
+    {
+      threads.emplace_back([&, p] {
+        accumulate(results, row_node, excluded, results.size() * p / n_parts, results.size() * (p + 1) / n_parts, sums[p],
+                   n_files[p]);
+      });
+    }
+    accumulate(results, row_node, excluded, 0, results.size() / n_parts, sums[0], n_files[0]);
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    for (size_t id{ 0 }; id < m_nodes.size(); ++id)
+    {
+      for (size_t p{ 0 }; p < n_parts; ++p)
+      {
+        add(m_nodes[id].counts, sums[p][id]);
+        m_nodes[id].n_own_files += n_files[p][id];
+      }
+      m_nodes[id].n_files = m_nodes[id].n_own_files;
+    }
+
+    // [!] 3. De baixo para cima: todo filho tem índice maior que o pai.
+    for (size_t id{ m_nodes.size() - 1 }; id > ROOT; --id)
+    {
+      Node& parent{ m_nodes[m_nodes[id].parent] };
+      add(parent.counts, m_nodes[id].counts);
+      parent.n_files += m_nodes[id].n_files;
+    }
+
+    for (auto& node : m_nodes)
+    {
+      std::sort(node.children.begin(), node.children.end(),
+                [this](std::uint32_t a, std::uint32_t b) { return m_nodes[a].path < m_nodes[b].path; });
+    }
+  }
+
+  /// @brief Retorna os nós (o nó 0 é a raiz virtual).
+  const vec<Node>& nodes() const { return m_nodes; }
+
+  /**
+   * @brief Retorna os diretórios do topo da exibição.
+   *
+   * @details A partir da raiz virtual, desce enquanto o diretório tiver um único subdiretório e nenhum arquivo próprio:
+   * `sloc -r /usr/include` começa em `/usr/include`, e não em `/` e `/usr`.
+   */
+  vec<std::uint32_t> tops() const
+  {
+    std::uint32_t start{ ROOT };
+    while (m_nodes[start].children.size() == 1 and m_nodes[start].n_own_files == 0)
+    {
+      start = m_nodes[start].children.front();
+    }
+    return start == ROOT ? m_nodes[ROOT].children : vec<std::uint32_t>{ start };
+  }
+
+  /**
+   * @brief Percorre a árvore em pré-ordem, a partir de `tops()`, até a profundidade @a max_depth (os tops têm
+   * profundidade 0).
+   *
+   * @param visit  Chamada com o nó e a sua profundidade.
+   */
+  void walk(size_t max_depth, const std::function<void(const Node&, size_t)>& visit) const
+  {
+    vec<std::pair<std::uint32_t, size_t>> stack{};  //!< (nó, profundidade) ainda por visitar.
+    const vec<std::uint32_t> roots{ tops() };
+    for (auto it{ roots.rbegin() }; it != roots.rend(); ++it)
+    {
+      stack.emplace_back(*it, 0);
+    }
+    while (not stack.empty())
+    {
+      const auto [id, depth] = stack.back();
+      stack.pop_back();
+      visit(m_nodes[id], depth);
+      if (depth < max_depth)
+      {
+        const auto& children{ m_nodes[id].children };
+        for (auto it{ children.rbegin() }; it != children.rend(); ++it)
+        {
+          stack.emplace_back(*it, depth + 1);
+        }
+      }
+    }
+  }
+};
+
+#endif  //!< DIR_ROLLUP_HPP
@@ -32,13 +32,16 @@ using count_t = unsigned long;
 struct FileInfo
 {
 public:
-  str m_filename;               //!< Nome do arquivo (string)
-  LangType m_type;              //!< Tipo de linguagem (enum: C, C++, header, etc.)
-  count_t n_loc{ 0 };           //!< Contador de linhas de código (LOC)
-  count_t n_reg_comments{ 0 };  //!< Contador de linhas de comentários regulares
-  count_t n_doc_comments{ 0 };  //!< Contador de linhas de comentários de documentação
-  count_t n_blank_lines{ 0 };   //!< Contador de linhas em branco
-  count_t n_lines{ 0 };         //!< Contador do total de linhas no arquivo
+  str m_filename;                //!< Nome do arquivo (string)
+  LangType m_type;               //!< Tipo de linguagem (enum: C, C++, header, etc.)
+  count_t n_loc{ 0 };            //!< Contador de linhas de código (LOC)
+  count_t n_reg_comments{ 0 };   //!< Contador de linhas de comentários regulares
+  count_t n_doc_comments{ 0 };   //!< Contador de linhas de comentários de documentação
+  count_t n_blank_lines{ 0 };    //!< Contador de linhas em branco
+  count_t n_lines{ 0 };          //!< Contador do total de linhas no arquivo
+  std::uintmax_t m_size{ 0 };    //!< Tamanho do arquivo em bytes, conhecido desde a descoberta (usado no escalonamento).
+  std::int64_t m_mtime_ns{ 0 };  //!< Última modificação, em nanossegundos desde a época (0: desconhecida).
+  std::uint64_t m_inode{ 0 };    //!< Inode do arquivo (junto com tamanho e `m_mtime_ns`, identifica a versão no cache).
 
   /**
    * @brief Construtor de FileInfo
@@ -85,6 +88,7 @@ public:
     n_doc_comments += other.n_doc_comments;
     n_loc += other.n_loc;
     n_lines += other.n_lines;
+    m_size += other.m_size;
 
     return *this;
   }
@@ -0,0 +1,301 @@
+/**
+ * @file result_store.hpp
+ *
+ * @brief Define a classe ResultStore, que guarda os resultados da análise em colunas compactas.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef RESULT_STORE_HPP
+#define RESULT_STORE_HPP
+
+// STL includes {{{
+#include <array>    // `std::array`
+#include <cstdint>  // `std::uint32_t`, `std::uint64_t`, `std::int64_t`
+#include <limits>   // `std::numeric_limits`
+// }}}
+
+#include "../common/aliases.hpp"  // `str`, `str_view`, `vec`, `umap`, `size_t`
+#include "file_info.hpp"          // `FileInfo`
+#include "lang_type.hpp"          // `LangType`
+
+/**
+ * @brief Resultados da análise, um arquivo por linha, organizados em colunas (*structure of arrays*).
+ *
+ * @details Um `FileInfo` ocupa mais de 100 bytes, fora a alocação do nome no heap. Aqui cada campo é uma coluna
+ * contígua:
+ *   - caminhos: todos concatenados numa única arena de caracteres, e cada linha guarda só (início, comprimento);
+ *   - contadores de linhas: colunas de 32 bits. Um valor que não cabe em 32 bits é marcado com `WIDE` na coluna e
+ *     guardado inteiro num mapa à parte (um arquivo com mais de 4 bilhões de linhas é raro o bastante);
+ *   - tipo, tamanho, mtime e inode (os três últimos para o cache de resultados).
+ *
+ * Ordenar só mexe num vetor de índices (ver `Sort::order`), comparando colunas densas, e somar um contador percorre
+ * uma coluna de inteiros de 32 bits.
+ *
+ * As linhas são numeradas na ordem de descoberta: `assign` aceita linhas fora de ordem (o *pipeline* entrega os
+ * arquivos na ordem em que terminam).
+ */
+class ResultStore
+{
+public:
+  /// @brief Contadores de linhas, na ordem das colunas.
+  enum class Counter : byte
+  {
+    REG_COMMENTS,  //!< Linhas de comentários regulares.
+    DOC_COMMENTS,  //!< Linhas de comentários de documentação.
+    BLANK_LINES,   //!< Linhas em branco.
+    LOC,           //!< Linhas de código.
+    LINES,         //!< Total de linhas.
+  };
+
+  static constexpr size_t N_COUNTERS{ 5 };  //!< Número de colunas de contadores.
+
+  /**
+   * @brief Contadores de um arquivo (ou de vários, somados), com 64 bits.
+   */
+  struct Counts
+  {
+    std::uint64_t n_reg_comments{ 0 };  //!< Linhas de comentários regulares.
+    std::uint64_t n_doc_comments{ 0 };  //!< Linhas de comentários de documentação.
+    std::uint64_t n_blank_lines{ 0 };   //!< Linhas em branco.
+    std::uint64_t n_loc{ 0 };           //!< Linhas de código.
+    std::uint64_t n_lines{ 0 };         //!< Total de linhas.
+  };
+
+private:
+  static constexpr std::uint32_t WIDE{ std::numeric_limits<std::uint32_t>::max() };  //!< Valor guardado em `m_wide`.
+
+  str m_arena{};                                            //!< Todos os caminhos, concatenados.
+  vec<std::uint64_t> m_path_offset{};                       //!< Início do caminho de cada linha na arena.
+  vec<std::uint32_t> m_path_length{};                       //!< Comprimento do caminho de cada linha.
+  vec<LangType> m_type{};                                   //!< Linguagem de cada linha.
+  std::array<vec<std::uint32_t>, N_COUNTERS> m_counters{};  //!< Uma coluna por contador.
+  umap<std::uint64_t, std::uint64_t> m_wide{};              //!< Contadores acima de 32 bits, por (linha, coluna).
+  vec<std::uint64_t> m_size{};                              //!< Tamanho de cada arquivo.
+  vec<std::int64_t> m_mtime_ns{};                           //!< Última modificação de cada arquivo.
+  vec<std::uint64_t> m_inode{};                             //!< Inode de cada arquivo.
+
+  /**
+   * @brief Grava o contador @a column da linha @a row.
+   */
+  void set_count(size_t row, size_t column, std::uint64_t value)
+  {
+    const std::uint64_t key{ static_cast<std::uint64_t>(row) * N_COUNTERS + column };
+    if (value >= WIDE)
+    {
+      m_counters[column][row] = WIDE;
+      m_wide[key] = value;
+    }
+    else
+    {
+      if (m_counters[column][row] == WIDE)
+      {
+        m_wide.erase(key);
+      }
+      m_counters[column][row] = static_cast<std::uint32_t>(value);
+    }
+  }
+
+  /**
+   * @brief Lê o contador @a column da linha @a row.
+   */
+  std::uint64_t get_count(size_t row, size_t column) const
+  {
+    const std::uint32_t value{ m_counters[column][row] };
+    return value != WIDE ? value : m_wide.at(static_cast<std::uint64_t>(row) * N_COUNTERS + column);
+  }
+
+public:
+  /**
+   * @brief Reserva espaço para @a n_rows linhas e @a path_bytes caracteres de caminhos.
+   */
+  void reserve(size_t n_rows, size_t path_bytes = 0)
+  {
+    m_arena.reserve(path_bytes);
+    m_path_offset.reserve(n_rows);
+    m_path_length.reserve(n_rows);
+    m_type.reserve(n_rows);
+    for (auto& column : m_counters)
+    {
+      column.reserve(n_rows);
+    }
+    m_size.reserve(n_rows);
+    m_mtime_ns.reserve(n_rows);
+    m_inode.reserve(n_rows);
+  }
+
+  /**
+   * @brief Ajusta o número de linhas (linhas novas ficam vazias).
+   */
+  void resize(size_t n_rows)
+  {
+    m_path_offset.resize(n_rows, 0);
+    m_path_length.resize(n_rows, 0);
+    m_type.resize(n_rows, LangType::UNDEF);
+    for (auto& column : m_counters)
+    {
+      column.resize(n_rows, 0);
+    }
+    m_size.resize(n_rows, 0);
+    m_mtime_ns.resize(n_rows, 0);
+    m_inode.resize(n_rows, 0);
+  }
+
+  /**
+   * @brief Grava @a file na linha @a row, criando as linhas que faltarem.
+   *
+   * @details O caminho é sempre acrescentado ao fim da arena: regravar uma linha deixa o caminho antigo sem uso.
+   */
+  void assign(size_t row, const FileInfo& file)
+  {
+    if (row >= size())
+    {
+      resize(row + 1);
+    }
+
+    m_path_offset[row] = m_arena.size();
+    m_path_length[row] = static_cast<std::uint32_t>(file.m_filename.size());
+    m_arena += file.m_filename;
+    m_type[row] = file.m_type;
+
+    set_count(row, static_cast<size_t>(Counter::REG_COMMENTS), file.n_reg_comments);
+    set_count(row, static_cast<size_t>(Counter::DOC_COMMENTS), file.n_doc_comments);
+    set_count(row, static_cast<size_t>(Counter::BLANK_LINES), file.n_blank_lines);
+    set_count(row, static_cast<size_t>(Counter::LOC), file.n_loc);
+    set_count(row, static_cast<size_t>(Counter::LINES), file.n_lines);
+
+    m_size[row] = static_cast<std::uint64_t>(file.m_size);
+    m_mtime_ns[row] = file.m_mtime_ns;
+    m_inode[row] = file.m_inode;
+  }
+
+  /**
+   * @brief Acrescenta @a file como nova linha.
+   *
+   * @return size_t  Número da linha.
+   */
+  size_t push(const FileInfo& file)
+  {
+    const size_t row{ size() };
+    assign(row, file);
+    return row;
+  }
+
+  /**
+   * @brief Acrescenta todos os arquivos de @a files e libera a lista (o nome de cada um passa a viver na arena).
+   */
+  void append(vec<FileInfo>& files)
+  {
+    size_t path_bytes{ 0 };
+    for (const auto& file : files)
+    {
+      path_bytes += file.m_filename.size();
+    }
+    reserve(size() + files.size(), m_arena.size() + path_bytes);
+
+    for (auto& file : files)
+    {
+      push(file);
+      str{}.swap(file.m_filename);  // [!] Libera cada nome assim que ele é copiado, sem dobrar o pico de memória.
+    }
+    vec<FileInfo>{}.swap(files);
+  }
+
+  /// @brief Retorna o número de linhas.
+  size_t size() const { return m_type.size(); }
+
+  /// @brief Indica se não há linhas.
+  bool empty() const { return m_type.empty(); }
+
+  /// @brief Retorna o caminho da linha @a row (válido até a próxima inserção).
+  str_view path(size_t row) const { return str_view{ m_arena }.substr(m_path_offset[row], m_path_length[row]); }
+
+  /// @brief Retorna o comprimento do caminho da linha @a row.
+  size_t path_length(size_t row) const { return m_path_length[row]; }
+
+  /// @brief Retorna a linguagem da linha @a row.
+  LangType type(size_t row) const { return m_type[row]; }
+
+  /// @brief Retorna o contador @a counter da linha @a row.
+  std::uint64_t count(size_t row, Counter counter) const { return get_count(row, static_cast<size_t>(counter)); }
+
+  /**
+   * @brief Retorna a coluna de 32 bits do contador @a counter (valores iguais a `wide_mark()` devem ser lidos com
+   * `count`).
+   */
+  const vec<std::uint32_t>& column(Counter counter) const { return m_counters[static_cast<size_t>(counter)]; }
+
+  /// @brief Marca, nas colunas de 32 bits, os valores guardados à parte.
+  static constexpr std::uint32_t wide_mark() { return WIDE; }
+
+  /// @brief Retorna o tamanho do arquivo da linha @a row.
+  std::uint64_t file_size(size_t row) const { return m_size[row]; }
+
+  /// @brief Retorna a última modificação do arquivo da linha @a row.
+  std::int64_t mtime_ns(size_t row) const { return m_mtime_ns[row]; }
+
+  /// @brief Retorna o inode do arquivo da linha @a row.
+  std::uint64_t inode(size_t row) const { return m_inode[row]; }
+
+  /**
+   * @brief Retorna todos os contadores da linha @a row.
+   */
+  Counts counts(size_t row) const
+  {
+    return { get_count(row, 0), get_count(row, 1), get_count(row, 2), get_count(row, 3), get_count(row, 4) };
+  }
+
+  /**
+   * @brief Retorna os contadores de @a file, no formato das linhas.
+   */
+  static Counts counts_of(const FileInfo& file)
+  {
+    return { file.n_reg_comments, file.n_doc_comments, file.n_blank_lines, file.n_loc, file.n_lines };
+  }
+
+  /**
+   * @brief Soma os contadores de todas as linhas, coluna por coluna.
+   *
+   * @param excluded  Se não for nulo, linhas marcadas com `true` ficam de fora.
+   */
+  Counts total(const vec<bool>* excluded = nullptr) const
+  {
+    std::array<std::uint64_t, N_COUNTERS> sums{};
+    for (size_t c{ 0 }; c < N_COUNTERS; ++c)
+    {
+      const vec<std::uint32_t>& values{ m_counters[c] };
+      std::uint64_t sum{ 0 };
+      size_t n_wide{ 0 };
+      for (size_t row{ 0 }; row < values.size(); ++row)
+      {
+        if (excluded == nullptr or not(*excluded)[row])
+        {
+          sum += values[row];
+          n_wide += values[row] == WIDE ? 1 : 0;
+        }
+      }
+      sums[c] = sum;
+      // [!] Troca as marcas somadas pelos valores de verdade (raro: só contadores acima de 32 bits).
+      if (n_wide > 0)
+      {
+        for (const auto& [key, value] : m_wide)
+        {
+          const size_t row{ static_cast<size_t>(key / N_COUNTERS) };
+          if (key % N_COUNTERS == c and (excluded == nullptr or not(*excluded)[row]))
+          {
+            sums[c] += value - WIDE;
+          }
+        }
+      }
+    }
+    return { sums[0], sums[1], sums[2], sums[3], sums[4] };
+  }
+};
+
+#endif  //!< RESULT_STORE_HPP
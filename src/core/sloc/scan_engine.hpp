@@ -0,0 +1,35 @@
+/**
+ * @file scan_engine.hpp
+ *
+ * @brief Define os motores de análise de linhas disponíveis na classe `Sloc`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef SCAN_ENGINE_HPP
+#define SCAN_ENGINE_HPP
+
+#include "../common/aliases.hpp"  // `byte`
+
+/**
+ * @enum ScanEngine
+ *
+ * @brief Enum class que representa os motores de análise de linhas.
+ *
+ * @details Todos os motores produzem as mesmas contagens; eles diferem apenas na forma de percorrer cada linha, o que
+ *          permite compará-los entre si.
+ */
+enum class ScanEngine : byte
+{
+  SCALAR,  //!< Cada caractere passa pela cadeia de verificações `handle_*`.
+  SIMD,    //!< Um kernel vetorizado (SSE2/AVX2/AVX-512) pula os trechos sem bytes especiais.
+  DFA,     //!< Um autômato dirigido por tabelas faz uma leitura de tabela por byte.
+};
+
+#endif  //!< SCAN_ENGINE_HPP
@@ -16,14 +16,25 @@
 #define SLOC_HPP
 
 // STL includes {{{
-#include <fstream>  // `std::ifstream`.
+#include <cstdint>  // `std::uint64_t`
+#include <cstring>  // `std::memchr`.
 // }}}
 
 // Outro includes {{{
-#include "../common/aliases.hpp"  // `str`, `umap`
-#include "../common/utils.hpp"    // `trim()`
-#include "file_info.hpp"          // `FileInfo`
-#include "state.hpp"              // `State`
+#include "../common/aliases.hpp"        // `str_view`
+#include "../common/constants.hpp"      // `STDIN_SOURCE`
+#include "../common/utils.hpp"          // `trim()`
+#include "../core/io/chunk_reader.hpp"  // `ChunkReader`
+#include "../core/io/file_reader.hpp"   // `FileReader`
+#include "../core/io/input_mode.hpp"    // `InputMode`
+#include "../core/profile/trace.hpp"    // `Trace`
+#include "dfa.hpp"                      // `Dfa`
+#include "dfa_stream.hpp"               // `DfaStream`
+#include "file_info.hpp"                // `FileInfo`
+#include "scan_engine.hpp"              // `ScanEngine`
+#include "special_bytes.hpp"            // `SpecialBytes`
+#include "speculative_scan.hpp"         // `SpeculativeScan`
+#include "state.hpp"                    // `State`
 // }}}
 
 class Sloc
@@ -32,6 +43,11 @@ private:
   State m_current_state{ State::UNDEF };  //!< Estado atual da máquina de estados finita. Inicialmente indefinido (`UNDEF`),
   char m_literal_delimiter{ '\0' };       //!< Delimitador atual de literal (ex: aspas simples `'` ou duplas `"`).
   // * '\0' é um caractere especial com valor zero (0 no código ASCII). É a representação do caractere nulo em C e C++.
+  FileReader m_reader{};                  //!< Leitor (mmap/pread) reutilizado entre os arquivos analisados.
+  ChunkReader m_chunk_reader{};           //!< Leitor em blocos, usado no modo `InputMode::STREAM` e na entrada padrão.
+  ScanEngine m_engine;                    //!< Motor de análise de linhas.
+  InputMode m_input_mode;                 //!< Modo de leitura dos arquivos.
+  SpecialBytes::finder m_find_special;    //!< Kernel que localiza bytes especiais (`nullptr` fora do motor SIMD).
 
   /**
    * @brief Reseta os estados da máquina de estados finita.
@@ -60,7 +76,7 @@ private:
    *
    * @param token  Token atual a ser processado.
    */
-  bool handle_escape(const str& token)
+  bool handle_escape(str_view token)
   {
     /* [!]
      * Quando o estado atual é `ESCAPING`, significa que o caractere de escape anterior (`\`) já foi processado, então a
@@ -110,7 +126,7 @@ private:
    *
    * @param token  Token atual a ser processado.
    */
-  bool handle_literal(const str& token)
+  bool handle_literal(str_view token)
   {
     // [!] Checa se um literal já foi aberto.
     if (m_current_state == State::LITERAL)
@@ -173,7 +189,7 @@ private:
    * @param had_reg_comment  Flag indicando se já foi encontrado comentário regular nesta linha.
    * @param had_doc_comment  Flag indicando se já foi encontrado comentário de documentação nesta linha.
    */
-  bool handle_block_comment(const str& token, size_t& cursor, flag& had_code, flag& had_reg_comment, flag& had_doc_comment)
+  bool handle_block_comment(str_view token, size_t& cursor, flag& had_code, flag& had_reg_comment, flag& had_doc_comment)
   {
     // [!] Se já estamos dentro de um comentário de bloco...
     if (in_block_comment())
@@ -258,7 +274,7 @@ private:
    * @param had_doc_comment  Flag indicando se já foi encontrado comentário de documentação nesta linha.
    * @param file            Objeto `FileInfo` que contém informações sobre o arquivo a ser analisado.
    */
-  bool handle_line_comment(const str& token, flag& had_code, flag& had_reg_comment, flag& had_doc_comment)
+  bool handle_line_comment(str_view token, flag& had_code, flag& had_reg_comment, flag& had_doc_comment)
   {
     bool comment_line_identified{ token.size() >= 2 and token[0] == '/' and token[1] == '/' };
 
@@ -306,7 +322,7 @@ private:
    * @param had_doc_comment  Flag indicando se já foi encontrado comentário de documentação nesta linha.
    * @param had_blank_line   Flag indicando se a linha é vazia.
    */
-  void handle_blank_line(const str& line, flag& had_code, flag& had_reg_comment, flag& had_doc_comment, flag& had_blank_line)
+  void handle_blank_line(str_view line, flag& had_code, flag& had_reg_comment, flag& had_doc_comment, flag& had_blank_line)
   {
     if (line.empty())  // [!] Transição de estados: UNDEF -> Ø -> EMPTY
     {
@@ -361,6 +377,123 @@ private:
     }
   }
 
+  /**
+   * @brief Processa o caractere na posição @a cursor da linha, passando pela cadeia de verificações.
+   *
+   * @details A ordem das verificações segue a prioridade descrita em `process_line`: escape, literais, comentários de
+   * bloco, comentários de linha e, por fim, código.
+   *
+   * @param trimmed_line     Linha atual, sem espaços em branco no início e fim.
+   * @param cursor           Posição do caractere atual (avança uma posição extra ao fechar um bloco de comentário).
+   * @param had_code         Flag indicando se já foi encontrado código nesta linha.
+   * @param had_reg_comment  Flag indicando se já foi encontrado comentário regular nesta linha.
+   * @param had_doc_comment  Flag indicando se já foi encontrado comentário de documentação nesta linha.
+   *
+   * @return true   se a análise da linha deve continuar.
+   * @return false  se o restante da linha é um comentário de linha e pode ser ignorado.
+   */
+  bool process_token(str_view trimmed_line, size_t& cursor, flag& had_code, flag& had_reg_comment, flag& had_doc_comment)
+  {
+    // [!] Define o tamanho do token atual como, no máximo, 3 caracteres (ou o restante da linha, se menor).
+    //     Isso permite capturar padrões multicaractere (como `//`, `/*`, `*/`) sem ultrapassar os limites da string.
+    const std::size_t token_size{ std::min(size_t{ 3 }, trimmed_line.size() - cursor) };
+    // [!] Extrai o token a partir da posição atual do cursor, com o tamanho definido.
+    //     Esse token será usado nas verificações de escape, literais e comentários. Como é uma `str_view`, apenas
+    //     aponta para a linha, sem alocar nem copiar.
+    const str_view token{ trimmed_line.substr(cursor, token_size) };
+
+    // [!] #1 Lida com caracteres de escape.
+    if (handle_escape(token))
+    {
+      return true;  // [!] Caractere de escape identificado, ignora próximas verificações.
+    }
+
+    // [!] #2 Lida com literais.
+    if (handle_literal(token))
+    {
+      had_code = true;
+      return true;  // [!] Literal identificado, ignora próximas verificações.
+    }
+
+    // [!] #3 Lida com blocos de comentário.
+    if (handle_block_comment(token, cursor, had_code, had_reg_comment, had_doc_comment))
+    {
+      return true;  // [!] Bloco de comentário indentificado, ignora próximas verificações.
+    }
+
+    // [!] #4 Lida com linhas de comentário.
+    if (handle_line_comment(token, had_code, had_reg_comment, had_doc_comment))
+    {
+      transition_to(State::UNDEF);  // [!] Transição de estados: LINE_DOC_COMMENT -> \n -> UNDEF ou LINE_REG_COMMENT -> \n -> UNDEF.
+      /* [!]
+       * Se uma linha de comentário foi identificada, retornar `false` encerra a verificação da linha atual,
+       * independentemente da posição do cursor. Isso ocorre porque, a partir desse ponto, todo o restante da linha
+       * será considerado comentário.
+       */
+      return false;  // [!] Linha de comentário identificada.
+    }
+
+    /* [!]
+     * Espaços em branco isolados não representam código e não devem acionar transição para `CODE`.
+     * Do contrário, espaços entre dois blocos de comentário poderiam ser erroneamente contados como linhas de código.
+     */
+    if ((std::isspace(token[0]) == 0) and not in_block_comment() and not had_code)
+    {
+      // [!] Transição de estados: UNDEF -> !=(Ø, //, /*) -> CODE
+      transition_to(State::CODE);  // [!] #5 O que não for vazio, nem comentário, e não for um espaço em branco, é visto como código.
+      had_code = true;
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Processa um trecho da linha que não contém nenhum byte especial (`/ * " ' \\`).
+   *
+   * @details Sem bytes especiais, nenhum caractere do trecho pode abrir ou fechar literais e comentários, então o efeito
+   * do trecho inteiro é o mesmo que o da cadeia de `process_token` aplicada caractere por caractere:
+   *   - em `ESCAPING`, o primeiro caractere encerra a sequência de escape e o restante é conteúdo do literal;
+   *   - em `LITERAL`, todo o trecho é código;
+   *   - dentro de um bloco de comentário, todo o trecho é comentário;
+   *   - fora disso, o trecho é código se tiver algum caractere que não seja espaço em branco.
+   *
+   * @param run              Trecho sem bytes especiais.
+   * @param had_code         Flag indicando se já foi encontrado código nesta linha.
+   * @param had_reg_comment  Flag indicando se já foi encontrado comentário regular nesta linha.
+   * @param had_doc_comment  Flag indicando se já foi encontrado comentário de documentação nesta linha.
+   */
+  void process_plain_run(str_view run, flag& had_code, flag& had_reg_comment, flag& had_doc_comment)
+  {
+    if (run.empty())
+    {
+      return;
+    }
+
+    if (m_current_state == State::ESCAPING)
+    {
+      transition_to(State::LITERAL);  // [!] Transição de estados: ESCAPING -> c -> LITERAL.
+      run.remove_prefix(1);
+      if (run.empty())
+      {
+        return;
+      }
+    }
+
+    if (m_current_state == State::LITERAL)
+    {
+      had_code = true;
+    }
+    else if (in_block_comment())
+    {
+      (m_current_state == State::BLOCK_REG_COMMENT ? had_reg_comment : had_doc_comment) = true;
+    }
+    else if (not had_code and run.find_first_not_of(WHITESPACE) != str_view::npos)
+    {
+      transition_to(State::CODE);  // [!] Transição de estados: UNDEF -> !=(Ø, //, /*) -> CODE
+      had_code = true;
+    }
+  }
+
   /**
    * @brief Processa uma linha de código e atualiza as contagens de linhas no objeto `FileInfo`.
    *
@@ -397,9 +530,9 @@ private:
    * @param line  linha a ser processada.
    * @param file  objeto `FileInfo` que contém informações sobre o arquivo a ser analisado.
    */
-  void process_line(const str& line, FileInfo& file)
+  void process_line(str_view line, FileInfo& file)
   {
-    const str trimmed_line{ trim(line) };  //!< Linha atual sem espaços em branco no início e fim.
+    const str_view trimmed_line{ trim(line) };  //!< Linha atual sem espaços em branco no início e fim (sem cópias).
 
     flag had_code{ false };         //!< Flag para indicar se já foi encontrado código nesta linha.
     flag had_reg_comment{ false };  //!< Flag para indicar se já foi encontrado comentário regular nesta linha.
@@ -413,56 +546,33 @@ private:
      */
     handle_blank_line(trimmed_line, had_code, had_reg_comment, had_doc_comment, had_blank_line);
 
-    // [!] Percorre caractere por caractere da linha atual.
-    for (std::size_t cursor{ 0 }; cursor < trimmed_line.size(); ++cursor)
+    if (m_find_special == nullptr)
     {
-      // [!] Define o tamanho do token atual como, no máximo, 3 caracteres (ou o restante da linha, se menor).
-      //     Isso permite capturar padrões multicaractere (como `//`, `/*`, `*/`) sem ultrapassar os limites da string.
-      const std::size_t token_size{ std::min(size_t{ 3 }, trimmed_line.size() - cursor) };
-      // [!] Extrai o token a partir da posição atual do cursor, com o tamanho definido.
-      //     Esse token será usado nas verificações de escape, literais e comentários.
-      const str token{ trimmed_line.substr(cursor, token_size) };
-
-      // [!] #1 Lida com caracteres de escape.
-      if (handle_escape(token))
+      // [!] Motor escalar: percorre caractere por caractere da linha atual.
+      for (std::size_t cursor{ 0 }; cursor < trimmed_line.size(); ++cursor)
       {
-        continue;  // [!] Caractere de escape identificado, ignora próximas verificações.
-      }
-
-      // [!] #2 Lida com literais.
-      if (handle_literal(token))
-      {
-        had_code = true;
-        continue;  // [!] Literal identificado, ignora próximas verificações.
-      }
-
-      // [!] #3 Lida com blocos de comentário.
-      if (handle_block_comment(token, cursor, had_code, had_reg_comment, had_doc_comment))
-      {
-        continue;  // [!] Bloco de comentário indentificado, ignora próximas verificações.
+        if (not process_token(trimmed_line, cursor, had_code, had_reg_comment, had_doc_comment))
+        {
+          break;
+        }
       }
-
-      // [!] #4 Lida com linhas de comentário.
-      if (handle_line_comment(token, had_code, had_reg_comment, had_doc_comment))
+    }
+    else
+    {
+      // [!] Motor vetorizado: a cadeia de verificações só roda nos bytes especiais; os trechos entre eles são tratados
+      //     de uma vez por `process_plain_run`.
+      const char* data{ trimmed_line.data() };
+      for (std::size_t cursor{ 0 }; cursor < trimmed_line.size(); ++cursor)
       {
-        transition_to(State::UNDEF);  // [!] Transição de estados: LINE_DOC_COMMENT -> \n -> UNDEF ou LINE_REG_COMMENT -> \n -> UNDEF.
-        /* [!]
-         * Se uma linha de comentário foi identificada, o `break` encerra a verificação da linha atual,
-         * independentemente da posição do cursor. Isso ocorre porque, a partir desse ponto, todo o restante da linha
-         * será considerado comentário.
-         */
-        break;  // [!] Linha de comentário identificada.
-      }
+        const auto special{ static_cast<size_t>(m_find_special(data + cursor, data + trimmed_line.size()) - data) };
+        process_plain_run(trimmed_line.substr(cursor, special - cursor), had_code, had_reg_comment, had_doc_comment);
 
-      /* [!]
-       * Espaços em branco isolados não representam código e não devem acionar transição para `CODE`.
-       * Do contrário, espaços entre dois blocos de comentário poderiam ser erroneamente contados como linhas de código.
-       */
-      if ((std::isspace(token[0]) == 0) and not in_block_comment() and not had_code)
-      {
-        // [!] Transição de estados: UNDEF -> !=(Ø, //, /*) -> CODE
-        transition_to(State::CODE);  // [!] #5 O que não for vazio, nem comentário, e não for um espaço em branco, é visto como código.
-        had_code = true;
+        cursor = special;
+        if (cursor >= trimmed_line.size()
+            or not process_token(trimmed_line, cursor, had_code, had_reg_comment, had_doc_comment))
+        {
+          break;
+        }
       }
     }
 
@@ -470,39 +580,132 @@ private:
     finalize_line_processing(had_code, had_reg_comment, had_doc_comment, had_blank_line, file);
   }
 
+  /**
+   * @brief Processa o conteúdo completo de um arquivo, linha por linha.
+   *
+   * @details As linhas são delimitadas por `\n`, exatamente como `std::getline`: o `\n` não faz parte da linha, e
+   * um trecho final sem `\n` só conta como linha se não estiver vazio.
+   *
+   * @param contents  Conteúdo completo do arquivo.
+   * @param file      objeto `FileInfo` que contém informações sobre o arquivo a ser analisado.
+   */
+  void process_contents(str_view contents, FileInfo& file)
+  {
+    // [!] O motor DFA percorre o conteúdo com o autômato dirigido por tabelas, que tem seu próprio estado.
+    if (m_engine == ScanEngine::DFA)
+    {
+      DfaState state{ DfaState::CODE };
+      Dfa::scan(state, contents, file);
+      return;
+    }
+
+    // [!] Reinicia os estados da máquina antes de começar o processamento.
+    reset_states();
+
+    const char* cursor{ contents.data() };        //!< Início da linha atual.
+    const char* end{ cursor + contents.size() };  //!< Fim do conteúdo.
+
+    while (cursor < end)
+    {
+      // [!] Procura o fim da linha atual (ou usa o fim do conteúdo, se for a última linha sem `\n`).
+      const auto* newline{ static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor))) };
+      const char* line_end{ newline != nullptr ? newline : end };
+
+      // [!] Processa a linha atual usando a máquina de estados, apontando diretamente para o conteúdo do arquivo.
+      process_line(str_view{ cursor, static_cast<size_t>(line_end - cursor) }, file);
+
+      cursor = line_end + 1;
+    }
+  }
+
   /**
    * @brief Lê e processa o arquivo de entrada.
    *
-   * @details Esta função lê o arquivo de entrada linha por linha e processa cada linha usando a máquina de estados.
-   * A função `reset_states` é chamada para reiniciar os estados da máquina antes de começar o processamento.
-   * A função `process_line` é chamada para processar cada linha lida do arquivo.
+   * @details O arquivo inteiro é entregue pelo `FileReader` como um único bloco contíguo (mapeado em memória ou lido
+   * com `pread`) e então processado linha por linha pela máquina de estados.
    *
    * @param file  objeto `FileInfo` que contém informações sobre o arquivo a ser analisado.
    */
   void read_and_process(FileInfo& file)
   {
-    // [!] Abre o arquivo de entrada com o nome armazenado em `file.filename`.
-    std::ifstream ifs{ file.m_filename };
+    // [!] A entrada padrão não pode ser mapeada nem lida com `pread`: sempre é lida em blocos.
+    if (m_input_mode == InputMode::STREAM or file.m_filename == STDIN_SOURCE)
+    {
+      stream_and_process(file);
+      return;
+    }
+
+    // [!] Abre o arquivo de entrada com o nome armazenado em `file.m_filename`.
+    const auto opened{ Trace::now() };
+    const std::optional<str_view> contents{ m_reader.open(file.m_filename.c_str()) };
 
     // [!] Verifica se o arquivo foi aberto com sucesso.
-    if (ifs.is_open())
+    if (contents)
     {
-      str line{};  //!< Buffer para armazenar a linha atual sendo lida do arquivo.
+      const auto scanned{ Trace::now() };
+      process_contents(*contents, file);
+      Trace::file(file.m_filename, contents->size(), opened, scanned, Trace::now());
+    }
+
+    m_reader.release();  // [!] Libera o mapeamento após a leitura.
+  }
 
-      // [!] Reinicia os estados da máquina antes de começar o processamento.
-      reset_states();
+  /**
+   * @brief Lê e processa o arquivo de entrada em blocos de tamanho fixo.
+   *
+   * @details Os blocos são lidos para um buffer único (`ChunkReader`) e consumidos pelo `DfaStream`, que carrega o
+   * estado do autômato e as linhas cortadas de um bloco para o outro. A memória usada é a mesma para qualquer tamanho de
+   * arquivo ou de linha. Neste modo o motor é sempre o `Dfa`, o único que não precisa da linha inteira em memória.
+   *
+   * @param file  objeto `FileInfo` que contém informações sobre o arquivo a ser analisado.
+   */
+  void stream_and_process(FileInfo& file)
+  {
+    const auto opened{ Trace::now() };
+    if (file.m_filename == STDIN_SOURCE)
+    {
+      m_chunk_reader.open_stdin();
+    }
+    else if (not m_chunk_reader.open(file.m_filename.c_str()))
+    {
+      return;  // [!] Arquivo não pôde ser aberto: fica sem contagens, como no modo mapeado.
+    }
 
-      // [!] Lê o arquivo linha por linha até o final (EOF).
-      while (std::getline(ifs, line))
-      {
-        process_line(line, file);  // [!] Processa a linha atual usando a máquina de estados.
-      }
+    // [!] Neste modo a leitura dos blocos acontece dentro do intervalo de análise.
+    const auto scanned{ Trace::now() };
+    DfaStream stream{};
+    std::optional<str_view> chunk{ m_chunk_reader.next() };
+    std::uint64_t n_bytes{ 0 };
+    while (chunk and not chunk->empty())
+    {
+      stream.feed(*chunk, file);
+      n_bytes += chunk->size();
+      chunk = m_chunk_reader.next();
     }
+    stream.finish(file);
+    Trace::file(file.m_filename, n_bytes, opened, scanned, Trace::now());
 
-    ifs.close();  // [!] Fecha o arquivo após a leitura.
+    m_chunk_reader.close();
   }
 
 public:
+  /**
+   * @brief Constrói um contador usando o motor de análise @a engine.
+   *
+   * @param engine  `ScanEngine::SCALAR` passa cada caractere pela cadeia de verificações; `ScanEngine::SIMD` usa o
+   *                kernel vetorizado mais rápido suportado pelo processador para pular os trechos sem bytes especiais;
+   *                `ScanEngine::DFA` usa o autômato dirigido por tabelas (`Dfa`). Todos os motores produzem
+   *                exatamente as mesmas contagens.
+   * @param input_mode  `InputMode::MAPPED` entrega cada arquivo inteiro ao motor; `InputMode::STREAM` lê os arquivos
+   *                    em blocos de tamanho fixo (e, nesse caso, usa sempre o `Dfa`).
+   */
+  explicit Sloc(ScanEngine engine = ScanEngine::DFA, InputMode input_mode = InputMode::MAPPED)
+    : m_engine{ engine }
+    , m_input_mode{ input_mode }
+    , m_find_special{ engine == ScanEngine::SIMD ? SpecialBytes::best() : nullptr }
+  { /* empty */
+  }
+
   /**
    * @brief função que inicia a análise de um arquivo.
    *
@@ -516,6 +719,39 @@ public:
   {
     read_and_process(file);  // [!] Inicia leitura e análise linha a linha do arquivo.
   }
+
+  /**
+   * @brief Analisa um conteúdo já carregado em memória, como se fosse um arquivo completo.
+   *
+   * @param contents  Conteúdo a ser analisado.
+   * @param file      objeto `FileInfo` cujas contagens serão incrementadas.
+   */
+  void analyze_contents(str_view contents, FileInfo& file) { process_contents(contents, file); }
+
+  /**
+   * @brief Analisa, de forma especulativa, um único pedaço de um arquivo enorme (veja `SpeculativeScan`).
+   *
+   * @details O arquivo é mapeado inteiro, mas só as páginas do pedaço (e a busca pelo `\n` de cada ponta) são de fato
+   * lidas. Se o arquivo não puder ser aberto, @a chunk fica marcado como não analisado.
+   *
+   * @param file        Arquivo ao qual o pedaço pertence (só o nome é usado).
+   * @param index       Índice do pedaço.
+   * @param n_chunks    Quantidade total de pedaços do arquivo.
+   * @param chunk_size  Tamanho nominal de cada pedaço.
+   * @param chunk       Recebe as contagens do pedaço para cada estado de entrada possível.
+   */
+  void analyze_chunk(const FileInfo& file, size_t index, size_t n_chunks, size_t chunk_size, SpeculativeScan::Chunk& chunk)
+  {
+    const auto opened{ Trace::now() };
+    const std::optional<str_view> contents{ m_reader.open(file.m_filename.c_str()) };
+    if (contents)
+    {
+      const str_view piece{ SpeculativeScan::chunk_of(*contents, index, n_chunks, chunk_size) };
+      chunk = SpeculativeScan::scan(piece);
+      Trace::span("scan chunk", opened, Trace::now(), file.m_filename, piece.size());
+    }
+    m_reader.release();
+  }
 };
 
 #endif  //!< SLOC_HPP
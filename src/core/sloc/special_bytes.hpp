@@ -0,0 +1,205 @@
+/**
+ * @file special_bytes.hpp
+ *
+ * @brief Define a classe SpecialBytes, um kernel vetorizado que localiza os únicos bytes capazes de alterar a máquina
+ * de estados do `Sloc`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef SPECIAL_BYTES_HPP
+#define SPECIAL_BYTES_HPP
+
+#if defined(__x86_64__) or defined(__i386__)
+# define SLOC_HAS_X86_SIMD 1
+# include <immintrin.h>  // Intrínsecos SSE2/AVX2/AVX-512.
+#else
+# define SLOC_HAS_X86_SIMD 0
+#endif
+
+#include "../common/aliases.hpp"  // `str_view`
+
+/**
+ * @brief Localiza, em blocos de 16/32/64 bytes, a próxima ocorrência de um byte "especial".
+ *
+ * @details Os bytes especiais são `/ * " ' \ \n`: fora deles, nenhum caractere muda o estado da máquina de estados do
+ * `Sloc` (só importa se é ou não espaço em branco). O kernel compara um bloco inteiro contra os seis bytes de uma vez,
+ * junta os resultados em uma máscara de bits e retorna a posição do primeiro bit ligado.
+ *
+ * A versão SSE2 é a base em x86-64; AVX2 e AVX-512 (BW) são escolhidas em tempo de execução, de acordo com o que o
+ * processador informa via `cpuid`. Em outras arquiteturas apenas a versão escalar está disponível.
+ */
+class SpecialBytes
+{
+public:
+  /// @brief Assinatura do kernel: retorna o primeiro byte especial em `[first, last)`, ou `last`.
+  using finder = const char* (*)(const char* first, const char* last);
+
+private:
+  /**
+   * @brief Retorna se @a c é um byte especial.
+   */
+  static bool is_special(char c) { return c == '/' or c == '*' or c == '"' or c == '\'' or c == '\\' or c == '\n'; }
+
+  /**
+   * @brief Kernel escalar, usado nos restos de bloco e como referência.
+   */
+  static const char* find_scalar(const char* first, const char* last)
+  {
+    while (first < last and not is_special(*first))
+    {
+      ++first;
+    }
+    return first;
+  }
+
+#if SLOC_HAS_X86_SIMD
+  /**
+   * @brief Kernel SSE2: blocos de 16 bytes.
+   */
+  static const char* find_sse2(const char* first, const char* last)
+  {
+    const __m128i slash{ _mm_set1_epi8('/') };
+    const __m128i star{ _mm_set1_epi8('*') };
+    const __m128i dquote{ _mm_set1_epi8('"') };
+    const __m128i squote{ _mm_set1_epi8('\'') };
+    const __m128i backslash{ _mm_set1_epi8('\\') };
+    const __m128i newline{ _mm_set1_epi8('\n') };
+
+    for (; last - first >= 16; first += 16)
+    {
+      const __m128i block{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(first)) };
+      __m128i hits{ _mm_or_si128(_mm_cmpeq_epi8(block, slash), _mm_cmpeq_epi8(block, star)) };
+      hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(block, dquote), _mm_cmpeq_epi8(block, squote)));
+      hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(block, backslash), _mm_cmpeq_epi8(block, newline)));
+
+      const auto mask{ static_cast<unsigned>(_mm_movemask_epi8(hits)) };
+      if (mask != 0)
+      {
+        return first + __builtin_ctz(mask);
+      }
+    }
+    return find_scalar(first, last);
+  }
+
+  /**
+   * @brief Kernel AVX2: blocos de 32 bytes.
+   */
+  __attribute__((target("avx2"))) static const char* find_avx2(const char* first, const char* last)
+  {
+    const __m256i slash{ _mm256_set1_epi8('/') };
+    const __m256i star{ _mm256_set1_epi8('*') };
+    const __m256i dquote{ _mm256_set1_epi8('"') };
+    const __m256i squote{ _mm256_set1_epi8('\'') };
+    const __m256i backslash{ _mm256_set1_epi8('\\') };
+    const __m256i newline{ _mm256_set1_epi8('\n') };
+
+    for (; last - first >= 32; first += 32)
+    {
+      const __m256i block{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)) };
+      __m256i hits{ _mm256_or_si256(_mm256_cmpeq_epi8(block, slash), _mm256_cmpeq_epi8(block, star)) };
+      hits = _mm256_or_si256(hits, _mm256_or_si256(_mm256_cmpeq_epi8(block, dquote), _mm256_cmpeq_epi8(block, squote)));
+      hits = _mm256_or_si256(hits, _mm256_or_si256(_mm256_cmpeq_epi8(block, backslash), _mm256_cmpeq_epi8(block, newline)));
+
+      const auto mask{ static_cast<unsigned>(_mm256_movemask_epi8(hits)) };
+      if (mask != 0)
+      {
+        return first + __builtin_ctz(mask);
+      }
+    }
+    return find_sse2(first, last);  // [!] O resto (< 32 bytes) ainda pode aproveitar um bloco de 16.
+  }
+
+  /**
+   * @brief Kernel AVX-512 (BW): blocos de 64 bytes, com as comparações gerando máscaras diretamente.
+   */
+  __attribute__((target("avx512f,avx512bw"))) static const char* find_avx512(const char* first, const char* last)
+  {
+    const __m512i slash{ _mm512_set1_epi8('/') };
+    const __m512i star{ _mm512_set1_epi8('*') };
+    const __m512i dquote{ _mm512_set1_epi8('"') };
+    const __m512i squote{ _mm512_set1_epi8('\'') };
+    const __m512i backslash{ _mm512_set1_epi8('\\') };
+    const __m512i newline{ _mm512_set1_epi8('\n') };
+
+    for (; last - first >= 64; first += 64)
+    {
+      const __m512i block{ _mm512_loadu_si512(first) };
+      const __mmask64 mask{ _mm512_cmpeq_epi8_mask(block, slash) | _mm512_cmpeq_epi8_mask(block, star)
+                            | _mm512_cmpeq_epi8_mask(block, dquote) | _mm512_cmpeq_epi8_mask(block, squote)
+                            | _mm512_cmpeq_epi8_mask(block, backslash) | _mm512_cmpeq_epi8_mask(block, newline) };
+      if (mask != 0)
+      {
+        return first + __builtin_ctzll(mask);
+      }
+    }
+    return find_sse2(first, last);  // [!] O resto (< 64 bytes) ainda pode aproveitar blocos de 16.
+  }
+#endif
+
+  /**
+   * @brief Escolhe o melhor kernel suportado pelo processador atual.
+   */
+  static finder select()
+  {
+#if SLOC_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+    {
+      return find_avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return find_avx2;
+    }
+    return find_sse2;
+#else
+    return find_scalar;
+#endif
+  }
+
+public:
+  /**
+   * @brief Retorna o kernel escalar.
+   */
+  static finder scalar() { return find_scalar; }
+
+  /**
+   * @brief Retorna o melhor kernel disponível (escolhido uma única vez, na primeira chamada).
+   */
+  static finder best()
+  {
+    static const finder chosen{ select() };
+    return chosen;
+  }
+
+  /**
+   * @brief Retorna o nome do conjunto de instruções usado por @a kernel (útil para relatórios e comparações).
+   */
+  static str_view name(finder kernel)
+  {
+#if SLOC_HAS_X86_SIMD
+    if (kernel == find_avx512)
+    {
+      return "avx512";
+    }
+    if (kernel == find_avx2)
+    {
+      return "avx2";
+    }
+    if (kernel == find_sse2)
+    {
+      return "sse2";
+    }
+#endif
+    return kernel == find_scalar ? "scalar" : "unknown";
+  }
+};
+
+#endif  //!< SPECIAL_BYTES_HPP
@@ -0,0 +1,191 @@
+/**
+ * @file speculative_scan.hpp
+ *
+ * @brief Define a classe SpeculativeScan, que divide um arquivo enorme em pedaços analisáveis em paralelo.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-05-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef SPECULATIVE_SCAN_HPP
+#define SPECULATIVE_SCAN_HPP
+
+// STL includes {{{
+#include <algorithm>  // `std::min`
+#include <array>      // `std::array`
+#include <cstring>    // `std::memchr`
+// }}}
+
+#include "../common/aliases.hpp"  // `str_view`, `vec`, `size_t`
+#include "dfa.hpp"                // `Dfa`, `DfaState`
+#include "file_info.hpp"          // `FileInfo`
+
+/**
+ * @brief Análise especulativa de um pedaço de arquivo, para quando o estado de entrada ainda não é conhecido.
+ *
+ * @details Um arquivo enorme é cortado em pedaços que começam logo após um `\n`. No início de uma linha o `Dfa` só
+ * pode estar em um de cinco estados (`ENTRY_STATES`: código, literal `"`, literal `'`, bloco regular, bloco de
+ * documentação), então cada pedaço é analisado, de forma independente, uma vez para cada um desses estados. Depois que
+ * todos os pedaços terminam, `stitch` percorre os resultados em ordem: o pedaço 0 começa em `CODE`, e o estado de
+ * saída da especulação escolhida em um pedaço é o estado de entrada do seguinte. O resultado é idêntico ao de uma
+ * análise sequencial.
+ *
+ * As especulações não custam cinco vezes mais: em cada linha, especulações que estão no mesmo estado produzem o mesmo
+ * resultado, então a linha é analisada uma única vez por estado distinto. Em código real elas convergem para o mesmo
+ * estado em poucas linhas (basta um `"` ou um `* /`); a partir daí o restante do pedaço é analisado uma única vez.
+ */
+class SpeculativeScan
+{
+public:
+  static constexpr size_t N_ENTRIES{ 5 };  //!< Quantidade de estados possíveis no início de uma linha.
+
+  /// @brief Estados possíveis no início de uma linha, na ordem das especulações.
+  static constexpr std::array<DfaState, N_ENTRIES> ENTRY_STATES{ DfaState::CODE, DfaState::LIT_DQ, DfaState::LIT_SQ,
+                                                                 DfaState::BLOCK_REG, DfaState::BLOCK_DOC };
+
+  /**
+   * @brief Resultado da análise de um pedaço, uma entrada por estado de entrada possível.
+   */
+  struct Chunk
+  {
+    std::array<FileInfo, N_ENTRIES> counts{};                //!< Contagens do pedaço, por estado de entrada.
+    std::array<DfaState, N_ENTRIES> exits{ ENTRY_STATES };  //!< Estado ao fim do pedaço, por estado de entrada.
+    bool scanned{ false };                                  //!< Indica se o pedaço foi de fato analisado.
+  };
+
+private:
+  /**
+   * @brief Retorna a posição de @a state em `ENTRY_STATES`, ou `N_ENTRIES` se ele não é um estado de início de linha.
+   */
+  static constexpr size_t entry_index(DfaState state)
+  {
+    for (size_t e{ 0 }; e < N_ENTRIES; ++e)
+    {
+      if (ENTRY_STATES[e] == state)
+      {
+        return e;
+      }
+    }
+    return N_ENTRIES;
+  }
+
+public:
+  /**
+   * @brief Retorna o pedaço @a index de @a contents, com limites ajustados para o início de uma linha.
+   *
+   * @details Os limites nominais são múltiplos de @a chunk_size; cada um é empurrado para logo após o próximo `\n`.
+   * Como o ajuste só depende do conteúdo, cada pedaço calcula seus limites sozinho, e pedaços vizinhos nunca se
+   * sobrepõem nem deixam buracos. O último pedaço vai até o fim do conteúdo.
+   */
+  static str_view chunk_of(str_view contents, size_t index, size_t n_chunks, size_t chunk_size)
+  {
+    auto line_start{ [contents](size_t position) -> size_t {
+      if (position == 0 or position >= contents.size())
+      {
+        return std::min(position, contents.size());
+      }
+      const void* newline{ std::memchr(contents.data() + position - 1, '\n', contents.size() - position + 1) };
+      return newline == nullptr ? contents.size() : static_cast<size_t>(static_cast<const char*>(newline) - contents.data()) + 1;
+    } };
+
+    const size_t first{ line_start(index * chunk_size) };
+    const size_t last{ index + 1 >= n_chunks ? contents.size() : line_start((index + 1) * chunk_size) };
+    return first < last ? contents.substr(first, last - first) : str_view{};
+  }
+
+  /**
+   * @brief Analisa @a contents uma vez para cada estado de `ENTRY_STATES`.
+   */
+  static Chunk scan(str_view contents)
+  {
+    Chunk chunk{};
+    chunk.scanned = true;
+
+    std::array<DfaState, N_ENTRIES>& states{ chunk.exits };  //!< Estado atual de cada especulação.
+
+    const char* cursor{ contents.data() };
+    const char* end{ cursor + contents.size() };
+
+    while (cursor < end)
+    {
+      const auto* newline{ static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor))) };
+      const char* line_end{ newline != nullptr ? newline : end };
+      const str_view trimmed_line{ Dfa::trim(str_view{ cursor, static_cast<size_t>(line_end - cursor) }) };
+
+      // [!] Especulações que começam a linha no mesmo estado reaproveitam a análise da primeira delas.
+      const std::array<DfaState, N_ENTRIES> entries{ states };
+      std::array<byte, N_ENTRIES> actions{};
+      for (size_t e{ 0 }; e < N_ENTRIES; ++e)
+      {
+        size_t same{ 0 };
+        while (entries[same] != entries[e])
+        {
+          ++same;
+        }
+
+        if (same == e)
+        {
+          actions[e] = Dfa::scan_line(states[e], trimmed_line);
+        }
+        else
+        {
+          states[e] = states[same];
+          actions[e] = actions[same];
+        }
+        Dfa::count_line(actions[e], chunk.counts[e]);
+      }
+
+      cursor = line_end + 1;
+
+      // [!] Todas convergiram: o restante do pedaço é o mesmo para todas e é analisado uma única vez.
+      if (states[1] == states[0] and states[2] == states[0] and states[3] == states[0] and states[4] == states[0])
+      {
+        break;
+      }
+    }
+
+    if (cursor < end)
+    {
+      FileInfo rest{};
+      Dfa::scan(states[0], str_view{ cursor, static_cast<size_t>(end - cursor) }, rest);
+      for (size_t e{ 0 }; e < N_ENTRIES; ++e)
+      {
+        chunk.counts[e] += rest;
+        states[e] = states[0];
+      }
+    }
+
+    return chunk;
+  }
+
+  /**
+   * @brief Costura os resultados dos pedaços, em ordem, somando em @a file as contagens do caminho verdadeiro.
+   *
+   * @return bool  `false` (e @a file intacto) se algum pedaço não foi analisado, por exemplo porque o arquivo não
+   *               pôde ser aberto.
+   */
+  static bool stitch(const vec<Chunk>& chunks, FileInfo& file)
+  {
+    FileInfo total{};
+    size_t entry{ entry_index(DfaState::CODE) };
+    for (const auto& chunk : chunks)
+    {
+      if (not chunk.scanned or entry >= N_ENTRIES)
+      {
+        return false;
+      }
+      total += chunk.counts[entry];
+      entry = entry_index(chunk.exits[entry]);
+    }
+
+    file += total;
+    return true;
+  }
+};
+
+#endif  //!< SPECULATIVE_SCAN_HPP
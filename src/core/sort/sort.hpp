@@ -14,16 +14,19 @@
 #define SORT_HPP
 
 #include <algorithm>
-#include <functional>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <utility>
 
 #include "../common/aliases.hpp"
+#include "../common/constants.hpp"
 #include "../core/filter/field_option.hpp"
 #include "../core/options/running_options.hpp"
 #include "../core/sloc/file_info.hpp"
-
-//==================================================Aliases==================================================//
-using func = std::function<bool(const FileInfo&, const FileInfo&)>;
-//=============================================================================================================//
+#include "../core/sloc/result_store.hpp"
 
 class Sort
 {
@@ -34,12 +37,8 @@ public:
    *  `RunningOptions`. Caso o campo não deseja ativada, a ordem de
    *  ordenação padrão é decrescente.
    *
-   * @details A função utiliza um mapa para associar cada campo a uma função de comparação
-   *  apropriada. A função de comparação é então usada para ordenar o vetor de arquivos.
-   *  A função de comparação é definida como uma função lambda que compara dois objetos
-   *  `FileInfo` com base no campo especificado. A função de comparação retorna verdadeiro
-   *  se o primeiro objeto deve vir antes do segundo na ordenação, com base no campo
-   *  especificado e na ordem de classificação (crescente ou decrescente).
+   * @details A comparação de cada campo é escolhida uma única vez (um `switch`, sem mapa de `std::function`), e a
+   *  ordenação é estável: arquivos empatados mantêm a ordem em que estavam.
    *  A função `sortSloc` é um método estático que pode ser chamado sem a necessidade de
    *  criar uma instância da classe `Sort`.
    *
@@ -53,52 +52,397 @@ public:
    *  - `FieldOption::DOC_COMENTS`: ordena por número de comentários de documentação.
    *  - `FieldOption::BLANK_LINES`: ordena por número de linhas em branco.
    *  - `FieldOption::ALL`: ordena por número total de linhas.
+   *  - `FieldOption::COMMENT_DENSITY`: ordena pela fração de linhas que são comentários.
    *
    * @param ro  Estrutura `RunningOptions` que contém as opções de execução, incluindo
    *  a ordem de classificação (crescente ou decrescente) e o campo de ordenação.
    */
   static void sortSloc(vec<FileInfo>& files, const FieldOption option, const RunningOptions& ro)
   {
-    //[!] Mapa de comparação para cada campo de ordenação.
-    // [!] O mapa associa cada campo a uma função de comparação apropriada.
-    umap<FieldOption, func> sorting_compare = { { FieldOption::FILENAME, cmp(&FileInfo::m_filename, ro.ascending) },
-                                                { FieldOption::FILETYPE, cmp(&FileInfo::m_type, ro.ascending) },
-                                                { FieldOption::SLOC, cmp(&FileInfo::n_loc, ro.ascending) },
-                                                { FieldOption::COMMENTS, cmp(&FileInfo::n_reg_comments, ro.ascending) },
-                                                { FieldOption::DOC_COMENTS, cmp(&FileInfo::n_doc_comments, ro.ascending) },
-                                                { FieldOption::BLANK_LINES, cmp(&FileInfo::n_blank_lines, ro.ascending) },
-                                                { FieldOption::ALL, cmp(&FileInfo::n_lines, ro.ascending) } };
+    switch (option)
+    {
+    case FieldOption::FILENAME:
+      sort_files(files, ro.ascending, [](const FileInfo& f) -> const str& { return f.m_filename; });
+      break;
+    case FieldOption::FILETYPE:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return f.m_type; });
+      break;
+    case FieldOption::SLOC:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return f.n_loc; });
+      break;
+    case FieldOption::COMMENTS:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return f.n_reg_comments; });
+      break;
+    case FieldOption::DOC_COMENTS:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return f.n_doc_comments; });
+      break;
+    case FieldOption::BLANK_LINES:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return f.n_blank_lines; });
+      break;
+    case FieldOption::ALL:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return f.n_lines; });
+      break;
+    case FieldOption::COMMENT_DENSITY:
+      sort_files(files, ro.ascending, [](const FileInfo& f) { return density_key(ResultStore::counts_of(f)); });
+      break;
+    default:
+      break;
+    }
+  }
+
+  /**
+   * @brief  Retorna a ordem de exibição das linhas de @a results, ordenadas pelas chaves @a keys.
+   *
+   * @details As linhas não são movidas: só um vetor de índices de 32 bits é ordenado. A primeira chave é a principal;
+   *  as seguintes só desempatam. A ordenação é estável: linhas empatadas em todas as chaves mantêm a ordem de
+   *  descoberta.
+   *   - Ordem completa: uma ordenação estável por chave, da última chave para a principal (LSD), de modo que cada
+   *     uma preserva os desempates das anteriores. Chaves numéricas (contadores, tipo, densidade de comentários) usam
+   *     *radix sort* sobre o vetor de índices, um byte por passada; passadas em que todas as linhas têm o mesmo byte
+   *     são puladas, então contadores pequenos custam 1 ou 2 passadas. O nome do arquivo usa uma chave de prefixo e,
+   *     em conjuntos grandes, uma ordenação paralela.
+   *   - Com @a top menor que o número de linhas: seleção parcial (`std::partial_sort`) comparando todas as chaves de
+   *     uma vez, sem ordenar o resto.
+   *
+   * @param results  Resultados da análise.
+   * @param keys  Chaves de ordenação, da principal para a última (vazio: ordem de descoberta).
+   * @param ascending  Indica se a ordenação deve ser crescente (vale para todas as chaves).
+   * @param top  Se maior que zero, só as @a top primeiras linhas da ordem são devolvidas.
+   * @param n_threads  Threads disponíveis para ordenar por nome conjuntos grandes (ver `sort_by_filename`).
+   *
+   * @return vec<std::uint32_t>  Índices das linhas, na ordem de exibição.
+   */
+  static vec<std::uint32_t> order(const ResultStore& results, const vec<FieldOption>& keys, bool ascending, size_t top = 0,
+                                  size_t n_threads = 1)
+  {
+    vec<std::uint32_t> rows(results.size());
+    std::iota(rows.begin(), rows.end(), std::uint32_t{ 0 });
+
+    if (keys.empty())
+    {
+      if (top > 0 and top < rows.size())
+      {
+        rows.resize(top);
+      }
+      return rows;
+    }
 
-    if (sorting_compare.count(option))  //[!] verifica se o campo de ordenação é valido
+    if (top > 0 and top < rows.size())
     {
-      std::sort(files.begin(), files.end(), sorting_compare[option]);  // [!] Ordena os arquivos com base no campo de ordenação.
+      std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(top), rows.end(),
+                        [&](std::uint32_t a, std::uint32_t b) { return compare(results, keys, ascending, a, b) < 0; });
+      rows.resize(top);
+      return rows;
     }
+
+    // [!] LSD: ordena da chave menos importante para a principal; a estabilidade preserva os desempates.
+    for (auto key{ keys.rbegin() }; key != keys.rend(); ++key)
+    {
+      if (*key == FieldOption::FILENAME)
+      {
+        sort_by_filename(rows, results, ascending, n_threads);
+        continue;
+      }
+      radix_sort(rows, [&, field = *key](std::uint32_t row) {
+        const std::uint64_t value{ numeric_key(results, field, row) };
+        return ascending ? value : ~value;
+      });
+    }
+
+    return rows;
   }
 
 private:
   /**
-   * @brief Função de comparação para ordenar arquivos com base em um campo específico.
+   * @brief Ordena @a files, de forma estável, pela chave @a key_of.
+   */
+  template <typename KeyOf>
+  static void sort_files(vec<FileInfo>& files, bool ascending, KeyOf key_of)
+  {
+    std::stable_sort(files.begin(), files.end(), [&](const FileInfo& a, const FileInfo& b) {
+      return ascending ? key_of(a) < key_of(b) : key_of(b) < key_of(a);
+    });
+  }
+
+  /**
+   * @brief Chave da densidade de comentários: a fração (comentários regulares e de documentação) / linhas.
+   *
+   * @details Um `double` não negativo tem a mesma ordem que seus bits lidos como inteiro sem sinal, então a chave
+   *  serve tanto para comparar quanto para o *radix sort*.
+   */
+  static std::uint64_t density_key(const ResultStore::Counts& counts)
+  {
+    const double density{ counts.n_lines == 0 ? 0.0
+                                              : static_cast<double>(counts.n_reg_comments + counts.n_doc_comments)
+                                                  / static_cast<double>(counts.n_lines) };
+    std::uint64_t bits{ 0 };
+    std::memcpy(&bits, &density, sizeof(bits));
+    return bits;
+  }
+
+  /**
+   * @brief Retorna a chave numérica de @a field na linha @a row (crescente).
+   */
+  static std::uint64_t numeric_key(const ResultStore& results, FieldOption field, std::uint32_t row)
+  {
+    switch (field)
+    {
+    case FieldOption::FILETYPE:
+      return static_cast<std::uint64_t>(results.type(row));
+    case FieldOption::SLOC:
+      return counter_key(results, ResultStore::Counter::LOC, row);
+    case FieldOption::COMMENTS:
+      return counter_key(results, ResultStore::Counter::REG_COMMENTS, row);
+    case FieldOption::DOC_COMENTS:
+      return counter_key(results, ResultStore::Counter::DOC_COMMENTS, row);
+    case FieldOption::BLANK_LINES:
+      return counter_key(results, ResultStore::Counter::BLANK_LINES, row);
+    case FieldOption::ALL:
+      return counter_key(results, ResultStore::Counter::LINES, row);
+    case FieldOption::COMMENT_DENSITY:
+      return density_key(results.counts(row));
+    default:
+      return 0;
+    }
+  }
+
+  /**
+   * @brief Lê um contador direto da coluna de 32 bits (e o valor inteiro só quando ela marca um contador largo).
+   */
+  static std::uint64_t counter_key(const ResultStore& results, ResultStore::Counter counter, std::uint32_t row)
+  {
+    const std::uint32_t value{ results.column(counter)[row] };
+    return value != ResultStore::wide_mark() ? value : results.count(row, counter);
+  }
+
+  /**
+   * @brief Compara as linhas @a a e @a b por todas as chaves (empates pela ordem de descoberta).
+   *
+   * @return int  Negativo se @a a vem antes, positivo se vem depois (nunca zero para linhas diferentes).
+   */
+  static int compare(const ResultStore& results, const vec<FieldOption>& keys, bool ascending, std::uint32_t a, std::uint32_t b)
+  {
+    for (const FieldOption key : keys)
+    {
+      int cmp{ 0 };
+      if (key == FieldOption::FILENAME)
+      {
+        cmp = results.path(a).compare(results.path(b));
+      }
+      else
+      {
+        const std::uint64_t key_a{ numeric_key(results, key, a) };
+        const std::uint64_t key_b{ numeric_key(results, key, b) };
+        cmp = key_a < key_b ? -1 : (key_a > key_b ? 1 : 0);
+      }
+      if (cmp != 0)
+      {
+        return ascending ? cmp : -cmp;
+      }
+    }
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+
+  /**
+   * @brief Chave de ordenação por nome: os 8 bytes do caminho logo após o prefixo comum, e o resto do caminho.
+   */
+  struct FilenameKey
+  {
+    std::uint64_t prefix{ 0 };     //!< 8 bytes após o prefixo comum, *big-endian* (completados com zeros).
+    const char* rest{ nullptr };   //!< Restante do caminho, depois desses 8 bytes.
+    std::uint32_t rest_size{ 0 };  //!< Tamanho do restante.
+    std::uint32_t position{ 0 };   //!< Posição atual da linha (desempate, para manter a ordenação estável).
+  };
+
+  /**
+   * @brief Compara duas chaves de nome (ordem total: nunca há empate entre posições diferentes).
+   */
+  static bool filename_before(const FilenameKey& a, const FilenameKey& b, bool ascending)
+  {
+    if (a.prefix != b.prefix)
+    {
+      return ascending ? a.prefix < b.prefix : a.prefix > b.prefix;
+    }
+    const int cmp{ str_view{ a.rest, a.rest_size }.compare(str_view{ b.rest, b.rest_size }) };
+    if (cmp != 0)
+    {
+      return ascending ? cmp < 0 : cmp > 0;
+    }
+    return a.position < b.position;
+  }
+
+  /**
+   * @brief Ordena @a rows, de forma estável, pelo caminho de cada linha.
    *
-   * @details Esta função é um método estático que retorna uma função de comparação
-   *  apropriada para ordenar arquivos com base em um campo específico. O campo é
-   *  passado como um ponteiro para membro da estrutura `FileInfo`. A função de
-   *  comparação retornada compara dois objetos `FileInfo` com base no campo
-   *  especificado e na ordem de classificação (crescente ou decrescente).
+   * @details Os caminhos costumam compartilhar um prefixo longo (a raiz informada pelo usuário), o que torna cada
+   *  comparação de strings cara. O prefixo comum a todas as linhas é descontado, e os 8 bytes seguintes de cada
+   *  caminho viram um inteiro *big-endian*: a maioria das comparações se resolve com uma única comparação de inteiros,
+   *  sem tocar na arena. Empates são desfeitos pela posição atual, o que torna a ordenação estável.
    *
-   * @param field  Campo a ser comparado. É um ponteiro para membro da estrutura
-   *  `FileInfo` que representa o campo a ser usado na comparação.
+   *  Acima de `PARALLEL_SORT_MIN_ROWS` linhas e com mais de uma thread, a ordenação é paralela (`parallel_sort`).
+   */
+  static void sort_by_filename(vec<std::uint32_t>& rows, const ResultStore& results, bool ascending, size_t n_threads)
+  {
+    if (rows.size() < 2)
+    {
+      return;
+    }
+
+    // [!] Prefixo comum a todos os caminhos (diminui rapidamente: o custo é quase sempre linear no número de linhas).
+    const str_view first{ results.path(rows[0]) };
+    size_t common{ first.size() };
+    for (const std::uint32_t row : rows)
+    {
+      const str_view path{ results.path(row) };
+      common = std::min(common, path.size());
+      common = static_cast<size_t>(std::mismatch(first.begin(), first.begin() + static_cast<std::ptrdiff_t>(common), path.begin()).first
+                                   - first.begin());
+    }
+
+    vec<FilenameKey> keys(rows.size());
+    for (size_t i{ 0 }; i < rows.size(); ++i)
+    {
+      const str_view path{ results.path(rows[i]).substr(common) };
+      std::uint64_t prefix{ 0 };
+      for (size_t byte_index{ 0 }; byte_index < 8; ++byte_index)
+      {
+        prefix = prefix << 8 | (byte_index < path.size() ? static_cast<byte>(path[byte_index]) : 0);
+      }
+      const str_view rest{ path.size() > 8 ? path.substr(8) : str_view{} };
+      keys[i] = { prefix, rest.data(), static_cast<std::uint32_t>(rest.size()), static_cast<std::uint32_t>(i) };
+    }
+
+    const auto before{ [ascending](const FilenameKey& a, const FilenameKey& b) { return filename_before(a, b, ascending); } };
+    if (n_threads > 1 and keys.size() >= PARALLEL_SORT_MIN_ROWS)
+    {
+      parallel_sort(keys, before, n_threads);
+    }
+    else
+    {
+      std::sort(keys.begin(), keys.end(), before);
+    }
+
+    vec<std::uint32_t> sorted(rows.size());
+    for (size_t i{ 0 }; i < rows.size(); ++i)
+    {
+      sorted[i] = rows[keys[i].position];
+    }
+    rows.swap(sorted);
+  }
+
+  /**
+   * @brief Ordena @a items em paralelo: cada thread ordena um trecho contíguo (uma *run*), e as runs são intercaladas
+   *  por uma intercalação de k vias.
    *
-   * @param ascending  Indica se a ordenação deve ser crescente (`true`) ou
-   *  decrescente (`false`).
+   * @details @a before deve ser uma ordem total (sem empates entre itens diferentes), então o resultado é o mesmo de um
+   *  `std::sort`. A intercalação usa um *heap* com a cabeça de cada run: O(n log k) comparações, numa única passada
+   *  sequencial pela memória de cada run.
+   */
+  template <typename Type, typename Before>
+  static void parallel_sort(vec<Type>& items, Before before, size_t n_threads)
+  {
+    const size_t n_runs{ std::min(n_threads, items.size()) };
+    vec<size_t> bounds(n_runs + 1);
+    for (size_t r{ 0 }; r <= n_runs; ++r)
+    {
+      bounds[r] = items.size() * r / n_runs;
+    }
+
+    // [!] 1. Runs ordenadas em paralelo (a thread chamadora ordena a última).
+    vec<std::thread> threads{};
+    threads.reserve(n_runs - 1);
+    for (size_t r{ 0 }; r + 1 < n_runs; ++r)
+    {
+      threads.emplace_back([&, r] {
+        std::sort(items.begin() + static_cast<std::ptrdiff_t>(bounds[r]), items.begin() + static_cast<std::ptrdiff_t>(bounds[r + 1]),
+                  before);
+      });
+    }
+    std::sort(items.begin() + static_cast<std::ptrdiff_t>(bounds[n_runs - 1]), items.end(), before);
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    // [!] 2. Intercalação de k vias: o *heap* guarda a posição da cabeça de cada run, com a menor no topo.
+    vec<size_t> heads(bounds.begin(), bounds.end() - 1);
+    const auto later{ [&](size_t a, size_t b) { return before(items[heads[b]], items[heads[a]]); } };
+    vec<size_t> heap(n_runs);
+    std::iota(heap.begin(), heap.end(), size_t{ 0 });
+    std::make_heap(heap.begin(), heap.end(), later);
+
+    vec<Type> merged{};
+    merged.reserve(items.size());
+    while (not heap.empty())
+    {
+      std::pop_heap(heap.begin(), heap.end(), later);
+      const size_t run{ heap.back() };
+      merged.push_back(items[heads[run]]);
+      if (++heads[run] < bounds[run + 1])
+      {
+        std::push_heap(heap.begin(), heap.end(), later);
+      }
+      else
+      {
+        heap.pop_back();
+      }
+    }
+    items.swap(merged);
+  }
+
+  /**
+   * @brief *Radix sort* LSD estável de @a rows pela chave de 64 bits @a key_of, um byte por passada.
    *
-   * @return func retorna uma função de comparação que pode ser usada para ordenar arquivos
-   *  com base no campo especificado e na ordem de classificação.
+   * @details As chaves são calculadas uma vez e andam junto com os índices. Os histogramas dos 8 bytes são montados
+   *  numa única leitura das chaves; um byte igual em todas as linhas não precisa de passada.
    */
-  template <typename Type>  //[!] template para permitir a comparação de diferentes tipos de campos.
-  static func cmp(Type FileInfo::*field, bool ascending)
+  template <typename KeyOf>
+  static void radix_sort(vec<std::uint32_t>& rows, KeyOf key_of)
   {
-    // [!] Retorna uma função de comparação que compara dois objetos FileInfo com base no campo especificado.
-    return [=](const FileInfo& a, const FileInfo& b) { return ascending ? a.*field < b.*field : a.*field > b.*field; };
+    const size_t n{ rows.size() };
+    if (n < 2)
+    {
+      return;
+    }
+
+    vec<std::uint64_t> keys(n);
+    std::array<std::array<size_t, 256>, 8> histograms{};
+    for (size_t i{ 0 }; i < n; ++i)
+    {
+      keys[i] = key_of(rows[i]);
+      for (size_t digit{ 0 }; digit < 8; ++digit)
+      {
+        ++histograms[digit][(keys[i] >> (8 * digit)) & 0xFF];
+      }
+    }
+
+    vec<std::uint64_t> keys_out(n);
+    vec<std::uint32_t> rows_out(n);
+    for (size_t digit{ 0 }; digit < 8; ++digit)
+    {
+      const unsigned shift{ static_cast<unsigned>(8 * digit) };
+      auto& histogram{ histograms[digit] };
+      if (histogram[(keys[0] >> shift) & 0xFF] == n)
+      {
+        continue;  // [!] Todas as linhas têm o mesmo byte: a passada não mudaria nada.
+      }
+
+      size_t offset{ 0 };
+      for (auto& bucket : histogram)
+      {
+        const size_t count{ bucket };
+        bucket = offset;
+        offset += count;
+      }
+      for (size_t i{ 0 }; i < n; ++i)
+      {
+        const size_t position{ histogram[(keys[i] >> shift) & 0xFF]++ };
+        keys_out[position] = keys[i];
+        rows_out[position] = rows[i];
+      }
+      keys.swap(keys_out);
+      rows.swap(rows_out);
+    }
   }
 };
 
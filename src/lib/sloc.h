@@ -0,0 +1,163 @@
+/**
+ * @file sloc.h
+ *
+ * @brief ABI em C da `libsloc`: conta as linhas de arquivos C/C++ dentro do processo, sem executar o `sloc`.
+ *
+ * @details Uso:
+ * @code
+ *   sloc_options options;
+ *   sloc_options_init(&options);
+ *   options.recursive = 1;
+ *
+ *   const char* paths[] = { "src", "include" };
+ *   sloc_results* results = NULL;
+ *   if (sloc_analyze(paths, 2, &options, &results) == SLOC_OK)
+ *   {
+ *     for (size_t i = 0; i < results->n_files; ++i)
+ *       printf("%s %llu\n", results->files[i].path, (unsigned long long)results->files[i].counts.code);
+ *     sloc_results_free(results);
+ *   }
+ * @endcode
+ *
+ * Estabilidade: funções e campos só são acrescentados, nunca mudam nem são removidos, dentro da mesma
+ * `SLOC_ABI_VERSION`. `sloc_options` começa pelo próprio tamanho (preenchido por `sloc_options_init`), então um
+ * programa compilado com um cabeçalho mais antigo continua funcionando com uma biblioteca mais nova.
+ *
+ * As funções podem ser chamadas de várias threads ao mesmo tempo; cada `sloc_results` pertence a quem o recebeu.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef SLOC_H
+#define SLOC_H
+
+#include <stddef.h> /* `size_t` */
+#include <stdint.h> /* `uint32_t`, `uint64_t` */
+
+#if defined(_WIN32)
+# define SLOC_API
+#else
+# define SLOC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @brief Versão da ABI descrita por este cabeçalho. */
+#define SLOC_ABI_VERSION 1
+
+/** @brief Resultado de uma chamada. */
+typedef enum sloc_status
+{
+  SLOC_OK = 0,                    /**< Sucesso. */
+  SLOC_ERROR_INVALID_ARGUMENT = 1, /**< Ponteiro nulo, caminho `"-"`, opção desconhecida ou chave de ordenação inválida. */
+  SLOC_ERROR_OUT_OF_MEMORY = 2,    /**< Memória insuficiente. */
+  SLOC_ERROR_INTERNAL = 3          /**< Falha inesperada. */
+} sloc_status;
+
+/** @brief Linguagem de um arquivo (pela extensão). */
+typedef enum sloc_language
+{
+  SLOC_LANGUAGE_C = 0,          /**< `.c` */
+  SLOC_LANGUAGE_C_HEADER = 1,   /**< `.h` */
+  SLOC_LANGUAGE_CPP = 2,        /**< `.cpp`, `.cc`, `.cxx`... */
+  SLOC_LANGUAGE_CPP_HEADER = 3  /**< `.hpp`, `.hh`, `.hxx`... */
+} sloc_language;
+
+/** @brief Motor de análise de linhas (todos produzem as mesmas contagens). */
+typedef enum sloc_engine
+{
+  SLOC_ENGINE_DFA = 0,    /**< Autômato dirigido por tabelas (padrão). */
+  SLOC_ENGINE_SIMD = 1,   /**< Busca vetorizada pelos bytes especiais. */
+  SLOC_ENGINE_SCALAR = 2  /**< Um caractere por vez. */
+} sloc_engine;
+
+/**
+ * @brief Recebe um aviso sobre as entradas de `sloc_analyze` (inexistente, sem arquivos suportados...), sem o `\n`
+ * final. @a message só é válida durante a chamada.
+ */
+typedef void (*sloc_note_fn)(const char* message, void* data);
+
+/** @brief Opções de `sloc_analyze`. Inicialize sempre com `sloc_options_init`. */
+typedef struct sloc_options
+{
+  uint32_t size;        /**< `sizeof(sloc_options)` de quem compilou a chamada (preenchido por `sloc_options_init`). */
+  int32_t recursive;    /**< Diferente de zero: entra nos subdiretórios (`-r`). */
+  uint32_t n_workers;   /**< Threads da análise; 0 usa um por núcleo. */
+  int32_t engine;       /**< Um `sloc_engine`. */
+  int32_t git;          /**< Diferente de zero: lista os diretórios pelo índice do git (`--git`). */
+  int32_t ascending;    /**< Diferente de zero: ordem crescente em `sort` (`-s`); senão, decrescente (`-S`). */
+  const char* sort;     /**< Chaves de ordenação como em `-s` (ex.: "s,c"), ou `NULL` para a ordem de descoberta. */
+  sloc_note_fn notes;   /**< Recebe os avisos sobre as entradas, um por chamada; `NULL` (padrão) os descarta. */
+  void* notes_data;     /**< Repassado a `notes`. */
+} sloc_options;
+
+/** @brief Contadores de um arquivo (ou da soma). */
+typedef struct sloc_counts
+{
+  uint64_t comments;      /**< Linhas de comentário regular. */
+  uint64_t doc_comments;  /**< Linhas de comentário de documentação. */
+  uint64_t blank;         /**< Linhas em branco. */
+  uint64_t code;          /**< Linhas de código. */
+  uint64_t lines;         /**< Total de linhas. */
+} sloc_counts;
+
+/** @brief Resultado de um arquivo. */
+typedef struct sloc_file
+{
+  const char* path;    /**< Caminho, como descoberto (válido até `sloc_results_free`). */
+  int32_t language;    /**< Um `sloc_language`. */
+  sloc_counts counts;  /**< Contadores do arquivo. */
+} sloc_file;
+
+/** @brief Resultados de `sloc_analyze`, num único bloco de memória. */
+typedef struct sloc_results
+{
+  size_t n_files;          /**< Quantidade de arquivos em `files`. */
+  const sloc_file* files;  /**< Arquivos, na ordem pedida em `sloc_options::sort`. */
+  sloc_counts sum;         /**< Soma de todos os arquivos. */
+} sloc_results;
+
+/** @brief Retorna a `SLOC_ABI_VERSION` com que a biblioteca foi compilada. */
+SLOC_API uint32_t sloc_abi_version(void);
+
+/**
+ * @brief Preenche @a options com os valores padrão (sem recursão, um worker por núcleo, motor DFA, sem ordenação, sem
+ * avisos).
+ */
+SLOC_API void sloc_options_init(sloc_options* options);
+
+/**
+ * @brief Descobre e analisa os arquivos de @a paths (arquivos ou diretórios, como na linha de comando).
+ *
+ * @details A biblioteca nunca lê a entrada padrão nem escreve na saída padrão do processo: `"-"` não é aceito como
+ * caminho, e os avisos só chegam a quem pediu, por `sloc_options::notes`.
+ *
+ * @param paths    Vetor com @a n_paths caminhos.
+ * @param options  Opções (ou `NULL` para as padrão).
+ * @param results  Recebe os resultados, que devem ser liberados com `sloc_results_free`; fica `NULL` em caso de erro.
+ *
+ * @return `SLOC_OK` ou o motivo da falha. Entradas inexistentes não são erro: só não contribuem com arquivos.
+ */
+SLOC_API sloc_status sloc_analyze(const char* const* paths, size_t n_paths, const sloc_options* options,
+                                  sloc_results** results);
+
+/** @brief Libera os resultados de `sloc_analyze` (aceita `NULL`). */
+SLOC_API void sloc_results_free(sloc_results* results);
+
+/** @brief Retorna uma descrição, em inglês, de @a status. */
+SLOC_API const char* sloc_status_string(sloc_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLOC_H */
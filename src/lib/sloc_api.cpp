@@ -0,0 +1,244 @@
+/**
+ * @file sloc_api.cpp
+ *
+ * @brief Implementa a ABI em C da `libsloc` (`sloc.h`) sobre o `Filter`, o `WorkerPool`, o `ResultStore` e o `Sort`.
+ *
+ * @author José Carlos da Paz Silva (carlos.paz.707@ufrn.edu.br)
+ * @author Leandro Andrade (leandro.andrade.401@ufrn.edu.br)
+ *
+ * @version 0.1
+ * @date 2025-06-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <algorithm>  // `std::min`
+#include <cstddef>    // `offsetof`, `std::max_align_t`
+#include <cstdlib>    // `std::malloc`, `std::free`
+#include <cstring>    // `std::memcpy`
+#include <new>        // `std::bad_alloc`
+#include <ostream>    // `std::ostream`
+#include <streambuf>  // `std::streambuf`
+
+#include "../common/aliases.hpp"
+#include "../common/constants.hpp"
+#include "../core/filter/field_option.hpp"
+#include "../core/filter/filter.hpp"
+#include "../core/parallel/worker_pool.hpp"
+#include "../core/sloc/result_store.hpp"
+#include "../core/sort/sort.hpp"
+#include "sloc.h"
+
+namespace
+{
+/**
+ * @brief Converte as chaves de @a keys (a sintaxe de `-s`: letras separadas por vírgulas) em @a fields.
+ *
+ * @return bool  `false` se alguma chave for desconhecida.
+ */
+bool parse_sort_keys(str_view keys, vec<FieldOption>& fields)
+{
+  while (not keys.empty())
+  {
+    const size_t comma{ keys.find(',') };
+    const str_view key{ keys.substr(0, comma) };
+    if (key.size() != 1)
+    {
+      return false;
+    }
+    switch (key.front())
+    {
+    case 'f': fields.push_back(FieldOption::FILENAME); break;
+    case 't': fields.push_back(FieldOption::FILETYPE); break;
+    case 'c': fields.push_back(FieldOption::COMMENTS); break;
+    case 'd': fields.push_back(FieldOption::DOC_COMENTS); break;
+    case 'b': fields.push_back(FieldOption::BLANK_LINES); break;
+    case 's': fields.push_back(FieldOption::SLOC); break;
+    case 'a': fields.push_back(FieldOption::ALL); break;
+    case 'r': fields.push_back(FieldOption::COMMENT_DENSITY); break;
+    default: return false;
+    }
+    keys = comma == str_view::npos ? str_view{} : keys.substr(comma + 1);
+  }
+  return true;
+}
+
+/**
+ * @brief Repassa cada linha escrita no `std::ostream` de avisos do `Filter` para o `sloc_note_fn` de quem chamou.
+ */
+class NoteSink : public std::streambuf
+{
+  sloc_note_fn m_notes;  //!< Função de quem chamou.
+  void* m_data;          //!< Repassado a `m_notes`.
+  str m_line{};          //!< Linha em montagem.
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+      return traits_type::not_eof(ch);
+    }
+    if (traits_type::to_char_type(ch) != '\n')
+    {
+      m_line.push_back(traits_type::to_char_type(ch));
+    }
+    else
+    {
+      m_notes(m_line.c_str(), m_data);
+      m_line.clear();
+    }
+    return ch;
+  }
+
+public:
+  NoteSink(sloc_note_fn notes, void* data) : m_notes{ notes }, m_data{ data } {}
+};
+
+/// @brief Converte os contadores do `ResultStore` para a struct da ABI.
+sloc_counts to_counts(const ResultStore::Counts& counts)
+{
+  return sloc_counts{ counts.n_reg_comments, counts.n_doc_comments, counts.n_blank_lines, counts.n_loc, counts.n_lines };
+}
+
+/**
+ * @brief Copia os resultados para um único bloco de `malloc`: o `sloc_results`, o vetor de `sloc_file` e os caminhos
+ * (terminados em `\0`), nessa ordem. Um único `free` libera tudo.
+ */
+sloc_results* pack(const ResultStore& results, const vec<std::uint32_t>& order)
+{
+  constexpr size_t ALIGN{ alignof(std::max_align_t) };
+  const size_t files_offset{ (sizeof(sloc_results) + ALIGN - 1) / ALIGN * ALIGN };
+  const size_t paths_offset{ files_offset + order.size() * sizeof(sloc_file) };
+  size_t paths_size{ 0 };
+  for (const std::uint32_t row : order)
+  {
+    paths_size += results.path(row).size() + 1;
+  }
+
+  auto* block{ static_cast<char*>(std::malloc(paths_offset + paths_size)) };
+  if (block == nullptr)
+  {
+    throw std::bad_alloc{};
+  }
+
+  auto* files{ reinterpret_cast<sloc_file*>(block + files_offset) };
+  char* path{ block + paths_offset };
+  for (size_t i{ 0 }; i < order.size(); ++i)
+  {
+    const str_view row_path{ results.path(order[i]) };
+    std::memcpy(path, row_path.data(), row_path.size());
+    path[row_path.size()] = '\0';
+    files[i] = sloc_file{ path, static_cast<std::int32_t>(results.type(order[i])), to_counts(results.counts(order[i])) };
+    path += row_path.size() + 1;
+  }
+
+  auto* header{ reinterpret_cast<sloc_results*>(block) };
+  *header = sloc_results{ order.size(), files, to_counts(results.total()) };
+  return header;
+}
+}  // namespace
+
+extern "C"
+{
+SLOC_API uint32_t sloc_abi_version(void) { return SLOC_ABI_VERSION; }
+
+SLOC_API void sloc_options_init(sloc_options* options)
+{
+  if (options != nullptr)
+  {
+    *options = sloc_options{};
+    options->size = sizeof(sloc_options);
+    options->engine = SLOC_ENGINE_DFA;
+  }
+}
+
+SLOC_API sloc_status sloc_analyze(const char* const* paths, size_t n_paths, const sloc_options* options, sloc_results** results)
+{
+  if (results == nullptr or (paths == nullptr and n_paths > 0))
+  {
+    return SLOC_ERROR_INVALID_ARGUMENT;
+  }
+  *results = nullptr;
+
+  sloc_options defaults{};
+  sloc_options_init(&defaults);
+  if (options != nullptr)
+  {
+    // [!] Só os campos que o cabeçalho de quem chamou conhecia são lidos; os demais ficam com os valores padrão.
+    if (options->size < offsetof(sloc_options, recursive) + sizeof(sloc_options::recursive))
+    {
+      return SLOC_ERROR_INVALID_ARGUMENT;
+    }
+    std::memcpy(&defaults, options, std::min<size_t>(options->size, sizeof(sloc_options)));
+  }
+  const sloc_options& chosen{ defaults };
+
+  try
+  {
+    vec<str> inputs{};
+    for (size_t p{ 0 }; p < n_paths; ++p)
+    {
+      // [!] `-` seria a entrada padrão de quem chamou, que a biblioteca não deve bloquear lendo.
+      if (paths[p] == nullptr or paths[p] == STDIN_SOURCE)
+      {
+        return SLOC_ERROR_INVALID_ARGUMENT;
+      }
+      inputs.emplace_back(paths[p]);
+    }
+
+    ScanEngine engine{ ScanEngine::DFA };
+    switch (chosen.engine)
+    {
+    case SLOC_ENGINE_DFA: engine = ScanEngine::DFA; break;
+    case SLOC_ENGINE_SIMD: engine = ScanEngine::SIMD; break;
+    case SLOC_ENGINE_SCALAR: engine = ScanEngine::SCALAR; break;
+    default: return SLOC_ERROR_INVALID_ARGUMENT;
+    }
+
+    vec<FieldOption> sort_fields{};
+    if (chosen.sort != nullptr and not parse_sort_keys(chosen.sort, sort_fields))
+    {
+      return SLOC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // [!] Sem `notes`, os avisos são descartados (um `std::ostream` sem buffer ignora o que recebe).
+    NoteSink sink{ chosen.notes, chosen.notes_data };
+    std::ostream notes{ chosen.notes != nullptr ? &sink : nullptr };
+
+    const size_t n_workers{ chosen.n_workers == 0 ? WorkerPool::default_workers() : size_t{ chosen.n_workers } };
+    vec<FileInfo> files{ Filter::filter(inputs, chosen.recursive != 0, LangType::CPP, n_workers, chosen.git != 0, notes) };
+    if (not files.empty())
+    {
+      WorkerPool::analyze(files, n_workers, engine, InputMode::MAPPED, SPLIT_MIN_SIZE);
+    }
+
+    ResultStore store{};
+    store.append(files);
+    *results = pack(store, Sort::order(store, sort_fields, chosen.ascending != 0, 0, n_workers));
+    return SLOC_OK;
+  }
+  catch (const std::bad_alloc&)
+  {
+    return SLOC_ERROR_OUT_OF_MEMORY;
+  }
+  catch (...)
+  {
+    return SLOC_ERROR_INTERNAL;  // [!] Nenhuma exceção atravessa a fronteira da ABI em C.
+  }
+}
+
+SLOC_API void sloc_results_free(sloc_results* results) { std::free(results); }
+
+SLOC_API const char* sloc_status_string(sloc_status status)
+{
+  switch (status)
+  {
+  case SLOC_OK: return "success";
+  case SLOC_ERROR_INVALID_ARGUMENT: return "invalid argument";
+  case SLOC_ERROR_OUT_OF_MEMORY: return "out of memory";
+  case SLOC_ERROR_INTERNAL: return "internal error";
+  }
+  return "unknown status";
+}
+}